@@ -106,6 +106,7 @@
 #define configUSE_MUTEXES			1
 #define configQUEUE_REGISTRY_SIZE		8
 #define configCHECK_FOR_STACK_OVERFLOW	        2
+#define configRECORD_STACK_HIGH_ADDRESS	        1 /* Lets the DFM crash dump capture the used part of the task stack */
 #define configUSE_RECURSIVE_MUTEXES		1
 #define configUSE_MALLOC_FAILED_HOOK	        1
 #define configUSE_APPLICATION_TASK_TAG	        0
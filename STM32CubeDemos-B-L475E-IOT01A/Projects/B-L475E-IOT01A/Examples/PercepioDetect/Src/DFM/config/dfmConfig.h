@@ -72,6 +72,14 @@ extern void vMainUARTPrintString( char * pcString );
 extern void vDfmCloudPortFlushWithDummyData(void);
 #define DFM_CFG_AFTER_ALERT_SEND(pxAlert) vDfmCloudPortFlushWithDummyData();
 
+/**
+ * @brief Called when an alert has been sent with all its payloads, both when sent directly
+ * and when sent from storage by xDfmAlertSendAll(). Lets the CrashCatcher integration know
+ * that a crash dump has been delivered, see DFM_CFG_CRASH_SEEN_TABLE_SIZE. Remove if not used.
+ */
+extern void vDfmCrashCatcherAlertDelivered(const char* szSessionId, uint32_t ulAlertId);
+#define DFM_CFG_AFTER_ALERT_DELIVERED(szSessionId, ulAlertId) vDfmCrashCatcherAlertDelivered(szSessionId, ulAlertId)
+
 /**
  * @brief The maximum size of a "chunk" that will be stored or sent.
  * If a DFM payload (core dump, trace, etc) is larger than the chunk size, it will be divided into multiple
@@ -116,6 +124,27 @@ extern void vDfmCloudPortFlushWithDummyData(void);
  */
 #define DFM_CFG_RETAINED_MEMORY 0
 
+/**
+ * @brief The number of alerts that can be pending in Retained Memory, each in a record of
+ * DFM_CFG_RETAINED_MEMORY_RECORD_SIZE bytes (a multiple of 4). Payload chunks that don't fit
+ * in the record of their alert are skipped.
+ */
+#define DFM_CFG_RETAINED_MEMORY_RECORDS (4)
+#define DFM_CFG_RETAINED_MEMORY_RECORD_SIZE (2048)
+
+/**
+ * @brief The strategy used when all Retained Memory records are pending. Possible values are:
+ *	DFM_RETAINED_MEMORY_STRATEGY_OVERWRITE	Overwrite the oldest alert
+ *	DFM_RETAINED_MEMORY_STRATEGY_SKIP		Skip the new alert, keeps the first alerts of a crash loop
+ *	DFM_RETAINED_MEMORY_STRATEGY_PRIORITY	Overwrite the oldest alert with lower DFM_CFG_RETAINED_MEMORY_PRIORITY, otherwise skip
+ */
+#define DFM_CFG_RETAINED_MEMORY_STRATEGY DFM_RETAINED_MEMORY_STRATEGY_OVERWRITE
+
+/**
+ * @brief The priority of an alert type for DFM_RETAINED_MEMORY_STRATEGY_PRIORITY, higher is more important.
+ */
+#define DFM_CFG_RETAINED_MEMORY_PRIORITY(ulAlertType) (0)
+
 /**
  * @brief The strategy used for storing alerts/payload. Possible values are:
  *	DFM_STORAGE_STRATEGY_IGNORE			Never store alerts/payloads
@@ -147,6 +176,47 @@ extern void vDfmCloudPortFlushWithDummyData(void);
 
 #define DFM_CFG_ENABLE_TASK_MONITOR 1
 
+/**
+ * @brief The number of alert signatures tracked by the alert rate limiter, 0 disables it.
+ * The signature is a hash of the alert type and all symptoms (ids and values), so alerts
+ * that only differ in description or payloads are considered repeats. When all slots are
+ * in use, the least recently seen signature is replaced. Its unreported suppressed count
+ * is then added to the next emitted alert, whatever its signature.
+ */
+#define DFM_CFG_ALERT_RATE_LIMIT_SLOTS 8
+
+/**
+ * @brief The number of alerts with the same signature that can be emitted back-to-back,
+ * given per alert type. A repeated alert is dropped when its signature has no tokens left.
+ * 0 means that alerts of this type are never rate limited.
+ */
+#define DFM_CFG_ALERT_RATE_LIMIT_BURST(ulAlertType) (3)
+
+/**
+ * @brief The time it takes to get back one token for a signature, in milliseconds.
+ */
+#define DFM_CFG_ALERT_RATE_LIMIT_PERIOD_MS (60000)
+
+/**
+ * @brief The time source for the rate limiter, in milliseconds. Must be callable from
+ * the contexts where alerts are created, including the fault handlers.
+ */
+extern uint32_t HAL_GetTick(void);
+#define DFM_CFG_ALERT_RATE_LIMIT_GET_TIME_MS() HAL_GetTick()
+
+/**
+ * @brief The number of dropped repeats since the previous emitted alert with the same
+ * signature is added to that alert as this symptom. Remove to not report the count.
+ */
+#define DFM_SYMPTOM_SUPPRESSED_ALERTS (14) /* Suppressed Repeats */
+
+/**
+ * @brief The number of dropped repeats of signatures that were evicted from the rate limiter
+ * since the previous emitted alert is added to the next alert, of any signature, as this symptom.
+ * Remove to not report the count.
+ */
+#define DFM_SYMPTOM_EVICTED_ALERTS (15) /* Suppressed Repeats Of Evicted Alerts */
+
 #ifdef __cplusplus
 }
 #endif
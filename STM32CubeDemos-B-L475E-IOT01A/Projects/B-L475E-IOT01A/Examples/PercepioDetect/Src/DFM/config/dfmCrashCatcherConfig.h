@@ -22,7 +22,13 @@ extern "C" {
 #include <stm32l4xx.h>
 
 /**
- * @brief How many bytes to dump from the stack (relative to current stack pointer).
+ * @brief How many bytes of the stack to include in the crash dump.
+ *
+ * If the fault happened on a task stack and the kernel port knows its bounds,
+ * the used part of the stack is dumped, from the stack pointer to the top of
+ * the stack. If that is larger than this, the first half of it is dumped
+ * followed by only the words that look like return addresses, which is enough
+ * for a backtrace. Otherwise this many bytes are dumped from the stack pointer.
  */
 #define DFM_CFG_STACKDUMP_SIZE 300
 
@@ -44,11 +50,66 @@ extern "C" {
  */
 #define DFM_CFG_ADDR_CHECK_NEXT 0x20018000
 
+/**
+ * @brief Start of the code memory (flash).
+ *
+ * Used with DFM_CFG_CODE_NEXT to recognize return addresses on the stack,
+ * see DFM_CFG_STACKDUMP_SIZE. The whole range must be readable.
+ */
+#define DFM_CFG_CODE_BEGIN 0x08000000
+
+/**
+ * @brief The first address after the code memory (flash).
+ */
+#define DFM_CFG_CODE_NEXT 0x08100000
+
 /**
  * @brief If this is set to 1 it will attempt to also save a trace with the Alert. This requires the Percepio Trace Recorder to also be included in the project.
  */
 #define DFM_CFG_CRASH_ADD_TRACE	(1)
 
+/**
+ * @brief If this is set to 1 the heap counters of the Percepio Trace Recorder are also saved with the Alert, as "heap_summary.bin". Requires DFM_CFG_CRASH_ADD_TRACE and TRC_CFG_HEAP_AGGREGATION.
+ */
+#define DFM_CFG_CRASH_ADD_HEAP_SUMMARY	(0)
+
+/**
+ * @brief If this is set to 1 the health metrics of the Percepio Trace Recorder (events written, dropped and overwritten, buffer high-water mark etc.) are also saved with the Alert, as "trace_health.bin". Requires DFM_CFG_CRASH_ADD_TRACE and TRC_CFG_ENABLE_HEALTH_METRICS.
+ */
+#define DFM_CFG_CRASH_ADD_TRACE_HEALTH	(0)
+
+/**
+ * @brief The number of crashes remembered across restarts, to not send the same crash dump again.
+ *
+ * Crashes are identified by a hash of the PC, LR and alert type. When the crash
+ * dump of a crash with the same hash has been delivered since power on, the
+ * alert is still sent but without the crash dump and trace. A dump counts as
+ * delivered once its alert has been sent, directly or later from storage, as
+ * reported by DFM_CFG_AFTER_ALERT_DELIVERED in dfmConfig.h. Until then, each
+ * repeat includes the full dump. The table is kept in the .noinit section,
+ * which must not be cleared on restart. Set to 0 to always send the crash dump.
+ */
+#define DFM_CFG_CRASH_SEEN_TABLE_SIZE	(8)
+
+/**
+ * @brief If this is set to 1 the current task and file name symptoms are FNV-1a hashes of the names.
+ *
+ * By default they are the sum of the characters, which gives the same value
+ * for e.g. "TaskA1" and "TaskB0". Changing this changes the symptom values, so
+ * the backend sees crashes that it has already seen as new ones.
+ */
+#define DFM_CFG_CRASH_HASH_NAMES	(0)
+
+/**
+ * @brief Symptoms added to crash alerts that aren't in dfmCodes.h.
+ *
+ * These must match Symptoms created in the backend. Remove a define to not add
+ * that Symptom. DFM_SYMPTOM_FAULT_ADDRESS is MMFAR or BFAR, when valid.
+ */
+#define DFM_SYMPTOM_HFSR (10) /* HFSR Register */
+#define DFM_SYMPTOM_FAULT_ADDRESS (11) /* Fault Address */
+#define DFM_SYMPTOM_CRASH_COUNT (13) /* Times seen since power on */
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,8 +19,18 @@
 static DfmResult_t prvDfmAlertInitialize(DfmAlertHandle_t xAlertHandle, uint8_t ucDfmVersion, uint32_t ulProduct, const char* szFirmwareVersion);
 static uint32_t prvDfmAlertCalculateChecksum(uint8_t* pxData, uint32_t ulSize);
 static void prvDfmAlertReset(DfmAlert_t* pxAlert);
+#ifdef DFM_CFG_AFTER_ALERT_DELIVERED
+static void prvDfmAlertDelivered(void);
+#endif
+static DfmResult_t prvDfmAlertAddPayload(DfmAlertHandle_t xAlertHandle, void* pvData, DfmPayloadReadCallback_t xReadCallback, uint32_t ulSize, const char* szDescription);
 static DfmResult_t prvDfmProcessAlert(DfmAlertEntryCallback_t xAlertCallback, DfmAlertEntryCallback_t xPayloadCallback);
-static DfmResult_t prvDfmGetAll(DfmAlertEntryCallback_t xAlertCallback, DfmAlertEntryCallback_t xPayloadCallback);
+static DfmResult_t prvDfmGetAll(DfmAlertEntryCallback_t xAlertCallback, DfmAlertEntryCallback_t xPayloadCallback, uint32_t ulSend);
+
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1)
+static uint32_t prvDfmAlertCalculateSignature(const DfmAlert_t* pxAlert);
+static DfmResult_t prvDfmAlertRateLimit(DfmAlert_t* pxAlert, uint32_t ulTime);
+static void prvDfmAlertRateLimitReported(void);
+#endif
 
 static DfmResult_t prvStoreAlert(DfmEntryHandle_t xEntryHandle);
 static DfmResult_t prvStorePayloadChunk(DfmEntryHandle_t xEntryHandle);
@@ -81,6 +91,17 @@ DfmResult_t xDfmAlertInitialize(DfmAlertData_t *pxBuffer)
 	pxDfmAlertData = pxBuffer;
 	
 	pxDfmAlertData->ulPayloadCount = 0;
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1)
+	for (uint32_t i = (uint32_t)0; i < (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_SLOTS); i++)
+	{
+		pxDfmAlertData->xRateLimitEntries[i].ulLastUsed = 0;
+	}
+	pxDfmAlertData->ulRateLimitSequence = 0;
+	pxDfmAlertData->ulRateLimitEvicted = 0;
+	pxDfmAlertData->pxRateLimitReported = (void*)0;
+	pxDfmAlertData->ulRateLimitReportedSuppressed = 0;
+	pxDfmAlertData->ulRateLimitReportedEvicted = 0;
+#endif
 	pxDfmAlertData->ulInitialized = 1;
 
 	return prvDfmAlertInitialize((DfmAlertHandle_t)&pxDfmAlertData->xAlert, DFM_VERSION, DFM_CFG_PRODUCTID, DFM_CFG_FIRMWARE_VERSION);
@@ -314,6 +335,26 @@ DfmResult_t xDfmAlertGetSymptom(DfmAlertHandle_t xAlertHandle, uint32_t ulIndex,
 }
 
 DfmResult_t xDfmAlertAddPayload(DfmAlertHandle_t xAlertHandle, void* pvData, uint32_t ulSize, const char* szDescription)
+{
+	if (pvData == (void*)0)
+	{
+		return DFM_FAIL;
+	}
+
+	return prvDfmAlertAddPayload(xAlertHandle, pvData, 0, ulSize, szDescription);
+}
+
+DfmResult_t xDfmAlertAddPayloadFromCallback(DfmAlertHandle_t xAlertHandle, DfmPayloadReadCallback_t xReadCallback, uint32_t ulSize, const char* szDescription)
+{
+	if (xReadCallback == 0)
+	{
+		return DFM_FAIL;
+	}
+
+	return prvDfmAlertAddPayload(xAlertHandle, (void*)0, xReadCallback, ulSize, szDescription);
+}
+
+static DfmResult_t prvDfmAlertAddPayload(DfmAlertHandle_t xAlertHandle, void* pvData, DfmPayloadReadCallback_t xReadCallback, uint32_t ulSize, const char* szDescription)
 {
 	DfmAlert_t* pxAlert = (DfmAlert_t*)xAlertHandle;
 	uint32_t i;
@@ -338,11 +379,6 @@ DfmResult_t xDfmAlertAddPayload(DfmAlertHandle_t xAlertHandle, void* pvData, uin
 		return DFM_FAIL;
 	}
 
-	if (pvData == (void*)0)
-	{
-		return DFM_FAIL;
-	}
-
 	if (ulSize == (uint32_t)0)
 	{
 		return DFM_FAIL;
@@ -365,6 +401,8 @@ DfmResult_t xDfmAlertAddPayload(DfmAlertHandle_t xAlertHandle, void* pvData, uin
 
 	pxDfmAlertData->xPayloads[pxDfmAlertData->ulPayloadCount].pvData = pvData;
 
+	pxDfmAlertData->xPayloads[pxDfmAlertData->ulPayloadCount].xReadCallback = xReadCallback;
+
 	pxDfmAlertData->xPayloads[pxDfmAlertData->ulPayloadCount].ulSize = ulSize;
 
 	for (i = (uint32_t)0; i < (uint32_t)(DFM_PAYLOAD_DESCRIPTION_MAX_LEN); i++)
@@ -532,6 +570,18 @@ DfmResult_t xDfmAlertEndCustom(DfmAlertHandle_t xAlertHandle, uint32_t ulEndType
 		return DFM_FAIL;
 	}
 
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1)
+	if (prvDfmAlertRateLimit(pxAlert, DFM_CFG_ALERT_RATE_LIMIT_GET_TIME_MS()) == DFM_FAIL)
+	{
+		/* A repeat that has been counted and will be reported by the next alert with this signature */
+		DFM_DEBUG_PRINT("DFM: Repeated alert suppressed\n");
+
+		prvDfmAlertReset(pxAlert);
+
+		return DFM_SUCCESS;
+	}
+#endif
+
 	pxAlert->ulChecksum = prvDfmAlertCalculateChecksum((uint8_t*)pxAlert, sizeof(DfmAlert_t) - sizeof(uint32_t));
 
 	if ((ulEndType & DFM_ALERT_END_TYPE_SEND) > 0)
@@ -541,6 +591,14 @@ DfmResult_t xDfmAlertEndCustom(DfmAlertHandle_t xAlertHandle, uint32_t ulEndType
 		{
                         /* Hook for doing stuff after the full alert has been sent. */
                         DFM_CFG_AFTER_ALERT_SEND(pxAlert);
+
+#ifdef DFM_CFG_AFTER_ALERT_DELIVERED
+			prvDfmAlertDelivered();
+#endif
+
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1)
+			prvDfmAlertRateLimitReported();
+#endif
                   
 			prvDfmAlertReset(pxAlert);
                         
@@ -553,6 +611,10 @@ DfmResult_t xDfmAlertEndCustom(DfmAlertHandle_t xAlertHandle, uint32_t ulEndType
 		/* Try to store */
 		if (prvDfmProcessAlert(prvStoreAlert, prvStorePayloadChunk) == DFM_SUCCESS)
 		{
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1)
+			prvDfmAlertRateLimitReported();
+#endif
+
 			prvDfmAlertReset(pxAlert);
 
 			return DFM_SUCCESS;
@@ -566,6 +628,10 @@ DfmResult_t xDfmAlertEndCustom(DfmAlertHandle_t xAlertHandle, uint32_t ulEndType
 		/* Try to store in retained memory*/
 		if (prvDfmProcessAlert(prvStoreRetainedMemoryAlert, prvStoreRetainedMemoryPayloadChunk) == DFM_SUCCESS)
 		{
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1)
+			prvDfmAlertRateLimitReported();
+#endif
+
 			prvDfmAlertReset(pxAlert);
 
 			return DFM_SUCCESS;
@@ -679,12 +745,12 @@ DfmResult_t xDfmTestSetRevision(DfmAlertHandle_t xAlertHandle, char* szFirmwareV
 
 DfmResult_t xDfmAlertSendAll(void)
 {
-	return prvDfmGetAll(xDfmCloudSendAlert, xDfmCloudSendPayloadChunk);
+	return prvDfmGetAll(xDfmCloudSendAlert, xDfmCloudSendPayloadChunk, 1);
 }
 
 DfmResult_t xDfmAlertGetAll(DfmAlertEntryCallback_t xCallback)
 {
-	return prvDfmGetAll(xCallback, xCallback);
+	return prvDfmGetAll(xCallback, xCallback, 0);
 }
 
 DfmResult_t xDfmAlertStoreRetainedMemory(void)
@@ -718,7 +784,8 @@ DfmResult_t xDfmAlertStoreRetainedMemory(void)
 
 	memset(pvBuffer, 0, ulBufferSize);
 	
-	if (xDfmRetainedMemoryReadAlert(pvBuffer, ulBufferSize) == DFM_SUCCESS)
+	/* Replay all pending alerts, oldest first */
+	while (xDfmRetainedMemoryReadAlert(pvBuffer, ulBufferSize) == DFM_SUCCESS)
 	{
 		while(1)
 		{
@@ -772,6 +839,8 @@ DfmResult_t xDfmAlertStoreRetainedMemory(void)
 
 			break;
 		}
+
+		memset(pvBuffer, 0, ulBufferSize);
 	}
 
 	(void)xDfmRetainedMemoryClear();
@@ -782,9 +851,10 @@ DfmResult_t xDfmAlertStoreRetainedMemory(void)
 #endif
 }
 
-static DfmResult_t prvDfmGetAll(DfmAlertEntryCallback_t xAlertCallback, DfmAlertEntryCallback_t xPayloadCallback)
+static DfmResult_t prvDfmGetAll(DfmAlertEntryCallback_t xAlertCallback, DfmAlertEntryCallback_t xPayloadCallback, uint32_t ulSend)
 {
 	DfmEntryHandle_t xEntryHandle = 0;
+	DfmResult_t xPayloadResult;
 	uint32_t i;
 	const char* szSessionId = (void*)0;
 	char cSessionIdBuffer[DFM_SESSION_ID_MAX_LEN] = { 0 };
@@ -820,7 +890,8 @@ static DfmResult_t prvDfmGetAll(DfmAlertEntryCallback_t xAlertCallback, DfmAlert
 #if (defined(DFM_CFG_RETAINED_MEMORY) && (DFM_CFG_RETAINED_MEMORY >= 1))
 	memset(pvBuffer, 0, ulBufferSize);
 	
-	if (xDfmRetainedMemoryReadAlert(pvBuffer, ulBufferSize) == DFM_SUCCESS)
+	/* Replay all pending alerts, oldest first */
+	while (xDfmRetainedMemoryReadAlert(pvBuffer, ulBufferSize) == DFM_SUCCESS)
 	{
 		while (1)
 		{
@@ -857,23 +928,35 @@ static DfmResult_t prvDfmGetAll(DfmAlertEntryCallback_t xAlertCallback, DfmAlert
 
 			memset(pvBuffer, 0, ulBufferSize);
 
+			xPayloadResult = DFM_SUCCESS;
 			while (xDfmRetainedMemoryReadPayloadChunk(cSessionIdBuffer, ulAlertId, pvBuffer, ulBufferSize) == DFM_SUCCESS)
 			{
 				if (xDfmEntryCreatePayloadChunkFromBuffer(cSessionIdBuffer , ulAlertId, &xEntryHandle) == DFM_FAIL)
 				{
+					xPayloadResult = DFM_FAIL;
 					break;
 				}
 
 				if (xPayloadCallback(xEntryHandle) == DFM_FAIL)
 				{
+					xPayloadResult = DFM_FAIL;
 					break;
 				}
 
 				memset(pvBuffer, 0, ulBufferSize);
 			}
+
+#ifdef DFM_CFG_AFTER_ALERT_DELIVERED
+			if ((ulSend == (uint32_t)1) && (xPayloadResult == DFM_SUCCESS))
+			{
+				DFM_CFG_AFTER_ALERT_DELIVERED(cSessionIdBuffer, ulAlertId);
+			}
+#endif
 			
 			break;
 		}
+
+		memset(pvBuffer, 0, ulBufferSize);
 	}
 
 	(void)xDfmRetainedMemoryClear();
@@ -916,25 +999,52 @@ static DfmResult_t prvDfmGetAll(DfmAlertEntryCallback_t xAlertCallback, DfmAlert
 
 		memset(pvBuffer, 0, ulBufferSize);
 
+		xPayloadResult = DFM_SUCCESS;
 		while (xDfmStorageGetPayloadChunk(cSessionIdBuffer, ulAlertId, pvBuffer, ulBufferSize) == DFM_SUCCESS)
 		{
 			if (xDfmEntryCreatePayloadChunkFromBuffer(cSessionIdBuffer , ulAlertId, &xEntryHandle) == DFM_FAIL)
 			{
+				xPayloadResult = DFM_FAIL;
 				break;
 			}
 
 			if (xPayloadCallback(xEntryHandle) == DFM_FAIL)
 			{
+				xPayloadResult = DFM_FAIL;
 				break;
 			}
 
 			memset(pvBuffer, 0, ulBufferSize);
 		}
+
+#ifdef DFM_CFG_AFTER_ALERT_DELIVERED
+		if ((ulSend == (uint32_t)1) && (xPayloadResult == DFM_SUCCESS))
+		{
+			DFM_CFG_AFTER_ALERT_DELIVERED(cSessionIdBuffer, ulAlertId);
+		}
+#endif
 	}
 
+	(void)ulSend;
+	(void)xPayloadResult;
+
 	return DFM_SUCCESS;
 }
 
+#ifdef DFM_CFG_AFTER_ALERT_DELIVERED
+/* Called when the current alert has been sent with all its payloads */
+static void prvDfmAlertDelivered(void)
+{
+	char* szSessionId = (void*)0;
+	uint32_t ulAlertId = 0;
+
+	if ((xDfmSessionGetUniqueSessionId(&szSessionId) == DFM_SUCCESS) && (xDfmSessionGetAlertId(&ulAlertId) == DFM_SUCCESS))
+	{
+		DFM_CFG_AFTER_ALERT_DELIVERED(szSessionId, ulAlertId);
+	}
+}
+#endif
+
 static void prvDfmAlertReset(DfmAlert_t* pxAlert)
 {
 	uint32_t i;
@@ -957,6 +1067,7 @@ static void prvDfmAlertReset(DfmAlert_t* pxAlert)
 		pxDfmAlertData->xPayloads[i].pvData = (void*)0;
 		pxDfmAlertData->xPayloads[i].ulSize = 0;
 		pxDfmAlertData->xPayloads[i].cDescriptionBuffer[0] = (char)0;
+		pxDfmAlertData->xPayloads[i].xReadCallback = 0;
 	}
 	pxDfmAlertData->ulPayloadCount = 0;
 
@@ -1017,8 +1128,17 @@ static DfmResult_t prvDfmProcessAlert(DfmAlertEntryCallback_t xAlertCallback, Df
 			{
 				ulChunkSize = pxDfmAlertData->xPayloads[i].ulSize - ulOffset;
 			}
-			
-			if (xDfmEntryCreatePayloadChunk((DfmAlertHandle_t)pxAlert, (uint16_t)(i + 1UL), j + (uint16_t)1, usChunkCount, (void*)((uintptr_t)pxDfmAlertData->xPayloads[i].pvData + ulOffset), ulChunkSize, pxDfmAlertData->xPayloads[i].cDescriptionBuffer, &xEntryHandle) == DFM_FAIL) /*cstat !MISRAC2012-Rule-11.6 We need to modify the address by an offset in order to get next payload chunk*/
+
+			if (pxDfmAlertData->xPayloads[i].xReadCallback != 0)
+			{
+				/* The payload isn't in memory, it's read directly into the chunk entry */
+				if (xDfmEntryCreatePayloadChunkFromCallback((DfmAlertHandle_t)pxAlert, (uint16_t)(i + 1UL), j + (uint16_t)1, usChunkCount, pxDfmAlertData->xPayloads[i].xReadCallback, ulOffset, ulChunkSize, pxDfmAlertData->xPayloads[i].cDescriptionBuffer, &xEntryHandle) == DFM_FAIL)
+				{
+					/* Couldn't create entry for this payload chunk, continue to next */
+					continue;
+				}
+			}
+			else if (xDfmEntryCreatePayloadChunk((DfmAlertHandle_t)pxAlert, (uint16_t)(i + 1UL), j + (uint16_t)1, usChunkCount, (void*)((uintptr_t)pxDfmAlertData->xPayloads[i].pvData + ulOffset), ulChunkSize, pxDfmAlertData->xPayloads[i].cDescriptionBuffer, &xEntryHandle) == DFM_FAIL) /*cstat !MISRAC2012-Rule-11.6 We need to modify the address by an offset in order to get next payload chunk*/
 			{
 				/* Couldn't create entry for this payload chunk, continue to next */
 				continue;
@@ -1045,4 +1165,324 @@ static uint32_t prvDfmAlertCalculateChecksum(uint8_t* pxData, uint32_t ulSize)
 	return 0;
 }
 
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1)
+
+/* FNV-1a over the alert type and symptoms, the parts that tell what went wrong */
+static uint32_t prvDfmAlertCalculateSignature(const DfmAlert_t* pxAlert)
+{
+	uint32_t ulSignature = 0x811C9DC5UL;
+	uint32_t ulWords[1 + (DFM_CFG_MAX_SYMPTOMS) * 2];
+	uint32_t ulWordCount = 0;
+	uint32_t i;
+	uint32_t j;
+
+	ulWords[ulWordCount++] = pxAlert->ulAlertType;
+	for (i = (uint32_t)0; (i < (uint32_t)pxAlert->ucSymptomCount) && (i < (uint32_t)(DFM_CFG_MAX_SYMPTOMS)); i++)
+	{
+		ulWords[ulWordCount++] = pxAlert->xSymptoms[i].ulId;
+		ulWords[ulWordCount++] = pxAlert->xSymptoms[i].ulValue;
+	}
+
+	for (i = (uint32_t)0; i < ulWordCount; i++)
+	{
+		for (j = (uint32_t)0; j < (uint32_t)4; j++)
+		{
+			ulSignature ^= (ulWords[i] >> (j * 8UL)) & 0xFFUL;
+			ulSignature *= 0x01000193UL;
+		}
+	}
+
+	return ulSignature;
+}
+
+/* Token bucket per signature. Returns DFM_FAIL if the alert should be suppressed. */
+static DfmResult_t prvDfmAlertRateLimit(DfmAlert_t* pxAlert, uint32_t ulTime)
+{
+	DfmAlertRateLimitEntry_t* pxEntry = (void*)0;
+	DfmAlertRateLimitEntry_t* pxOldest = &pxDfmAlertData->xRateLimitEntries[0];
+	uint32_t ulBurst = (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_BURST(pxAlert->ulAlertType));
+	uint32_t ulSignature;
+	uint32_t ulRefills;
+	uint32_t i;
+
+	if (ulBurst == (uint32_t)0)
+	{
+		/* This alert type is not rate limited */
+		return DFM_SUCCESS;
+	}
+
+	ulSignature = prvDfmAlertCalculateSignature(pxAlert);
+
+	for (i = (uint32_t)0; i < (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_SLOTS); i++)
+	{
+		DfmAlertRateLimitEntry_t* pxCurrent = &pxDfmAlertData->xRateLimitEntries[i];
+
+		if ((pxCurrent->ulLastUsed != (uint32_t)0) && (pxCurrent->ulSignature == ulSignature))
+		{
+			pxEntry = pxCurrent;
+			break;
+		}
+
+		/* Free slots have ulLastUsed 0 and are picked before any used slot */
+		if (pxCurrent->ulLastUsed < pxOldest->ulLastUsed)
+		{
+			pxOldest = pxCurrent;
+		}
+	}
+
+	pxDfmAlertData->ulRateLimitSequence++;
+	if (pxDfmAlertData->ulRateLimitSequence == (uint32_t)0)
+	{
+		/* Wrapped, restart the order from 1 so that no used slot looks free */
+		for (i = (uint32_t)0; i < (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_SLOTS); i++)
+		{
+			if (pxDfmAlertData->xRateLimitEntries[i].ulLastUsed != (uint32_t)0)
+			{
+				pxDfmAlertData->xRateLimitEntries[i].ulLastUsed = 1;
+			}
+		}
+		pxDfmAlertData->ulRateLimitSequence = 2;
+	}
+
+	if (pxEntry == (void*)0)
+	{
+		/* First time seen, or evicted since. Replaces the least recently seen signature. */
+		pxEntry = pxOldest;
+
+#ifdef DFM_SYMPTOM_EVICTED_ALERTS
+		if (pxEntry->ulLastUsed != (uint32_t)0)
+		{
+			/* Its suppressed count goes with the next emitted alert instead, as a separate symptom */
+			pxDfmAlertData->ulRateLimitEvicted += pxEntry->ulSuppressed;
+			if (pxDfmAlertData->ulRateLimitEvicted < pxEntry->ulSuppressed)
+			{
+				pxDfmAlertData->ulRateLimitEvicted = 0xFFFFFFFFUL;
+			}
+		}
+#endif
+
+		pxEntry->ulSignature = ulSignature;
+		pxEntry->ulTokens = ulBurst;
+		pxEntry->ulRefillTime = ulTime;
+		pxEntry->ulSuppressed = 0;
+	}
+	else
+	{
+		ulRefills = (uint32_t)(ulTime - pxEntry->ulRefillTime) / (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_PERIOD_MS);
+		if ((ulRefills >= ulBurst) || (pxEntry->ulTokens + ulRefills >= ulBurst))
+		{
+			pxEntry->ulTokens = ulBurst;
+			pxEntry->ulRefillTime = ulTime;
+		}
+		else
+		{
+			pxEntry->ulTokens += ulRefills;
+			pxEntry->ulRefillTime += ulRefills * (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_PERIOD_MS);
+		}
+	}
+
+	pxEntry->ulLastUsed = pxDfmAlertData->ulRateLimitSequence;
+
+	if (pxEntry->ulTokens == (uint32_t)0)
+	{
+		if (pxEntry->ulSuppressed < 0xFFFFFFFFUL)
+		{
+			pxEntry->ulSuppressed++;
+		}
+
+		return DFM_FAIL;
+	}
+
+	pxEntry->ulTokens--;
+
+	/* The counts are only cleared by prvDfmAlertRateLimitReported() once the alert has been sent or stored */
+	pxDfmAlertData->pxRateLimitReported = pxEntry;
+	pxDfmAlertData->ulRateLimitReportedSuppressed = 0;
+	pxDfmAlertData->ulRateLimitReportedEvicted = 0;
+
+#ifdef DFM_SYMPTOM_SUPPRESSED_ALERTS
+	/* Keep the count for the next alert if there is no room for it in this one */
+	if ((pxEntry->ulSuppressed > (uint32_t)0) && (pxAlert->ucSymptomCount < (uint8_t)(DFM_CFG_MAX_SYMPTOMS)))
+	{
+		pxAlert->xSymptoms[pxAlert->ucSymptomCount].ulId = DFM_SYMPTOM_SUPPRESSED_ALERTS;
+		pxAlert->xSymptoms[pxAlert->ucSymptomCount].ulValue = pxEntry->ulSuppressed;
+		pxAlert->ucSymptomCount++;
+		pxDfmAlertData->ulRateLimitReportedSuppressed = pxEntry->ulSuppressed;
+	}
+#else
+	/* Not reported */
+	pxDfmAlertData->ulRateLimitReportedSuppressed = pxEntry->ulSuppressed;
+#endif
+
+#ifdef DFM_SYMPTOM_EVICTED_ALERTS
+	if ((pxDfmAlertData->ulRateLimitEvicted > (uint32_t)0) && (pxAlert->ucSymptomCount < (uint8_t)(DFM_CFG_MAX_SYMPTOMS)))
+	{
+		pxAlert->xSymptoms[pxAlert->ucSymptomCount].ulId = DFM_SYMPTOM_EVICTED_ALERTS;
+		pxAlert->xSymptoms[pxAlert->ucSymptomCount].ulValue = pxDfmAlertData->ulRateLimitEvicted;
+		pxAlert->ucSymptomCount++;
+		pxDfmAlertData->ulRateLimitReportedEvicted = pxDfmAlertData->ulRateLimitEvicted;
+	}
+#endif
+
+	return DFM_SUCCESS;
+}
+
+/* Called when the alert has been sent or stored. Clears the counts that were reported in it. */
+static void prvDfmAlertRateLimitReported(void)
+{
+	DfmAlertRateLimitEntry_t* pxEntry = pxDfmAlertData->pxRateLimitReported;
+
+	/* Subtracted, since repeats counted meanwhile are not reported yet */
+	if ((pxEntry != (void*)0) && (pxEntry->ulSuppressed >= pxDfmAlertData->ulRateLimitReportedSuppressed))
+	{
+		pxEntry->ulSuppressed -= pxDfmAlertData->ulRateLimitReportedSuppressed;
+	}
+
+	if (pxDfmAlertData->ulRateLimitEvicted >= pxDfmAlertData->ulRateLimitReportedEvicted)
+	{
+		pxDfmAlertData->ulRateLimitEvicted -= pxDfmAlertData->ulRateLimitReportedEvicted;
+	}
+
+	pxDfmAlertData->pxRateLimitReported = (void*)0;
+	pxDfmAlertData->ulRateLimitReportedSuppressed = 0;
+	pxDfmAlertData->ulRateLimitReportedEvicted = 0;
+}
+
+#if (INCLUDE_ALERT_RATE_LIMIT_TESTS == 1) && defined(DFM_SYMPTOM_SUPPRESSED_ALERTS) && defined(DFM_SYMPTOM_EVICTED_ALERTS)
+
+static uint32_t ulRateLimitTestErrors = 0;
+static uint32_t ulRateLimitTestSent = 1; /* Whether emitted alerts are simulated as sent */
+
+static void prvDfmAlertRateLimitCheck(DfmAlert_t* pxAlert, uint32_t ulTime, DfmResult_t xExpectedResult, uint32_t ulExpectedSuppressed, uint32_t ulExpectedEvicted)
+{
+	DfmResult_t xResult;
+	uint32_t ulSuppressed = 0;
+	uint32_t ulEvicted = 0;
+	uint32_t ulSymptomCount = (uint32_t)pxAlert->ucSymptomCount;
+	uint32_t i;
+
+	xResult = prvDfmAlertRateLimit(pxAlert, ulTime);
+
+	/* Remove the count symptoms again, so the signature stays the same */
+	for (i = ulSymptomCount; i < (uint32_t)pxAlert->ucSymptomCount; i++)
+	{
+		if (pxAlert->xSymptoms[i].ulId == (uint32_t)(DFM_SYMPTOM_SUPPRESSED_ALERTS))
+		{
+			ulSuppressed = pxAlert->xSymptoms[i].ulValue;
+		}
+		else if (pxAlert->xSymptoms[i].ulId == (uint32_t)(DFM_SYMPTOM_EVICTED_ALERTS))
+		{
+			ulEvicted = pxAlert->xSymptoms[i].ulValue;
+		}
+	}
+	pxAlert->ucSymptomCount = (uint8_t)ulSymptomCount;
+
+	if ((xResult == DFM_SUCCESS) && (ulRateLimitTestSent == (uint32_t)1))
+	{
+		prvDfmAlertRateLimitReported();
+	}
+
+	printf("t=%-8u type=%-3u result=%-2d suppressed=%-3u evicted=%-3u %s\n", (unsigned int)ulTime, (unsigned int)pxAlert->ulAlertType, (int)xResult, (unsigned int)ulSuppressed, (unsigned int)ulEvicted,
+		((xResult == xExpectedResult) && (ulSuppressed == ulExpectedSuppressed) && (ulEvicted == ulExpectedEvicted)) ? "(OK)" : "(ERROR)");
+
+	if ((xResult != xExpectedResult) || (ulSuppressed != ulExpectedSuppressed) || (ulEvicted != ulExpectedEvicted))
+	{
+		ulRateLimitTestErrors++;
+	}
+}
+
+/* Runs the rate limiter on simulated alerts and time, prints the results. Erases the rate limiter state. */
+DfmResult_t xDfmAlertRateLimitRunTests(void)
+{
+	static DfmAlert_t xAlerts[(DFM_CFG_ALERT_RATE_LIMIT_SLOTS) + 1];
+	uint32_t ulBurst = (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_BURST(1));
+	uint32_t ulPeriod = (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_PERIOD_MS);
+	uint32_t ulTime = 0xFFFFFFFFUL - ulPeriod; /* Wraps during the test */
+	uint32_t i;
+
+	if ((pxDfmAlertData == (void*)0) || (ulBurst == (uint32_t)0))
+	{
+		return DFM_FAIL;
+	}
+
+	for (i = (uint32_t)0; i < (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_SLOTS); i++)
+	{
+		pxDfmAlertData->xRateLimitEntries[i].ulLastUsed = 0;
+	}
+	pxDfmAlertData->ulRateLimitSequence = 0;
+	pxDfmAlertData->ulRateLimitEvicted = 0;
+	pxDfmAlertData->pxRateLimitReported = (void*)0;
+	ulRateLimitTestErrors = 0;
+	ulRateLimitTestSent = 1;
+
+	for (i = (uint32_t)0; i < (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_SLOTS) + 1UL; i++)
+	{
+		xAlerts[i].ulAlertType = 1;
+		xAlerts[i].ucSymptomCount = 1;
+		xAlerts[i].xSymptoms[0].ulId = 1;
+		xAlerts[i].xSymptoms[0].ulValue = 0x1000 + i;
+	}
+
+	printf("\nTest 1: Burst, then suppressed.\n");
+	for (i = (uint32_t)0; i < ulBurst; i++)
+	{
+		prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_SUCCESS, 0, 0);
+	}
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_FAIL, 0, 0);
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime + ulPeriod - 1UL, DFM_FAIL, 0, 0);
+
+	printf("\nTest 2: Other signatures are not affected.\n");
+	prvDfmAlertRateLimitCheck(&xAlerts[1], ulTime, DFM_SUCCESS, 0, 0);
+
+	printf("\nTest 3: One token per period, reports the suppressed count.\n");
+	ulTime += ulPeriod;
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_SUCCESS, 2, 0);
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_FAIL, 0, 0);
+
+	printf("\nTest 4: Refills to the burst size after a long pause.\n");
+	ulTime += ulPeriod * (ulBurst + 10UL);
+	for (i = (uint32_t)0; i < ulBurst; i++)
+	{
+		prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_SUCCESS, (i == (uint32_t)0) ? 1 : 0, 0);
+	}
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_FAIL, 0, 0);
+
+	printf("\nTest 5: The least recently seen signature is evicted when full, its suppressed count goes with the next alert as evicted.\n");
+	for (i = (uint32_t)1; i < (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_SLOTS) + 1UL; i++)
+	{
+		prvDfmAlertRateLimitCheck(&xAlerts[i], ulTime, DFM_SUCCESS, 0, (i == (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_SLOTS)) ? 1 : 0);
+	}
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_SUCCESS, 0, 0);
+
+	printf("\nTest 6: The counts are kept until the alert is sent.\n");
+	ulTime += ulPeriod * (ulBurst + 10UL);
+	for (i = (uint32_t)0; i < ulBurst; i++)
+	{
+		prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_SUCCESS, 0, 0);
+	}
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_FAIL, 0, 0);
+	ulTime += ulPeriod;
+	ulRateLimitTestSent = 0;
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_SUCCESS, 1, 0);
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_FAIL, 0, 0);
+	ulTime += ulPeriod;
+	ulRateLimitTestSent = 1;
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_SUCCESS, 2, 0);
+	ulTime += ulPeriod;
+	prvDfmAlertRateLimitCheck(&xAlerts[0], ulTime, DFM_SUCCESS, 0, 0);
+
+	printf("\nRate limiter tests %s\n", (ulRateLimitTestErrors == (uint32_t)0) ? "passed" : "FAILED");
+
+	for (i = (uint32_t)0; i < (uint32_t)(DFM_CFG_ALERT_RATE_LIMIT_SLOTS); i++)
+	{
+		pxDfmAlertData->xRateLimitEntries[i].ulLastUsed = 0;
+	}
+
+	return (ulRateLimitTestErrors == (uint32_t)0) ? DFM_SUCCESS : DFM_FAIL;
+}
+
+#endif /* (INCLUDE_ALERT_RATE_LIMIT_TESTS == 1) && defined(DFM_SYMPTOM_SUPPRESSED_ALERTS) && defined(DFM_SYMPTOM_EVICTED_ALERTS) */
+
+#endif /* ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1) */
+
 #endif
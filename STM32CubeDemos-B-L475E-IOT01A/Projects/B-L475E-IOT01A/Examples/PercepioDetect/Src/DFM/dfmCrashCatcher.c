@@ -10,6 +10,7 @@
 
 #include <CrashCatcher.h>
 #include <string.h>
+#include <stddef.h>
 #include <dfm.h>
 #include <dfmCrashCatcher.h>
 #include <CrashCatcherPriv.h>
@@ -24,8 +25,49 @@ static void prvAddTracePayload(void);
 
 /* See https://developer.arm.com/documentation/dui0552/a/cortex-m3-peripherals/system-control-block/configurable-fault-status-register*/
 #define ARM_CORTEX_M_CFSR_REGISTER *(uint32_t*)0xE000ED28
+#define ARM_CORTEX_M_HFSR_REGISTER *(uint32_t*)0xE000ED2C
+#define ARM_CORTEX_M_MMFAR_REGISTER *(uint32_t*)0xE000ED34
+#define ARM_CORTEX_M_BFAR_REGISTER *(uint32_t*)0xE000ED38
+
+#define ARM_CORTEX_M_CFSR_MMARVALID (1UL << 7)
+#define ARM_CORTEX_M_CFSR_BFARVALID (1UL << 15)
+
+/* Offsets of LR and PC in the crash dump, after the signature, flags and R0-R12 and SP */
+#define CRASH_DUMP_LR_OFFSET 64
+#define CRASH_DUMP_PC_OFFSET 68
+
+#define FNV_OFFSET_BASIS 0x811C9DC5UL
+#define FNV_PRIME 0x01000193UL
+
+#define CRASH_SEEN_TABLE_MAGIC 0x4E454553UL /* "SEEN" */
+
+#if ((DFM_CFG_CRASH_SEEN_TABLE_SIZE) > 0)
+/* Hashes of the crashes seen since power on, kept in RAM that isn't cleared on restart */
+typedef struct DfmCrashSeenTable
+{
+	uint32_t ulMagic;
+	uint32_t ulNext;
+	struct
+	{
+		uint32_t ulHash;
+		uint32_t ulCount;
+		uint32_t ulDelivered;	/* 1 when an alert with the crash dump has been sent */
+		uint32_t ulSession;		/* Hash of the session id of the alert with the crash dump, until delivered */
+		uint32_t ulAlertId;
+	} xEntries[DFM_CFG_CRASH_SEEN_TABLE_SIZE];
+	uint32_t ulChecksum;
+} DfmCrashSeenTable_t;
+
+static volatile __attribute__((section (".noinit"))) DfmCrashSeenTable_t xCrashSeenTable;
+
+static uint32_t prvCrashSeen(uint32_t ulHash, uint32_t* pulDelivered);
+static void prvCrashDumpPending(uint32_t ulHash);
+static void prvCrashSeenTableValidate(void);
+static void prvCrashSeenTableUpdateChecksum(void);
+#endif
 
 static DfmAlertHandle_t xAlertHandle = 0;
+static int xAlertType = 0;
 
 dfmTrapInfo_t dfmTrapInfo = {-1, NULL, NULL, -1, 0};
 
@@ -59,6 +101,20 @@ static char* prvGetFileNameFromPath(char* szPath)
 	return 0; /* No slash found */
 }
 
+/* FNV-1a, continuing from ulHash */
+static uint32_t prvHash(uint32_t ulHash, const void* pvData, size_t size)
+{
+	const uint8_t* pucData = (const uint8_t*)pvData;
+	size_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		ulHash = (ulHash ^ pucData[i]) * FNV_PRIME;
+	}
+
+	return ulHash;
+}
+
 uint32_t prvCalculateChecksum(char *ptr, size_t maxlen)
 {
 	uint32_t chksum = 0;
@@ -75,32 +131,159 @@ uint32_t prvCalculateChecksum(char *ptr, size_t maxlen)
 		i++;
 	}
 
+#if ((DFM_CFG_CRASH_HASH_NAMES) >= 1)
+	/* The sum gives the same value for e.g. "TaskA1" and "TaskB0" */
+	chksum = prvHash(FNV_OFFSET_BASIS, ptr, i);
+#endif
+
 	return chksum;
 }
 
+#if ((DFM_CFG_CRASH_SEEN_TABLE_SIZE) > 0)
+/* Identifies the session of a stored alert, never 0 */
+static uint32_t prvCalculateSessionHash(const char* szSessionId)
+{
+	uint32_t ulHash = prvHash(FNV_OFFSET_BASIS, szSessionId, strlen(szSessionId));
+
+	return (ulHash != 0UL) ? ulHash : 1UL;
+}
+#endif
+
+/* The most specific reason in CFSR and HFSR */
+static const char* prvGetFaultReason(uint32_t ulCFSR, uint32_t ulHFSR)
+{
+	static const struct
+	{
+		uint32_t ulMask;
+		const char* szReason;
+	} xReasons[] = {
+		{1UL << 0, "Instruction access violation"},
+		{1UL << 1, "Data access violation"},
+		{1UL << 3, "MemManage fault on unstacking"},
+		{1UL << 4, "MemManage fault on stacking"},
+		{1UL << 5, "MemManage fault on FP lazy state preservation"},
+		{1UL << 8, "Instruction bus error"},
+		{1UL << 9, "Precise data bus error"},
+		{1UL << 10, "Imprecise data bus error"},
+		{1UL << 11, "Bus fault on unstacking"},
+		{1UL << 12, "Bus fault on stacking"},
+		{1UL << 13, "Bus fault on FP lazy state preservation"},
+		{1UL << 16, "Undefined instruction"},
+		{1UL << 17, "Invalid state"},
+		{1UL << 18, "Invalid PC load"},
+		{1UL << 19, "No coprocessor"},
+		{1UL << 24, "Unaligned access"},
+		{1UL << 25, "Divide by zero"}
+	};
+	size_t i;
+
+	for (i = 0; i < (sizeof(xReasons) / sizeof(xReasons[0])); i++)
+	{
+		if ((ulCFSR & xReasons[i].ulMask) != 0UL)
+		{
+			return xReasons[i].szReason;
+		}
+	}
+
+	if ((ulHFSR & (1UL << 1)) != 0UL)
+	{
+		return "Vector table read fault";
+	}
+
+	return "Fault exception";
+}
+
+/* A return address is odd (Thumb), within the code and follows a BL or BLX instruction */
+static int prvIsReturnAddress(uint32_t ulValue)
+{
+	const uint16_t* pusNext;
+
+	if (((ulValue & 1UL) == 0UL) || (ulValue < ((DFM_CFG_CODE_BEGIN) + 4UL)) || (ulValue >= (DFM_CFG_CODE_NEXT)))
+	{
+		return 0;
+	}
+
+	pusNext = (const uint16_t*)(ulValue - 1UL);
+
+	/* BLX <Rm>: 0100 0111 1xxx x000 */
+	if ((pusNext[-1] & 0xFF87U) == 0x4780U)
+	{
+		return 1;
+	}
+
+	/* BL <label>: 1111 0xxx xxxx xxxx, 11x1 xxxx xxxx xxxx */
+	if (((pusNext[-2] & 0xF800U) == 0xF000U) && ((pusNext[-1] & 0xD000U) == 0xD000U))
+	{
+		return 1;
+	}
+
+	return 0;
+}
+
 const CrashCatcherMemoryRegion* CrashCatcher_GetMemoryRegions(void)
 {
-	static CrashCatcherMemoryRegion regions[] = {
-		{0xFFFFFFFF, 0xFFFFFFFF, CRASH_CATCHER_BYTE},
+	/* The stack, return addresses from the rest of the stack, the additional regions and the terminator */
+	static CrashCatcherMemoryRegion regions[1 + (CRASH_STACK_MAX_RETURN_ADDRESSES) + 4];
+	static const CrashCatcherMemoryRegion additionalRegions[] = {
 		{CRASH_MEM_REGION1_START, CRASH_MEM_REGION1_START + CRASH_MEM_REGION1_SIZE, CRASH_CATCHER_BYTE},
 		{CRASH_MEM_REGION2_START, CRASH_MEM_REGION2_START + CRASH_MEM_REGION2_SIZE, CRASH_CATCHER_BYTE},
-		{CRASH_MEM_REGION3_START, CRASH_MEM_REGION3_START + CRASH_MEM_REGION3_SIZE, CRASH_CATCHER_BYTE}
+		{CRASH_MEM_REGION3_START, CRASH_MEM_REGION3_START + CRASH_MEM_REGION3_SIZE, CRASH_CATCHER_BYTE},
+		{0xFFFFFFFF, 0xFFFFFFFF, CRASH_CATCHER_BYTE}
 	};
+	uint32_t ulStackLow = 0;
+	uint32_t ulStackHigh = 0;
+	uint32_t ulRegions = 1;
+	uint32_t ulReturnAddresses = 0;
+	uint32_t ulAddress;
 
-	/* Region 0 is reserved, always relative to the current stack pointer */
+	/* Region 0 is reserved, always starting at the current stack pointer */
 	regions[0].startAddress = stackPointer;
-	regions[0].endAddress = stackPointer + CRASH_STACK_CAPTURE_SIZE;
+	regions[0].elementSize = CRASH_CATCHER_BYTE;
 
-	// If inside the stack memory area, we verify that we don't overrun the endAddress...
-	if ( (regions[0].startAddress >= DFM_CFG_ADDR_CHECK_BEGIN) && (regions[0].startAddress < DFM_CFG_ADDR_CHECK_NEXT))
+	if ((xDfmKernelPortGetCurrentTaskStack(&ulStackLow, &ulStackHigh) == DFM_SUCCESS) && (stackPointer >= ulStackLow) && (stackPointer < ulStackHigh))
+	{
+		/* The fault happened on the task stack, dump the used part of it */
+		if ((ulStackHigh - stackPointer) <= CRASH_STACK_CAPTURE_SIZE)
+		{
+			regions[0].endAddress = ulStackHigh;
+		}
+		else
+		{
+			/* Too large, dump the top frames in full and only the return addresses from the rest for the backtrace */
+			regions[0].endAddress = stackPointer + CRASH_STACK_HEAD_SIZE;
+
+			for (ulAddress = regions[0].endAddress; (ulAddress < ulStackHigh) && (ulReturnAddresses < (CRASH_STACK_MAX_RETURN_ADDRESSES)); ulAddress += 4)
+			{
+				if (prvIsReturnAddress(*(uint32_t*)ulAddress))
+				{
+					regions[ulRegions].startAddress = ulAddress;
+					regions[ulRegions].endAddress = ulAddress + 4;
+					regions[ulRegions].elementSize = CRASH_CATCHER_BYTE;
+					ulRegions++;
+					ulReturnAddresses++;
+				}
+			}
+		}
+	}
+	else
 	{
-		// Check that not reading outside the valid memory range.
-		if ( regions[0].endAddress >= DFM_CFG_ADDR_CHECK_NEXT)
+		/* Not on a known task stack, e.g. in an interrupt handler */
+		regions[0].endAddress = stackPointer + CRASH_STACK_CAPTURE_SIZE;
+
+		// If inside the stack memory area, we verify that we don't overrun the endAddress...
+		if ( (regions[0].startAddress >= DFM_CFG_ADDR_CHECK_BEGIN) && (regions[0].startAddress < DFM_CFG_ADDR_CHECK_NEXT))
 		{
-			regions[0].endAddress = DFM_CFG_ADDR_CHECK_NEXT - 4;
+			// Check that not reading outside the valid memory range.
+			if ( regions[0].endAddress >= DFM_CFG_ADDR_CHECK_NEXT)
+			{
+				regions[0].endAddress = DFM_CFG_ADDR_CHECK_NEXT - 4;
+			}
 		}
 	}
 
+	/* Ends with the terminator, also when all additional regions are used */
+	memcpy(&regions[ulRegions], additionalRegions, sizeof(additionalRegions));
+
 	return regions;
 }
 
@@ -109,6 +292,10 @@ void CrashCatcher_DumpStart(const CrashCatcherInfo* pInfo)
 	int alerttype;
 	char* szFileName = (void*)0;
 	char* szCurrentTaskName = (void*)0;
+	uint32_t ulCFSR = 0;
+	uint32_t ulHFSR = 0;
+	uint32_t ulFaultAddress = 0;
+	uint32_t ulFaultAddressValid = 0;
 
 	stackPointer = pInfo->sp;
 
@@ -130,11 +317,34 @@ void CrashCatcher_DumpStart(const CrashCatcherInfo* pInfo)
 	else
 	{
 		/* On processor fault handlers (not DFM_TRAP) */
-		snprintf(cDfmPrintBuffer, sizeof(cDfmPrintBuffer), "Fault exception, CFSR: 0x%08X", (unsigned int)ARM_CORTEX_M_CFSR_REGISTER);
+		ulCFSR = ARM_CORTEX_M_CFSR_REGISTER;
+		ulHFSR = ARM_CORTEX_M_HFSR_REGISTER;
+
+		if ((ulCFSR & ARM_CORTEX_M_CFSR_MMARVALID) != 0UL)
+		{
+			ulFaultAddress = ARM_CORTEX_M_MMFAR_REGISTER;
+			ulFaultAddressValid = 1;
+		}
+		else if ((ulCFSR & ARM_CORTEX_M_CFSR_BFARVALID) != 0UL)
+		{
+			ulFaultAddress = ARM_CORTEX_M_BFAR_REGISTER;
+			ulFaultAddressValid = 1;
+		}
+
+		if (ulFaultAddressValid != 0)
+		{
+			snprintf(cDfmPrintBuffer, sizeof(cDfmPrintBuffer), "%s at 0x%08X, CFSR: 0x%08X", prvGetFaultReason(ulCFSR, ulHFSR), (unsigned int)ulFaultAddress, (unsigned int)ulCFSR);
+		}
+		else
+		{
+			snprintf(cDfmPrintBuffer, sizeof(cDfmPrintBuffer), "%s, CFSR: 0x%08X", prvGetFaultReason(ulCFSR, ulHFSR), (unsigned int)ulCFSR);
+		}
 
 		alerttype = DFM_TYPE_HARDFAULT;
 	}
 
+	xAlertType = alerttype;
+
 	#if ((DFM_CFG_CRASH_ADD_TRACE) >= 1)
 	if (TzUserEventChannel == 0)
 	{
@@ -181,13 +391,20 @@ void CrashCatcher_DumpStart(const CrashCatcherInfo* pInfo)
 		{
 			/* On hard faults */
 			#ifdef DFM_SYMPTOM_CFSR
-			xDfmAlertAddSymptom(xAlertHandle, DFM_SYMPTOM_CFSR, ARM_CORTEX_M_CFSR_REGISTER);
+			xDfmAlertAddSymptom(xAlertHandle, DFM_SYMPTOM_CFSR, ulCFSR);
 			#endif
-		}
 
-		#if ((DFM_CFG_CRASH_ADD_TRACE) >= 1)
-		prvAddTracePayload();
-		#endif
+			#ifdef DFM_SYMPTOM_HFSR
+			xDfmAlertAddSymptom(xAlertHandle, DFM_SYMPTOM_HFSR, ulHFSR);
+			#endif
+
+			#ifdef DFM_SYMPTOM_FAULT_ADDRESS
+			if (ulFaultAddressValid != 0)
+			{
+				xDfmAlertAddSymptom(xAlertHandle, DFM_SYMPTOM_FAULT_ADDRESS, ulFaultAddress);
+			}
+			#endif
+		}
 
 		DFM_DEBUG_PRINT("  DFM: Storing the alert.\n");
 	}
@@ -208,6 +425,20 @@ static void prvAddTracePayload(void)
     // Note that tracing is already disabled at this point.
 	xTraceGetEventBuffer(&pvBuffer, &ulBufferSize);
 	xDfmAlertAddPayload(xAlertHandle, pvBuffer, ulBufferSize, "dfm_trace.psfs");
+
+	#if ((DFM_CFG_CRASH_ADD_HEAP_SUMMARY) >= 1)
+	if (xTraceHeapGetAggregation(&pvBuffer, &ulBufferSize) == TRC_SUCCESS)
+	{
+		xDfmAlertAddPayload(xAlertHandle, pvBuffer, ulBufferSize, "heap_summary.bin");
+	}
+	#endif
+
+	#if ((DFM_CFG_CRASH_ADD_TRACE_HEALTH) >= 1)
+	if (xTraceDiagnosticsGetHealthMetricsData(&pvBuffer, &ulBufferSize) == TRC_SUCCESS)
+	{
+		xDfmAlertAddPayload(xAlertHandle, pvBuffer, ulBufferSize, "trace_health.bin");
+	}
+	#endif
 }
 #endif
 
@@ -299,11 +530,59 @@ CrashCatcherReturnCodes CrashCatcher_DumpEnd(void)
 	if (xAlertHandle != 0)
 	{
 		uint32_t size = (uint32_t)ucBufferPos - (uint32_t)ucDataBuffer;
-		if (xDfmAlertAddPayload(xAlertHandle, ucDataBuffer, size, CRASH_DUMP_NAME) != DFM_SUCCESS)
+		uint32_t ulLR = 0;
+		uint32_t ulPC = 0;
+		uint32_t ulHash;
+		uint32_t ulCount = 1;
+		uint32_t ulDelivered = 0;
+
+		/* The registers are dumped first, so these are always in the buffer */
+		memcpy(&ulLR, &ucDataBuffer[CRASH_DUMP_LR_OFFSET], sizeof(ulLR));
+		memcpy(&ulPC, &ucDataBuffer[CRASH_DUMP_PC_OFFSET], sizeof(ulPC));
+
+		/* Identifies the crash, the same fault at the same place from the same caller gives the same hash */
+		ulHash = prvHash(FNV_OFFSET_BASIS, &ulPC, sizeof(ulPC));
+		ulHash = prvHash(ulHash, &ulLR, sizeof(ulLR));
+		ulHash = prvHash(ulHash, &xAlertType, sizeof(xAlertType));
+
+		#ifdef DFM_SYMPTOM_PC
+		xDfmAlertAddSymptom(xAlertHandle, DFM_SYMPTOM_PC, ulPC);
+		#endif
+
+		#if ((DFM_CFG_CRASH_SEEN_TABLE_SIZE) > 0)
+		ulCount = prvCrashSeen(ulHash, &ulDelivered);
+
+		#ifdef DFM_SYMPTOM_CRASH_COUNT
+		xDfmAlertAddSymptom(xAlertHandle, DFM_SYMPTOM_CRASH_COUNT, ulCount);
+		#endif
+		#endif
+
+		if (ulDelivered == 0)
+		{
+			#if ((DFM_CFG_CRASH_ADD_TRACE) >= 1)
+			prvAddTracePayload();
+			#endif
+
+			if (xDfmAlertAddPayload(xAlertHandle, ucDataBuffer, size, CRASH_DUMP_NAME) != DFM_SUCCESS)
+			{
+				DFM_ERROR_PRINT("DFM: Error, xDfmAlertAddPayload failed.\n");
+			}
+			#if ((DFM_CFG_CRASH_SEEN_TABLE_SIZE) > 0)
+			else
+			{
+				/* Delivered once this alert has been sent, directly or from storage */
+				prvCrashDumpPending(ulHash);
+			}
+			#endif
+		}
+		else
 		{
-			DFM_ERROR_PRINT("DFM: Error, xDfmAlertAddPayload failed.\n");
+			/* Only the alert is sent, it is counted by the backend without another copy of the same dump */
+			DFM_DEBUG_PRINT("DFM: Crash dump delivered before, not adding it.\n");
 		}
 
+		(void)ulCount;
+
 #ifdef DFM_CLOUD_PORT_ALWAYS_ATTEMPT_TRANSFER
 		/* The cloud port has indicated it is always OK to attempt to transfer */
 		if (xDfmAlertEnd(xAlertHandle) != DFM_SUCCESS)
@@ -349,6 +628,120 @@ CrashCatcherReturnCodes CrashCatcher_DumpEnd(void)
 	return CRASH_CATCHER_EXIT;
 }
 
+#if ((DFM_CFG_CRASH_SEEN_TABLE_SIZE) > 0)
+static void prvCrashSeenTableValidate(void)
+{
+	/* Cleared on power on, when the RAM content is random */
+	if ((xCrashSeenTable.ulMagic != CRASH_SEEN_TABLE_MAGIC) ||
+		(xCrashSeenTable.ulChecksum != prvHash(FNV_OFFSET_BASIS, (const void*)&xCrashSeenTable, offsetof(DfmCrashSeenTable_t, ulChecksum))) ||
+		(xCrashSeenTable.ulNext >= (DFM_CFG_CRASH_SEEN_TABLE_SIZE)))
+	{
+		memset((void*)&xCrashSeenTable, 0, sizeof(xCrashSeenTable));
+		xCrashSeenTable.ulMagic = CRASH_SEEN_TABLE_MAGIC;
+		prvCrashSeenTableUpdateChecksum();
+	}
+}
+
+static void prvCrashSeenTableUpdateChecksum(void)
+{
+	xCrashSeenTable.ulChecksum = prvHash(FNV_OFFSET_BASIS, (const void*)&xCrashSeenTable, offsetof(DfmCrashSeenTable_t, ulChecksum));
+}
+
+/* Returns how many times the crash has been seen, including this time, and if its crash dump has been delivered */
+static uint32_t prvCrashSeen(uint32_t ulHash, uint32_t* pulDelivered)
+{
+	uint32_t i;
+
+	prvCrashSeenTableValidate();
+
+	for (i = 0; i < (DFM_CFG_CRASH_SEEN_TABLE_SIZE); i++)
+	{
+		if ((xCrashSeenTable.xEntries[i].ulCount != 0) && (xCrashSeenTable.xEntries[i].ulHash == ulHash))
+		{
+			break;
+		}
+	}
+
+	if (i == (DFM_CFG_CRASH_SEEN_TABLE_SIZE))
+	{
+		/* Not seen, replace the oldest */
+		i = xCrashSeenTable.ulNext;
+		xCrashSeenTable.xEntries[i].ulHash = ulHash;
+		xCrashSeenTable.xEntries[i].ulCount = 0;
+		xCrashSeenTable.xEntries[i].ulDelivered = 0;
+		xCrashSeenTable.xEntries[i].ulSession = 0;
+		xCrashSeenTable.xEntries[i].ulAlertId = 0;
+		xCrashSeenTable.ulNext = (i + 1) % (DFM_CFG_CRASH_SEEN_TABLE_SIZE);
+	}
+
+	if (xCrashSeenTable.xEntries[i].ulCount != 0xFFFFFFFFUL)
+	{
+		xCrashSeenTable.xEntries[i].ulCount++;
+	}
+
+	prvCrashSeenTableUpdateChecksum();
+
+	*pulDelivered = xCrashSeenTable.xEntries[i].ulDelivered;
+
+	return xCrashSeenTable.xEntries[i].ulCount;
+}
+
+/* Remembers the alert that carries the crash dump, replacing an earlier one that hasn't been sent */
+static void prvCrashDumpPending(uint32_t ulHash)
+{
+	char* szSessionId = (void*)0;
+	uint32_t ulAlertId = 0;
+	uint32_t i;
+
+	if ((xDfmSessionGetUniqueSessionId(&szSessionId) == DFM_FAIL) || (xDfmSessionGetAlertId(&ulAlertId) == DFM_FAIL))
+	{
+		return;
+	}
+
+	for (i = 0; i < (DFM_CFG_CRASH_SEEN_TABLE_SIZE); i++)
+	{
+		if ((xCrashSeenTable.xEntries[i].ulCount != 0) && (xCrashSeenTable.xEntries[i].ulHash == ulHash))
+		{
+			xCrashSeenTable.xEntries[i].ulSession = prvCalculateSessionHash(szSessionId);
+			xCrashSeenTable.xEntries[i].ulAlertId = ulAlertId;
+			prvCrashSeenTableUpdateChecksum();
+			break;
+		}
+	}
+}
+#endif
+
+void vDfmCrashCatcherAlertDelivered(const char* szSessionId, uint32_t ulAlertId)
+{
+#if ((DFM_CFG_CRASH_SEEN_TABLE_SIZE) > 0)
+	uint32_t ulSession;
+	uint32_t i;
+
+	if (szSessionId == (void*)0)
+	{
+		return;
+	}
+
+	prvCrashSeenTableValidate();
+
+	ulSession = prvCalculateSessionHash(szSessionId);
+
+	for (i = 0; i < (DFM_CFG_CRASH_SEEN_TABLE_SIZE); i++)
+	{
+		if ((xCrashSeenTable.xEntries[i].ulCount != 0) && (xCrashSeenTable.xEntries[i].ulDelivered == 0) &&
+			(xCrashSeenTable.xEntries[i].ulSession == ulSession) && (xCrashSeenTable.xEntries[i].ulAlertId == ulAlertId))
+		{
+			xCrashSeenTable.xEntries[i].ulDelivered = 1;
+			prvCrashSeenTableUpdateChecksum();
+			break;
+		}
+	}
+#else
+	(void)szSessionId;
+	(void)ulAlertId;
+#endif
+}
+
 /* Called by gcc stack-checking code when using the gcc option -fstack-protector-strong */
 void __stack_chk_fail(void)
 {
@@ -53,7 +53,7 @@ static DfmEntryData_t* pxDfmEntryData = (void*)0;
 
 static DfmResult_t prvDfmEntryVerify(DfmEntryHandle_t xEntryHandle);
 static uint32_t prvDfmEntryGetHeaderSize(void);
-static DfmResult_t prvDfmEntrySetup(uint16_t usType, uint16_t usEntryId, uint16_t usChunkIndex, uint16_t usChunkCount, uint32_t ulDescriptionSize, const char* szDescription, void* pvData, uint32_t ulDataSize, DfmEntryHandle_t* pxEntryHandle);
+static DfmResult_t prvDfmEntrySetup(uint16_t usType, uint16_t usEntryId, uint16_t usChunkIndex, uint16_t usChunkCount, uint32_t ulDescriptionSize, const char* szDescription, void* pvData, uint32_t ulDataSize, DfmPayloadReadCallback_t xReadCallback, uint32_t ulReadOffset, DfmEntryHandle_t* pxEntryHandle);
 
 /* This function is only used to get around constant "if" condition */
 static uint32_t prvDfmEntryGetHeaderSize(void)
@@ -125,7 +125,7 @@ static DfmResult_t prvDfmEntryVerify(DfmEntryHandle_t xEntryHandle)
 	return DFM_SUCCESS;
 }
 
-static DfmResult_t prvDfmEntrySetup(uint16_t usType, uint16_t usEntryId, uint16_t usChunkIndex, uint16_t usChunkCount, uint32_t ulDescriptionSize, const char* szDescription, void* pvData, uint32_t ulDataSize, DfmEntryHandle_t* pxEntryHandle)
+static DfmResult_t prvDfmEntrySetup(uint16_t usType, uint16_t usEntryId, uint16_t usChunkIndex, uint16_t usChunkCount, uint32_t ulDescriptionSize, const char* szDescription, void* pvData, uint32_t ulDataSize, DfmPayloadReadCallback_t xReadCallback, uint32_t ulReadOffset, DfmEntryHandle_t* pxEntryHandle)
 {
 	DfmEntryHeader_t* pxEntryHeader = (DfmEntryHeader_t*)pxDfmEntryData->buffer; /*cstat !MISRAC2012-Rule-11.3 We convert the untyped buffer to something we can work with. We can't use an exact type since the buffer may need to contain bigger Entries that haven been previously stored*/
 	char* szSessionId = (void*)0;
@@ -143,7 +143,8 @@ static DfmResult_t prvDfmEntrySetup(uint16_t usType, uint16_t usEntryId, uint16_
 		return DFM_FAIL;
 	}
 
-	if (pvData == (void*)0)
+	/* The data is either copied from pvData or read using xReadCallback */
+	if ((pvData == (void*)0) && (xReadCallback == 0))
 	{
 		return DFM_FAIL;
 	}
@@ -218,7 +219,17 @@ static DfmResult_t prvDfmEntrySetup(uint16_t usType, uint16_t usEntryId, uint16_
 	ulOffset += ulDescriptionSize;
 	
 	/* Write Data after Description */
-	(void)memcpy((void*)((uintptr_t)pxDfmEntryData->buffer + ulOffset), pvData, ulDataSize); /*cstat !MISRAC2012-Rule-11.6 We need to write the Entry data to the buffer with an offset*/
+	if (xReadCallback != 0)
+	{
+		if (xReadCallback(ulReadOffset, (void*)((uintptr_t)pxDfmEntryData->buffer + ulOffset), ulDataSize) == DFM_FAIL) /*cstat !MISRAC2012-Rule-11.6 We need to write the Entry data to the buffer with an offset*/
+		{
+			return DFM_FAIL;
+		}
+	}
+	else
+	{
+		(void)memcpy((void*)((uintptr_t)pxDfmEntryData->buffer + ulOffset), pvData, ulDataSize); /*cstat !MISRAC2012-Rule-11.6 We need to write the Entry data to the buffer with an offset*/
+	}
 
 	ulOffset += ulDataSize;
 	
@@ -317,7 +328,7 @@ DfmResult_t xDfmEntryCreateAlert(DfmAlertHandle_t xAlertHandle, DfmEntryHandle_t
 		return DFM_FAIL;
 	}
 
-	if (prvDfmEntrySetup((uint16_t)(DFM_ENTRY_TYPE_ALERT), (uint16_t)0, (uint16_t)1, (uint16_t)1, (uint32_t)(DFM_DESCRIPTION_MAX_LEN), szDescription, (void*)xAlertHandle, sizeof(DfmAlert_t), pxEntryHandle) == DFM_FAIL)
+	if (prvDfmEntrySetup((uint16_t)(DFM_ENTRY_TYPE_ALERT), (uint16_t)0, (uint16_t)1, (uint16_t)1, (uint32_t)(DFM_DESCRIPTION_MAX_LEN), szDescription, (void*)xAlertHandle, sizeof(DfmAlert_t), 0, 0UL, pxEntryHandle) == DFM_FAIL)
 	{
 		return DFM_FAIL;
 	}
@@ -390,7 +401,7 @@ DfmResult_t xDfmEntryCreatePayloadHeader(DfmAlertHandle_t xAlertHandle, uint16_t
 	xPayloadHeader.ucEndMarkers[3] = 0x50;
 	xPayloadHeader.ulChecksum = 0;
 
-	if (prvDfmEntrySetup((uint16_t)(DFM_ENTRY_TYPE_PAYLOAD_HEADER), usEntryId, (uint16_t)1, (uint16_t)1, (uint32_t)(DFM_PAYLOAD_DESCRIPTION_MAX_LEN), szDescription, &xPayloadHeader, sizeof(xPayloadHeader), pxEntryHandle) == DFM_FAIL)
+	if (prvDfmEntrySetup((uint16_t)(DFM_ENTRY_TYPE_PAYLOAD_HEADER), usEntryId, (uint16_t)1, (uint16_t)1, (uint32_t)(DFM_PAYLOAD_DESCRIPTION_MAX_LEN), szDescription, &xPayloadHeader, sizeof(xPayloadHeader), 0, 0UL, pxEntryHandle) == DFM_FAIL)
 	{
 		return DFM_FAIL;
 	}
@@ -415,7 +426,42 @@ DfmResult_t xDfmEntryCreatePayloadChunk(DfmAlertHandle_t xAlertHandle, uint16_t
 		return DFM_FAIL;
 	}
 	
-	if (prvDfmEntrySetup((uint16_t)(DFM_ENTRY_TYPE_PAYLOAD), usEntryId, usChunkIndex, usChunkCount, (uint32_t)(DFM_PAYLOAD_DESCRIPTION_MAX_LEN), szDescription, pvPayload, ulSize, pxEntryHandle) == DFM_FAIL)
+	if (prvDfmEntrySetup((uint16_t)(DFM_ENTRY_TYPE_PAYLOAD), usEntryId, usChunkIndex, usChunkCount, (uint32_t)(DFM_PAYLOAD_DESCRIPTION_MAX_LEN), szDescription, pvPayload, ulSize, 0, 0UL, pxEntryHandle) == DFM_FAIL)
+	{
+		return DFM_FAIL;
+	}
+
+	return DFM_SUCCESS;
+}
+
+DfmResult_t xDfmEntryCreatePayloadChunkFromCallback(DfmAlertHandle_t xAlertHandle, uint16_t usEntryId, uint16_t usChunkIndex, uint16_t usChunkCount, DfmPayloadReadCallback_t xReadCallback, uint32_t ulOffset, uint32_t ulSize, char* szDescription, DfmEntryHandle_t* pxEntryHandle)
+{
+	if (pxDfmEntryData == (void*)0)
+	{
+		return DFM_FAIL;
+	}
+
+	if (pxDfmEntryData->ulInitialized == 0UL)
+	{
+		return DFM_FAIL;
+	}
+
+	if (xAlertHandle == 0)
+	{
+		return DFM_FAIL;
+	}
+
+	if (xReadCallback == 0)
+	{
+		return DFM_FAIL;
+	}
+
+	if (ulSize > (uint32_t)(DFM_CFG_MAX_PAYLOAD_CHUNK_SIZE))
+	{
+		return DFM_FAIL;
+	}
+
+	if (prvDfmEntrySetup((uint16_t)(DFM_ENTRY_TYPE_PAYLOAD), usEntryId, usChunkIndex, usChunkCount, (uint32_t)(DFM_PAYLOAD_DESCRIPTION_MAX_LEN), szDescription, (void*)0, ulSize, xReadCallback, ulOffset, pxEntryHandle) == DFM_FAIL)
 	{
 		return DFM_FAIL;
 	}
@@ -17,6 +17,37 @@
 #define DFM_RETAINED_MEMORY_TYPE_ALERT 0x341562AB
 #define DFM_RETAINED_MEMORY_TYPE_PAYLOAD 0xE78BAC01
 
+#define DFM_RETAINED_MEMORY_RECORD_MARKER 0x52444644 /* "DFDR" */
+#define DFM_RETAINED_MEMORY_NO_RECORD 0xFFFFFFFFUL
+#define DFM_RETAINED_MEMORY_CRC_INIT 0xFFFFFFFFUL
+
+/*
+ * The retained memory is divided into DFM_CFG_RETAINED_MEMORY_RECORDS records of DFM_CFG_RETAINED_MEMORY_RECORD_SIZE
+ * bytes. Each record starts with two copies of the record header, followed by the entries of one alert, each entry
+ * preceded by its meta data.
+ *
+ * Entries are appended after the committed data and the header is then written to the copy not holding the latest
+ * version. A reset in the middle of a write therefore leaves the other copy, describing the data committed before,
+ * intact. A new record is started by invalidating both copies before any data is written.
+ */
+typedef struct DfmRetainedMemoryRecordHeader
+{
+	uint32_t ulMarker;
+	uint32_t ulSequence;
+	uint32_t ulVersion;
+	uint32_t ulPriority;
+	uint32_t ulSize;
+	uint32_t ulDataCrc;
+	uint32_t ulHeaderCrc;
+} DfmRetainedMemoryRecordHeader_t;
+
+#define DFM_RETAINED_MEMORY_RECORD_DATA_OFFSET (2UL * sizeof(DfmRetainedMemoryRecordHeader_t))
+#define DFM_RETAINED_MEMORY_RECORD_DATA_SIZE ((uint32_t)(DFM_CFG_RETAINED_MEMORY_RECORD_SIZE) - DFM_RETAINED_MEMORY_RECORD_DATA_OFFSET)
+
+#if ((DFM_CFG_RETAINED_MEMORY_RECORD_SIZE) <= 256)
+#error "DFM_CFG_RETAINED_MEMORY_RECORD_SIZE is too small"
+#endif
+
 static DfmRetainedMemoryData_t* pxRetainedMemoryData;
 
 typedef struct DfmRetainedMemoryMetaData
@@ -25,108 +56,382 @@ typedef struct DfmRetainedMemoryMetaData
 	uint32_t ulSize;
 } DfmRetainedMemoryMetaData_t;
 
+static uint32_t prvRetainedMemoryCrc(uint32_t ulCrc, const void* pvData, uint32_t ulSize);
+static uint32_t prvRetainedMemoryRecordOffset(uint32_t ulRecord);
+static DfmResult_t prvRetainedMemoryCheckHeader(uint32_t ulRecord, DfmRetainedMemoryRecordHeader_t* pxHeader);
+static DfmResult_t prvRetainedMemoryReadHeader(uint32_t ulRecord, DfmRetainedMemoryRecordHeader_t* pxHeader);
+static DfmResult_t prvRetainedMemoryInvalidate(uint32_t ulRecord);
+static DfmResult_t prvRetainedMemoryCommit(void);
+static uint32_t prvRetainedMemorySelectRecord(uint32_t ulPriority);
 static DfmResult_t prvRetainedMemoryWrite(uint32_t ulType, DfmEntryHandle_t xEntryHandle);
 static DfmResult_t prvRetainedMemoryRead(uint32_t ulType, void* pvBuffer, uint32_t ulBufferSize);
 
+/* CRC-32 (reflected, polynomial 0xEDB88320) without the final inversion, so it can be continued */
+static uint32_t prvRetainedMemoryCrc(uint32_t ulCrc, const void* pvData, uint32_t ulSize)
+{
+	const uint8_t* pucData = (const uint8_t*)pvData;
+	uint32_t i;
+	uint32_t j;
+
+	for (i = 0; i < ulSize; i++)
+	{
+		ulCrc ^= (uint32_t)pucData[i];
+
+		for (j = 0; j < 8UL; j++)
+		{
+			ulCrc = (ulCrc >> 1) ^ (0xEDB88320UL & (0UL - (ulCrc & 1UL)));
+		}
+	}
+
+	return ulCrc;
+}
+
+static uint32_t prvRetainedMemoryRecordOffset(uint32_t ulRecord)
+{
+	return ulRecord * (uint32_t)(DFM_CFG_RETAINED_MEMORY_RECORD_SIZE);
+}
+
+/* Checks a header copy and the data it describes */
+static DfmResult_t prvRetainedMemoryCheckHeader(uint32_t ulRecord, DfmRetainedMemoryRecordHeader_t* pxHeader)
+{
+	uint32_t ulBuffer[16];
+	uint32_t ulCrc = DFM_RETAINED_MEMORY_CRC_INIT;
+	uint32_t ulOffset = 0;
+	uint32_t ulReadSize;
+
+	if (pxHeader->ulMarker != (uint32_t)(DFM_RETAINED_MEMORY_RECORD_MARKER))
+	{
+		return DFM_FAIL;
+	}
+
+	if (pxHeader->ulHeaderCrc != prvRetainedMemoryCrc(DFM_RETAINED_MEMORY_CRC_INIT, pxHeader, sizeof(DfmRetainedMemoryRecordHeader_t) - sizeof(uint32_t)))
+	{
+		return DFM_FAIL;
+	}
+
+	if ((pxHeader->ulSequence == 0UL) || (pxHeader->ulSize > DFM_RETAINED_MEMORY_RECORD_DATA_SIZE))
+	{
+		return DFM_FAIL;
+	}
+
+	while (ulOffset < pxHeader->ulSize)
+	{
+		ulReadSize = pxHeader->ulSize - ulOffset;
+		if (ulReadSize > sizeof(ulBuffer))
+		{
+			ulReadSize = sizeof(ulBuffer);
+		}
+
+		if (xDfmRetainedMemoryPortRead(ulBuffer, ulReadSize, prvRetainedMemoryRecordOffset(ulRecord) + DFM_RETAINED_MEMORY_RECORD_DATA_OFFSET + ulOffset) == DFM_FAIL)
+		{
+			return DFM_FAIL;
+		}
+
+		ulCrc = prvRetainedMemoryCrc(ulCrc, ulBuffer, ulReadSize);
+		ulOffset += ulReadSize;
+	}
+
+	if (ulCrc != pxHeader->ulDataCrc)
+	{
+		return DFM_FAIL;
+	}
+
+	return DFM_SUCCESS;
+}
+
+/* Gets the latest valid header copy of a record */
+static DfmResult_t prvRetainedMemoryReadHeader(uint32_t ulRecord, DfmRetainedMemoryRecordHeader_t* pxHeader)
+{
+	DfmRetainedMemoryRecordHeader_t xHeaders[2];
+	uint32_t ulFirst;
+	uint32_t i;
+
+	for (i = 0; i < 2UL; i++)
+	{
+		if (xDfmRetainedMemoryPortRead(&xHeaders[i], sizeof(DfmRetainedMemoryRecordHeader_t), prvRetainedMemoryRecordOffset(ulRecord) + i * sizeof(DfmRetainedMemoryRecordHeader_t)) == DFM_FAIL)
+		{
+			return DFM_FAIL;
+		}
+	}
+
+	/* Try the copy with the highest version first, it is the torn one if a reset happened while writing it */
+	ulFirst = (xHeaders[1].ulVersion > xHeaders[0].ulVersion) ? 1UL : 0UL;
+
+	for (i = 0; i < 2UL; i++)
+	{
+		if (prvRetainedMemoryCheckHeader(ulRecord, &xHeaders[ulFirst ^ i]) == DFM_SUCCESS)
+		{
+			*pxHeader = xHeaders[ulFirst ^ i];
+
+			return DFM_SUCCESS;
+		}
+	}
+
+	return DFM_FAIL;
+}
+
+static DfmResult_t prvRetainedMemoryInvalidate(uint32_t ulRecord)
+{
+	DfmRetainedMemoryRecordHeader_t xHeaders[2] = { 0 };
+	DfmRetainedMemoryRecordHeader_t xHeader = { 0 };
+	uint32_t ulFirst;
+	uint32_t i;
+
+	(void)xDfmRetainedMemoryPortRead(xHeaders, sizeof(xHeaders), prvRetainedMemoryRecordOffset(ulRecord));
+
+	/* Clear the older copy first, so a reset in between leaves the complete record rather than a shorter version of it */
+	ulFirst = (xHeaders[1].ulVersion < xHeaders[0].ulVersion) ? 1UL : 0UL;
+
+	for (i = 0; i < 2UL; i++)
+	{
+		if (xDfmRetainedMemoryPortWrite(&xHeader, sizeof(DfmRetainedMemoryRecordHeader_t), prvRetainedMemoryRecordOffset(ulRecord) + (ulFirst ^ i) * sizeof(DfmRetainedMemoryRecordHeader_t)) == DFM_FAIL)
+		{
+			return DFM_FAIL;
+		}
+	}
+
+	pxRetainedMemoryData->xRecords[ulRecord].ulSequence = 0;
+
+	return DFM_SUCCESS;
+}
+
+/* Writes the header describing the data written so far to the copy not holding the previous version */
+static DfmResult_t prvRetainedMemoryCommit(void)
+{
+	DfmRetainedMemoryRecordHeader_t xHeader;
+
+	xHeader.ulMarker = DFM_RETAINED_MEMORY_RECORD_MARKER;
+	xHeader.ulSequence = pxRetainedMemoryData->ulWriteSequence;
+	xHeader.ulVersion = pxRetainedMemoryData->ulWriteVersion + 1UL;
+	xHeader.ulPriority = pxRetainedMemoryData->ulWritePriority;
+	xHeader.ulSize = pxRetainedMemoryData->ulWriteSize;
+	xHeader.ulDataCrc = pxRetainedMemoryData->ulWriteCrc;
+	xHeader.ulHeaderCrc = prvRetainedMemoryCrc(DFM_RETAINED_MEMORY_CRC_INIT, &xHeader, sizeof(DfmRetainedMemoryRecordHeader_t) - sizeof(uint32_t));
+
+	if (xDfmRetainedMemoryPortWrite(&xHeader, sizeof(DfmRetainedMemoryRecordHeader_t), prvRetainedMemoryRecordOffset(pxRetainedMemoryData->ulWriteRecord) + (xHeader.ulVersion & 1UL) * sizeof(DfmRetainedMemoryRecordHeader_t)) == DFM_FAIL)
+	{
+		return DFM_FAIL;
+	}
+
+	pxRetainedMemoryData->ulWriteVersion = xHeader.ulVersion;
+
+	return DFM_SUCCESS;
+}
+
+/* Returns a free record, or the record to replace according to DFM_CFG_RETAINED_MEMORY_STRATEGY */
+static uint32_t prvRetainedMemorySelectRecord(uint32_t ulPriority)
+{
+	DfmRetainedMemoryRecordInfo_t* pxRecords = pxRetainedMemoryData->xRecords;
+	uint32_t ulOldest = 0;
+	uint32_t ulLowest = 0;
+	uint32_t i;
+
+	for (i = 0; i < (uint32_t)(DFM_CFG_RETAINED_MEMORY_RECORDS); i++)
+	{
+		if (pxRecords[i].ulSequence == 0UL)
+		{
+			return i;
+		}
+
+		if (pxRecords[i].ulSequence < pxRecords[ulOldest].ulSequence)
+		{
+			ulOldest = i;
+		}
+
+		if ((pxRecords[i].ulPriority < pxRecords[ulLowest].ulPriority) ||
+			((pxRecords[i].ulPriority == pxRecords[ulLowest].ulPriority) && (pxRecords[i].ulSequence < pxRecords[ulLowest].ulSequence)))
+		{
+			ulLowest = i;
+		}
+	}
+
+	switch ((DfmRetainedMemoryStrategy_t)(DFM_CFG_RETAINED_MEMORY_STRATEGY))
+	{
+	case DFM_RETAINED_MEMORY_STRATEGY_OVERWRITE:
+		return ulOldest;
+	case DFM_RETAINED_MEMORY_STRATEGY_PRIORITY:
+		if (pxRecords[ulLowest].ulPriority < ulPriority)
+		{
+			return ulLowest;
+		}
+		break;
+	default:
+		break;
+	}
+
+	return DFM_RETAINED_MEMORY_NO_RECORD;
+}
+
 static DfmResult_t prvRetainedMemoryWrite(uint32_t ulType, DfmEntryHandle_t xEntryHandle)
 {
 	DfmRetainedMemoryMetaData_t xRetainedMemoryMetaData;
-	
+	uint32_t ulWriteOffset;
+
 	if (pxRetainedMemoryData == (void*) 0)
 	{
 		return DFM_FAIL;
 	}
-	
+
 	if (pxRetainedMemoryData->ulInitialized == 0)
 	{
 		return DFM_FAIL;
 	}
-	
+
+	if (pxRetainedMemoryData->ulWriteRecord == DFM_RETAINED_MEMORY_NO_RECORD)
+	{
+		return DFM_FAIL;
+	}
+
 	if (xEntryHandle == 0)
 	{
 		return DFM_FAIL;
 	}
-	
+
 	xRetainedMemoryMetaData.ulType = ulType;
 	if (xDfmEntryGetSize(xEntryHandle, &xRetainedMemoryMetaData.ulSize) == DFM_FAIL)
 	{
 		return DFM_FAIL;
 	}
-	
+
 	if (xRetainedMemoryMetaData.ulSize == 0)
 	{
 		return DFM_FAIL;
 	}
-	
+
+	if (pxRetainedMemoryData->ulWriteSize + sizeof(DfmRetainedMemoryMetaData_t) + xRetainedMemoryMetaData.ulSize > DFM_RETAINED_MEMORY_RECORD_DATA_SIZE)
+	{
+		/* There's not enough space left in the record */
+		return DFM_FAIL;
+	}
+
+	ulWriteOffset = prvRetainedMemoryRecordOffset(pxRetainedMemoryData->ulWriteRecord) + DFM_RETAINED_MEMORY_RECORD_DATA_OFFSET + pxRetainedMemoryData->ulWriteSize;
+
 	/* Write the meta data */
-	if (xDfmRetainedMemoryPortWrite((uint8_t*)&xRetainedMemoryMetaData, sizeof(DfmRetainedMemoryMetaData_t), pxRetainedMemoryData->ulWriteOffset) == DFM_FAIL)
+	if (xDfmRetainedMemoryPortWrite((uint8_t*)&xRetainedMemoryMetaData, sizeof(DfmRetainedMemoryMetaData_t), ulWriteOffset) == DFM_FAIL)
 	{
 		return DFM_FAIL;
 	}
-	
-	pxRetainedMemoryData->ulWriteOffset += sizeof(DfmRetainedMemoryMetaData_t);
 
 	/* Write the data */
-	if (xDfmRetainedMemoryPortWrite((uint8_t*)xEntryHandle, xRetainedMemoryMetaData.ulSize, pxRetainedMemoryData->ulWriteOffset) == DFM_FAIL)
+	if (xDfmRetainedMemoryPortWrite((uint8_t*)xEntryHandle, xRetainedMemoryMetaData.ulSize, ulWriteOffset + sizeof(DfmRetainedMemoryMetaData_t)) == DFM_FAIL)
 	{
 		return DFM_FAIL;
 	}
-	
-	pxRetainedMemoryData->ulWriteOffset += xRetainedMemoryMetaData.ulSize;
-	
-	return DFM_SUCCESS;
+
+	pxRetainedMemoryData->ulWriteCrc = prvRetainedMemoryCrc(pxRetainedMemoryData->ulWriteCrc, &xRetainedMemoryMetaData, sizeof(DfmRetainedMemoryMetaData_t));
+	pxRetainedMemoryData->ulWriteCrc = prvRetainedMemoryCrc(pxRetainedMemoryData->ulWriteCrc, (void*)xEntryHandle, xRetainedMemoryMetaData.ulSize);
+	pxRetainedMemoryData->ulWriteSize += sizeof(DfmRetainedMemoryMetaData_t) + xRetainedMemoryMetaData.ulSize;
+
+	/* The entry is only part of the record once the header says so */
+	return prvRetainedMemoryCommit();
 }
 
 static DfmResult_t prvRetainedMemoryRead(uint32_t ulType, void* pvBuffer, uint32_t ulBufferSize)
 {
 	DfmRetainedMemoryMetaData_t xRetainedMemoryMetaData;
-	
+	uint32_t ulReadOffset;
+
+	if (pxRetainedMemoryData->ulReadRecord == DFM_RETAINED_MEMORY_NO_RECORD)
+	{
+		return DFM_FAIL;
+	}
+
+	if (pxRetainedMemoryData->ulReadOffset + sizeof(DfmRetainedMemoryMetaData_t) > pxRetainedMemoryData->ulReadSize)
+	{
+		/* No more entries in this record */
+		return DFM_FAIL;
+	}
+
+	ulReadOffset = prvRetainedMemoryRecordOffset(pxRetainedMemoryData->ulReadRecord) + DFM_RETAINED_MEMORY_RECORD_DATA_OFFSET + pxRetainedMemoryData->ulReadOffset;
+
 	/* Read the metadata */
-	if (xDfmRetainedMemoryPortRead(&xRetainedMemoryMetaData, sizeof(DfmRetainedMemoryMetaData_t), pxRetainedMemoryData->ulReadOffset) == DFM_FAIL)
+	if (xDfmRetainedMemoryPortRead(&xRetainedMemoryMetaData, sizeof(DfmRetainedMemoryMetaData_t), ulReadOffset) == DFM_FAIL)
 	{
 		return DFM_FAIL;
 	}
-	
+
 	if (xRetainedMemoryMetaData.ulType != ulType)
 	{
 		return DFM_FAIL;
 	}
-	
+
 	if (xRetainedMemoryMetaData.ulSize <= 0)
 	{
 		return DFM_FAIL;
 	}
-	
+
 	if (xRetainedMemoryMetaData.ulSize > ulBufferSize)
 	{
 		return DFM_FAIL;
 	}
-	
-	pxRetainedMemoryData->ulReadOffset += sizeof(DfmRetainedMemoryMetaData_t);
+
+	if (xRetainedMemoryMetaData.ulSize > pxRetainedMemoryData->ulReadSize - pxRetainedMemoryData->ulReadOffset - sizeof(DfmRetainedMemoryMetaData_t))
+	{
+		return DFM_FAIL;
+	}
 
 	/* Read the data */
-	if (xDfmRetainedMemoryPortRead(pvBuffer, xRetainedMemoryMetaData.ulSize, pxRetainedMemoryData->ulReadOffset) != 0)
+	if (xDfmRetainedMemoryPortRead(pvBuffer, xRetainedMemoryMetaData.ulSize, ulReadOffset + sizeof(DfmRetainedMemoryMetaData_t)) == DFM_FAIL)
 	{
 		return DFM_FAIL;
 	}
-	
-	pxRetainedMemoryData->ulReadOffset += xRetainedMemoryMetaData.ulSize;
-	
+
+	pxRetainedMemoryData->ulReadOffset += sizeof(DfmRetainedMemoryMetaData_t) + xRetainedMemoryMetaData.ulSize;
+
 	return DFM_SUCCESS;
 }
 
 DfmResult_t xDfmRetainedMemoryInitialize(DfmRetainedMemoryData_t *pxBuffer)
 {
+	DfmRetainedMemoryRecordHeader_t xHeader;
+	uint32_t ulPending = 0;
+	uint32_t i;
+
 	pxRetainedMemoryData = pxBuffer;
 
-	pxRetainedMemoryData->ulWriteOffset = 0;
-	pxRetainedMemoryData->ulReadOffset = 0;
+	pxRetainedMemoryData->ulInitialized = 0;
+	pxRetainedMemoryData->ulNextSequence = 1;
+	pxRetainedMemoryData->ulWriteRecord = DFM_RETAINED_MEMORY_NO_RECORD;
+	pxRetainedMemoryData->ulReadRecord = DFM_RETAINED_MEMORY_NO_RECORD;
+	pxRetainedMemoryData->ulReadSequence = 0;
 
 	if (xDfmRetainedMemoryPortInitialize(&pxRetainedMemoryData->xRetainedMemoryPortData) == DFM_FAIL)
 	{
 		return DFM_FAIL;
 	}
 
+	/* Find the records that were completely written before the reset */
+	for (i = 0; i < (uint32_t)(DFM_CFG_RETAINED_MEMORY_RECORDS); i++)
+	{
+		pxRetainedMemoryData->xRecords[i].ulSequence = 0;
+		pxRetainedMemoryData->xRecords[i].ulPriority = 0;
+
+		if (xDfmRetainedMemoryPortHasData() == 0)
+		{
+			continue;
+		}
+
+		if (prvRetainedMemoryReadHeader(i, &xHeader) == DFM_FAIL)
+		{
+			continue;
+		}
+
+		pxRetainedMemoryData->xRecords[i].ulSequence = xHeader.ulSequence;
+		pxRetainedMemoryData->xRecords[i].ulPriority = xHeader.ulPriority;
+
+		if (xHeader.ulSequence >= pxRetainedMemoryData->ulNextSequence)
+		{
+			pxRetainedMemoryData->ulNextSequence = xHeader.ulSequence + 1UL;
+		}
+
+		ulPending++;
+	}
+
+	if (ulPending > 0UL)
+	{
+		DFM_DEBUG_PRINT("DFM: Found alerts in retained memory\n");
+	}
+
 	pxRetainedMemoryData->ulInitialized = 1;
 
 	return DFM_SUCCESS;
@@ -134,29 +439,115 @@ DfmResult_t xDfmRetainedMemoryInitialize(DfmRetainedMemoryData_t *pxBuffer)
 
 DfmResult_t xDfmRetainedMemoryWriteAlert(DfmEntryHandle_t xEntryHandle)
 {
-	pxRetainedMemoryData->ulWriteOffset = 0;
-	pxRetainedMemoryData->ulReadOffset = 0;
-	
-	if (xDfmRetainedMemoryPortClear() == DFM_FAIL)
+	DfmAlert_t* pxAlert = (void*)0;
+	uint32_t ulRecord;
+
+	if (pxRetainedMemoryData == (void*) 0)
+	{
+		return DFM_FAIL;
+	}
+
+	if (pxRetainedMemoryData->ulInitialized == 0)
+	{
+		return DFM_FAIL;
+	}
+
+	/* Payload chunks can only be added to this alert from now on */
+	pxRetainedMemoryData->ulWriteRecord = DFM_RETAINED_MEMORY_NO_RECORD;
+
+	if (xDfmEntryGetData(xEntryHandle, (void**)&pxAlert) == DFM_FAIL)
 	{
 		return DFM_FAIL;
 	}
 
-	return prvRetainedMemoryWrite(DFM_RETAINED_MEMORY_TYPE_ALERT, xEntryHandle);
+	pxRetainedMemoryData->ulWritePriority = (uint32_t)(DFM_CFG_RETAINED_MEMORY_PRIORITY(pxAlert->ulAlertType));
+
+	ulRecord = prvRetainedMemorySelectRecord(pxRetainedMemoryData->ulWritePriority);
+	if (ulRecord == DFM_RETAINED_MEMORY_NO_RECORD)
+	{
+		DFM_DEBUG_PRINT("DFM: Retained memory full, alert skipped\n");
+		return DFM_FAIL;
+	}
+
+	if (prvRetainedMemoryInvalidate(ulRecord) == DFM_FAIL)
+	{
+		return DFM_FAIL;
+	}
+
+	pxRetainedMemoryData->ulWriteRecord = ulRecord;
+	pxRetainedMemoryData->ulWriteSequence = pxRetainedMemoryData->ulNextSequence;
+	pxRetainedMemoryData->ulWriteVersion = 0;
+	pxRetainedMemoryData->ulWriteSize = 0;
+	pxRetainedMemoryData->ulWriteCrc = DFM_RETAINED_MEMORY_CRC_INIT;
+	pxRetainedMemoryData->ulNextSequence++;
+
+	if (prvRetainedMemoryWrite(DFM_RETAINED_MEMORY_TYPE_ALERT, xEntryHandle) == DFM_FAIL)
+	{
+		pxRetainedMemoryData->ulWriteRecord = DFM_RETAINED_MEMORY_NO_RECORD;
+		return DFM_FAIL;
+	}
+
+	pxRetainedMemoryData->xRecords[ulRecord].ulSequence = pxRetainedMemoryData->ulWriteSequence;
+	pxRetainedMemoryData->xRecords[ulRecord].ulPriority = pxRetainedMemoryData->ulWritePriority;
+
+	return DFM_SUCCESS;
 }
 
 DfmResult_t xDfmRetainedMemoryReadAlert(void* pvBuffer, uint32_t ulBufferSize)
 {
-	pxRetainedMemoryData->ulWriteOffset = 0;
-	pxRetainedMemoryData->ulReadOffset = 0;
+	DfmRetainedMemoryRecordHeader_t xHeader;
+	uint32_t ulRecord;
+	uint32_t i;
+
+	if (pxRetainedMemoryData == (void*) 0)
+	{
+		return DFM_FAIL;
+	}
 
-	/* We only check this on Read Alert since Read Payload will not be called if there is no Alert */
-	if (xDfmRetainedMemoryPortHasData() == 0)
+	if (pxRetainedMemoryData->ulInitialized == 0)
 	{
 		return DFM_FAIL;
 	}
 
-	return prvRetainedMemoryRead(DFM_RETAINED_MEMORY_TYPE_ALERT, pvBuffer, ulBufferSize);
+	while (1)
+	{
+		pxRetainedMemoryData->ulReadRecord = DFM_RETAINED_MEMORY_NO_RECORD;
+
+		/* The oldest record not read yet */
+		ulRecord = DFM_RETAINED_MEMORY_NO_RECORD;
+		for (i = 0; i < (uint32_t)(DFM_CFG_RETAINED_MEMORY_RECORDS); i++)
+		{
+			if (pxRetainedMemoryData->xRecords[i].ulSequence <= pxRetainedMemoryData->ulReadSequence)
+			{
+				continue;
+			}
+
+			if ((ulRecord == DFM_RETAINED_MEMORY_NO_RECORD) || (pxRetainedMemoryData->xRecords[i].ulSequence < pxRetainedMemoryData->xRecords[ulRecord].ulSequence))
+			{
+				ulRecord = i;
+			}
+		}
+
+		if (ulRecord == DFM_RETAINED_MEMORY_NO_RECORD)
+		{
+			return DFM_FAIL;
+		}
+
+		pxRetainedMemoryData->ulReadSequence = pxRetainedMemoryData->xRecords[ulRecord].ulSequence;
+
+		if (prvRetainedMemoryReadHeader(ulRecord, &xHeader) == DFM_FAIL)
+		{
+			/* Corrupted since it was written, skip it */
+			pxRetainedMemoryData->xRecords[ulRecord].ulSequence = 0;
+			continue;
+		}
+
+		pxRetainedMemoryData->ulReadRecord = ulRecord;
+		pxRetainedMemoryData->ulReadOffset = 0;
+		pxRetainedMemoryData->ulReadSize = xHeader.ulSize;
+
+		return prvRetainedMemoryRead(DFM_RETAINED_MEMORY_TYPE_ALERT, pvBuffer, ulBufferSize);
+	}
 }
 
 DfmResult_t xDfmRetainedMemoryWritePayloadChunk(DfmEntryHandle_t xEntryHandle)
@@ -168,13 +559,301 @@ DfmResult_t xDfmRetainedMemoryReadPayloadChunk(char* szSessionId, uint32_t ulAle
 {
 	(void)szSessionId;
 	(void)ulAlertId;
-	
+
+	if (pxRetainedMemoryData == (void*) 0)
+	{
+		return DFM_FAIL;
+	}
+
+	if (pxRetainedMemoryData->ulInitialized == 0)
+	{
+		return DFM_FAIL;
+	}
+
 	return prvRetainedMemoryRead(DFM_RETAINED_MEMORY_TYPE_PAYLOAD, pvBuffer, ulBufferSize);
 }
 
 DfmResult_t xDfmRetainedMemoryClear(void)
 {
+	uint32_t i;
+
+	if (pxRetainedMemoryData != (void*) 0)
+	{
+		for (i = 0; i < (uint32_t)(DFM_CFG_RETAINED_MEMORY_RECORDS); i++)
+		{
+			pxRetainedMemoryData->xRecords[i].ulSequence = 0;
+		}
+
+		pxRetainedMemoryData->ulWriteRecord = DFM_RETAINED_MEMORY_NO_RECORD;
+		pxRetainedMemoryData->ulReadRecord = DFM_RETAINED_MEMORY_NO_RECORD;
+		pxRetainedMemoryData->ulReadSequence = 0;
+	}
+
 	return xDfmRetainedMemoryPortClear();
 }
 
+#if (INCLUDE_RETAINED_MEMORY_TESTS == 1)
+
+static uint32_t ulRetainedMemoryTestErrors = 0;
+
+static DfmResult_t prvRetainedMemoryTestWrite(uint32_t ulAlertType, uint32_t ulPayloadChunks)
+{
+	static uint8_t ucPayload[64];
+	DfmAlertHandle_t xAlertHandle = 0;
+	DfmEntryHandle_t xEntryHandle = 0;
+	DfmResult_t xResult = DFM_FAIL;
+	uint32_t i;
+
+	if (xDfmAlertBegin(ulAlertType, "Retained Memory Test", &xAlertHandle) == DFM_FAIL)
+	{
+		return DFM_FAIL;
+	}
+
+	if (xDfmEntryCreateAlert(xAlertHandle, &xEntryHandle) == DFM_SUCCESS)
+	{
+		xResult = xDfmRetainedMemoryWriteAlert(xEntryHandle);
+	}
+
+	for (i = 0; (xResult == DFM_SUCCESS) && (i < ulPayloadChunks); i++)
+	{
+		ucPayload[0] = (uint8_t)i;
+		if (xDfmEntryCreatePayloadChunk(xAlertHandle, (uint16_t)1, (uint16_t)(i + 1UL), (uint16_t)ulPayloadChunks, ucPayload, sizeof(ucPayload), "test", &xEntryHandle) == DFM_FAIL)
+		{
+			xResult = DFM_FAIL;
+			break;
+		}
+
+		xResult = xDfmRetainedMemoryWritePayloadChunk(xEntryHandle);
+	}
+
+	(void)xDfmAlertReset(xAlertHandle);
+
+	return xResult;
+}
+
+/* Writes an alert and fills its record with payload chunks to within 8 bytes of the end, then checks that one more chunk is rejected */
+static DfmResult_t prvRetainedMemoryTestWriteFull(uint32_t ulAlertType, uint32_t* pulPayloadChunks)
+{
+	static uint8_t ucPayload[256];
+	DfmAlertHandle_t xAlertHandle = 0;
+	DfmEntryHandle_t xEntryHandle = 0;
+	DfmResult_t xResult = DFM_FAIL;
+	uint32_t ulEntrySize = 0;
+	uint32_t ulOverhead = 0;
+	uint32_t ulLeft;
+	uint32_t ulChunkSize;
+	uint32_t ulWriteSize;
+
+	*pulPayloadChunks = 0;
+
+	if (xDfmAlertBegin(ulAlertType, "Retained Memory Test", &xAlertHandle) == DFM_FAIL)
+	{
+		return DFM_FAIL;
+	}
+
+	if (xDfmEntryCreateAlert(xAlertHandle, &xEntryHandle) == DFM_SUCCESS)
+	{
+		xResult = xDfmRetainedMemoryWriteAlert(xEntryHandle);
+	}
+
+	/* The size of a payload chunk entry besides the payload itself */
+	if ((xResult == DFM_SUCCESS) && (xDfmEntryCreatePayloadChunk(xAlertHandle, (uint16_t)1, (uint16_t)1, (uint16_t)1, ucPayload, 1, "test", &xEntryHandle) == DFM_SUCCESS) && (xDfmEntryGetSize(xEntryHandle, &ulEntrySize) == DFM_SUCCESS))
+	{
+		ulOverhead = sizeof(DfmRetainedMemoryMetaData_t) + ulEntrySize - 1UL;
+	}
+	else
+	{
+		xResult = DFM_FAIL;
+	}
+
+	while (xResult == DFM_SUCCESS)
+	{
+		ulLeft = DFM_RETAINED_MEMORY_RECORD_DATA_SIZE - pxRetainedMemoryData->ulWriteSize;
+		if (ulLeft < 8UL)
+		{
+			break;
+		}
+
+		if (ulLeft < ulOverhead + 1UL + 4UL)
+		{
+			/* The record can't be filled to within 8 bytes from here */
+			xResult = DFM_FAIL;
+			break;
+		}
+
+		/* Aim for 4 bytes left, and don't leave a tail that is too small for the last chunk */
+		ulChunkSize = ulLeft - ulOverhead - 4UL;
+		if ((ulChunkSize > sizeof(ucPayload)) && (ulChunkSize - sizeof(ucPayload) < ulOverhead + 1UL))
+		{
+			ulChunkSize /= 2UL;
+		}
+		if (ulChunkSize > sizeof(ucPayload))
+		{
+			ulChunkSize = sizeof(ucPayload);
+		}
+
+		ucPayload[0] = (uint8_t)*pulPayloadChunks;
+		if (xDfmEntryCreatePayloadChunk(xAlertHandle, (uint16_t)1, (uint16_t)1, (uint16_t)1, ucPayload, ulChunkSize, "test", &xEntryHandle) == DFM_FAIL)
+		{
+			xResult = DFM_FAIL;
+			break;
+		}
+
+		xResult = xDfmRetainedMemoryWritePayloadChunk(xEntryHandle);
+		if (xResult == DFM_SUCCESS)
+		{
+			(*pulPayloadChunks)++;
+		}
+	}
+
+	printf("  %u payload chunks, %u bytes left in the record\n", (unsigned int)*pulPayloadChunks, (unsigned int)(DFM_RETAINED_MEMORY_RECORD_DATA_SIZE - pxRetainedMemoryData->ulWriteSize));
+
+	/* The smallest possible chunk doesn't fit anymore and must not be written past the end of the record */
+	if ((xResult == DFM_SUCCESS) && (xDfmEntryCreatePayloadChunk(xAlertHandle, (uint16_t)1, (uint16_t)1, (uint16_t)1, ucPayload, 1, "test", &xEntryHandle) == DFM_SUCCESS))
+	{
+		ulWriteSize = pxRetainedMemoryData->ulWriteSize;
+		if ((xDfmRetainedMemoryWritePayloadChunk(xEntryHandle) == DFM_SUCCESS) || (pxRetainedMemoryData->ulWriteSize != ulWriteSize))
+		{
+			xResult = DFM_FAIL;
+		}
+	}
+	else
+	{
+		xResult = DFM_FAIL;
+	}
+
+	(void)xDfmAlertReset(xAlertHandle);
+
+	return xResult;
+}
+
+/* Reads all pending alerts like after a reset and compares their types and payload chunk counts */
+static void prvRetainedMemoryTestCheck(const char* szTest, const uint32_t* pulExpectedTypes, const uint32_t* pulExpectedChunks, uint32_t ulExpectedCount)
+{
+	DfmEntryHandle_t xEntryHandle = 0;
+	DfmAlert_t* pxAlert = (void*)0;
+	void* pvBuffer = (void*)0;
+	uint32_t ulBufferSize = 0;
+	uint32_t ulAlertType;
+	uint32_t ulChunks;
+	uint32_t ulCount = 0;
+	uint32_t ulErrors = 0;
+
+	/* Simulated reset */
+	if ((xDfmRetainedMemoryInitialize(pxRetainedMemoryData) == DFM_FAIL) || (xDfmEntryGetBuffer(&pvBuffer, &ulBufferSize) == DFM_FAIL))
+	{
+		ulRetainedMemoryTestErrors++;
+		return;
+	}
+
+	while (xDfmRetainedMemoryReadAlert(pvBuffer, ulBufferSize) == DFM_SUCCESS)
+	{
+		if ((xDfmEntryCreateAlertFromBuffer(&xEntryHandle) == DFM_FAIL) || (xDfmEntryGetData(xEntryHandle, (void**)&pxAlert) == DFM_FAIL))
+		{
+			ulErrors++;
+			break;
+		}
+
+		/* The payload chunks are read into the same buffer */
+		ulAlertType = pxAlert->ulAlertType;
+		ulChunks = 0;
+		while (xDfmRetainedMemoryReadPayloadChunk((void*)0, 0, pvBuffer, ulBufferSize) == DFM_SUCCESS)
+		{
+			ulChunks++;
+		}
+
+		printf("  alert type %u, %u payload chunks\n", (unsigned int)ulAlertType, (unsigned int)ulChunks);
+
+		if ((ulCount >= ulExpectedCount) || (pulExpectedTypes[ulCount] != ulAlertType) || (pulExpectedChunks[ulCount] != ulChunks))
+		{
+			ulErrors++;
+		}
+
+		ulCount++;
+	}
+
+	if (ulCount != ulExpectedCount)
+	{
+		ulErrors++;
+	}
+
+	printf("%s %s\n", szTest, (ulErrors == 0UL) ? "(OK)" : "(ERROR)");
+
+	ulRetainedMemoryTestErrors += ulErrors;
+}
+
+/* Writes alerts and simulates resets and torn writes. Erases the retained memory. Needs an active DFM session. */
+DfmResult_t xDfmRetainedMemoryRunTests(void)
+{
+	static const uint8_t ucGarbage[sizeof(DfmRetainedMemoryRecordHeader_t) / 2] = { 0xA5, 0xA5, 0xA5, 0xA5 };
+	uint32_t ulExpectedTypes[(DFM_CFG_RETAINED_MEMORY_RECORDS) + 3];
+	uint32_t ulExpectedChunks[(DFM_CFG_RETAINED_MEMORY_RECORDS) + 3];
+	uint32_t ulRecord;
+	uint32_t i;
+
+	if (pxRetainedMemoryData == (void*) 0)
+	{
+		return DFM_FAIL;
+	}
+
+	ulRetainedMemoryTestErrors = 0;
+
+	printf("\nTest 1: Two alerts are replayed in order after reset.\n");
+	(void)xDfmRetainedMemoryClear();
+	(void)prvRetainedMemoryTestWrite(1, 2);
+	(void)prvRetainedMemoryTestWrite(2, 0);
+	ulExpectedTypes[0] = 1; ulExpectedChunks[0] = 2;
+	ulExpectedTypes[1] = 2; ulExpectedChunks[1] = 0;
+	prvRetainedMemoryTestCheck("Test 1", ulExpectedTypes, ulExpectedChunks, 2);
+
+	printf("\nTest 2: Reset while writing the header of the last payload chunk.\n");
+	(void)prvRetainedMemoryTestWrite(3, 2);
+	ulRecord = pxRetainedMemoryData->ulWriteRecord;
+	(void)xDfmRetainedMemoryPortWrite((void*)ucGarbage, sizeof(ucGarbage), prvRetainedMemoryRecordOffset(ulRecord) + (pxRetainedMemoryData->ulWriteVersion & 1UL) * sizeof(DfmRetainedMemoryRecordHeader_t));
+	ulExpectedTypes[2] = 3; ulExpectedChunks[2] = 1;
+	prvRetainedMemoryTestCheck("Test 2", ulExpectedTypes, ulExpectedChunks, 3);
+
+	printf("\nTest 3: Reset while writing the data of a new alert.\n");
+	(void)xDfmRetainedMemoryClear();
+	(void)prvRetainedMemoryTestWrite(1, 0);
+	ulRecord = prvRetainedMemorySelectRecord(0);
+	if (ulRecord != DFM_RETAINED_MEMORY_NO_RECORD)
+	{
+		(void)prvRetainedMemoryInvalidate(ulRecord);
+		(void)xDfmRetainedMemoryPortWrite((void*)ucGarbage, sizeof(ucGarbage), prvRetainedMemoryRecordOffset(ulRecord) + DFM_RETAINED_MEMORY_RECORD_DATA_OFFSET);
+	}
+	ulExpectedTypes[0] = 1; ulExpectedChunks[0] = 0;
+	prvRetainedMemoryTestCheck("Test 3", ulExpectedTypes, ulExpectedChunks, 1);
+
+	printf("\nTest 4: More alerts than records, with the default priorities.\n");
+	(void)xDfmRetainedMemoryClear();
+	for (i = 0; i < (uint32_t)(DFM_CFG_RETAINED_MEMORY_RECORDS) + 1UL; i++)
+	{
+		(void)prvRetainedMemoryTestWrite(i + 1UL, 1);
+	}
+	for (i = 0; i < (uint32_t)(DFM_CFG_RETAINED_MEMORY_RECORDS); i++)
+	{
+		ulExpectedTypes[i] = ((DFM_CFG_RETAINED_MEMORY_STRATEGY) == DFM_RETAINED_MEMORY_STRATEGY_OVERWRITE) ? (i + 2UL) : (i + 1UL);
+		ulExpectedChunks[i] = 1;
+	}
+	prvRetainedMemoryTestCheck("Test 4", ulExpectedTypes, ulExpectedChunks, DFM_CFG_RETAINED_MEMORY_RECORDS);
+
+	printf("\nTest 5: A full record rejects one more payload chunk.\n");
+	(void)xDfmRetainedMemoryClear();
+	if (prvRetainedMemoryTestWriteFull(1, &ulExpectedChunks[0]) == DFM_FAIL)
+	{
+		ulRetainedMemoryTestErrors++;
+	}
+	ulExpectedTypes[0] = 1;
+	prvRetainedMemoryTestCheck("Test 5", ulExpectedTypes, ulExpectedChunks, 1);
+
+	(void)xDfmRetainedMemoryClear();
+
+	printf("\nRetained memory tests %s\n", (ulRetainedMemoryTestErrors == 0UL) ? "passed" : "FAILED");
+
+	return (ulRetainedMemoryTestErrors == 0UL) ? DFM_SUCCESS : DFM_FAIL;
+}
+
+#endif /* (INCLUDE_RETAINED_MEMORY_TESTS == 1) */
+
 #endif
@@ -57,6 +57,26 @@ extern "C" {
 
 #define DFM_PAYLOAD_DESCRIPTION_MAX_LEN (16)
 
+#ifndef DFM_CFG_ALERT_RATE_LIMIT_SLOTS
+#define DFM_CFG_ALERT_RATE_LIMIT_SLOTS 0
+#endif
+
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1)
+
+#ifndef DFM_CFG_ALERT_RATE_LIMIT_GET_TIME_MS
+#error DFM_CFG_ALERT_RATE_LIMIT_GET_TIME_MS not set in dfmConfig.h!
+#endif
+
+#ifndef DFM_CFG_ALERT_RATE_LIMIT_BURST
+#define DFM_CFG_ALERT_RATE_LIMIT_BURST(ulAlertType) (3)
+#endif
+
+#ifndef DFM_CFG_ALERT_RATE_LIMIT_PERIOD_MS
+#define DFM_CFG_ALERT_RATE_LIMIT_PERIOD_MS (60000)
+#endif
+
+#endif
+
 /**
  * @brief Callback type used when retrieving all alert data
  */
@@ -79,8 +99,23 @@ typedef struct
 	void* pvData;
 	uint32_t ulSize;
 	char cDescriptionBuffer[DFM_PAYLOAD_DESCRIPTION_MAX_LEN];
+	DfmPayloadReadCallback_t xReadCallback; /* Reads the payload when it isn't in memory, pvData is null then */
 } DfmAlertPayload_t;
 
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1)
+/**
+ * @brief Rate limiter state for one alert signature
+ */
+typedef struct
+{
+	uint32_t ulSignature;	/* Hash of alert type and symptoms */
+	uint32_t ulTokens;		/* Alerts that can be emitted before this signature is suppressed */
+	uint32_t ulRefillTime;	/* The time (ms) that the tokens were last refilled */
+	uint32_t ulLastUsed;	/* Sequence number of the latest alert with this signature, 0 for a free slot */
+	uint32_t ulSuppressed;	/* Suppressed alerts not yet reported */
+} DfmAlertRateLimitEntry_t;
+#endif
+
 /**
  * @brief Alert header
  */
@@ -122,6 +157,14 @@ typedef struct DfmAlertData
 	DfmAlert_t xAlert;
 	DfmAlertPayload_t xPayloads[DFM_CFG_MAX_PAYLOADS]; /* The payloads */
 	uint32_t ulPayloadCount;
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1)
+	DfmAlertRateLimitEntry_t xRateLimitEntries[DFM_CFG_ALERT_RATE_LIMIT_SLOTS];
+	uint32_t ulRateLimitSequence;
+	uint32_t ulRateLimitEvicted;	/* Suppressed count of evicted signatures, added to the next emitted alert */
+	DfmAlertRateLimitEntry_t* pxRateLimitReported;	/* Entry of the alert being emitted */
+	uint32_t ulRateLimitReportedSuppressed;	/* Counts added to the alert being emitted, cleared once it is sent or stored */
+	uint32_t ulRateLimitReportedEvicted;
+#endif
 } DfmAlertData_t;
 
 extern DfmAlertData_t* pxDfmAlertData;
@@ -211,9 +254,16 @@ DfmResult_t xDfmAlertBegin(uint32_t ulAlertType, const char* szAlertDescription,
  * 						DFM_ALERT_END_TYPE_SEND: Send the Alert.
  * 						DFM_ALERT_END_TYPE_STORE: Store the Alert.
  * 						DFM_ALERT_END_TYPE_RETAIN: Retain the Alert.
+ *
+ * When DFM_CFG_ALERT_RATE_LIMIT_SLOTS is enabled, an Alert that repeats the type and symptoms
+ * of recent Alerts too often is dropped and counted instead. The count is reported in the next
+ * Alert with the same signature, as symptom DFM_SYMPTOM_SUPPRESSED_ALERTS if that is defined.
+ * Counts of signatures evicted from the rate limiter are reported in the next Alert of any
+ * signature, as symptom DFM_SYMPTOM_EVICTED_ALERTS if that is defined. The counts are only
+ * cleared once that Alert has been sent, stored or retained.
  * 
  * @retval DFM_FAIL Failure
- * @retval DFM_SUCCESS Success
+ * @retval DFM_SUCCESS Success, also when the Alert was dropped by the rate limiter
  */
 DfmResult_t xDfmAlertEndCustom(DfmAlertHandle_t xAlertHandle, uint32_t ulEndType);
 
@@ -275,12 +325,28 @@ DfmResult_t xDfmAlertGetSymptom(DfmAlertHandle_t xAlertHandle, uint32_t ulIndex,
  */
 DfmResult_t xDfmAlertAddPayload(DfmAlertHandle_t xAlertHandle, void* pvData, uint32_t ulSize, const char* szDescription);
 
+/**
+ * @brief Add Payload that is read using a callback to Alert
+ *
+ * The callback is called for each Payload chunk when the Alert is ended, so the Payload
+ * doesn't have to be stored in one contiguous buffer. It must stay readable until then.
+ *
+ * @param[in] xAlertHandle Alert handle.
+ * @param[in] xReadCallback Callback that reads the Payload.
+ * @param[in] ulSize Payload size.
+ * @param[in] szDescription Payload description.
+ *
+ * @retval DFM_FAIL Failure
+ * @retval DFM_SUCCESS Success
+ */
+DfmResult_t xDfmAlertAddPayloadFromCallback(DfmAlertHandle_t xAlertHandle, DfmPayloadReadCallback_t xReadCallback, uint32_t ulSize, const char* szDescription);
+
 /**
  * @brief Get Payload from Alert
  *
  * @param[in] xAlertHandle Alert handle.
  * @param[in] ulIndex Symptom index.
- * @param[out] ppvData Payload pointer.
+ * @param[out] ppvData Payload pointer, null if the Payload was added using xDfmAlertAddPayloadFromCallback().
  * @param[out] pulSize Payload size.
  * @param[out] pszDescription Payload description.
  *
@@ -337,6 +403,17 @@ DfmResult_t xDfmAlertSendAll(void);
  */
 DfmResult_t xDfmAlertGetAll(DfmAlertEntryCallback_t xCallback);
 
+#if ((DFM_CFG_ALERT_RATE_LIMIT_SLOTS) >= 1) && (INCLUDE_ALERT_RATE_LIMIT_TESTS == 1) && defined(DFM_SYMPTOM_SUPPRESSED_ALERTS) && defined(DFM_SYMPTOM_EVICTED_ALERTS)
+/**
+ * @brief Runs the rate limiter on simulated alerts and time and prints the results.
+ * Erases the rate limiter state.
+ *
+ * @retval DFM_FAIL A test failed
+ * @retval DFM_SUCCESS All tests passed
+ */
+DfmResult_t xDfmAlertRateLimitRunTests(void);
+#endif
+
 /** @} */
 
 #else
@@ -354,6 +431,7 @@ DfmResult_t xDfmAlertGetAll(DfmAlertEntryCallback_t xCallback);
 #define xDfmAlertAddSymptom(xAlertHandle, ulSymptomId, ulValue) ((void)(xAlertHandle), (void)(ulSymptomId), (void)(ulValue), DFM_FAIL)
 #define xDfmAlertGetSymptom(xAlertHandle, ulIndex, pulSymptomId, pulValue) ((void)(xAlertHandle), (void)(ulIndex), (void)(pulSymptomId), (void)(pulValue), DFM_FAIL)
 #define xDfmAlertAddPayload(xAlertHandle, pvData, ulSize, szDescription) ((void)(xAlertHandle), (void)(pvData), (void)(ulSize), (void)(szDescription), DFM_FAIL)
+#define xDfmAlertAddPayloadFromCallback(xAlertHandle, xReadCallback, ulSize, szDescription) ((void)(xAlertHandle), (void)(xReadCallback), (void)(ulSize), (void)(szDescription), DFM_FAIL)
 #define xDfmAlertAddTracePayload(xAlertHandle) ((void)(xAlertHandle), DFM_FAIL)
 #define xDfmAlertGetPayload(xAlertHandle, ulIndex, ppvData, pulSize, pszDescription) ((void)(xAlertHandle), (void)(ulIndex), (void)(ppvData), (void)(pulSize), (void)(pszDescription), DFM_FAIL)
 #define xDfmAlertGetType(xAlertHandle, pulAlertType) ((void)(xAlertHandle), (void)(pulAlertType), DFM_FAIL)
@@ -39,6 +39,29 @@
 
 #define CRASH_STACK_CAPTURE_SIZE DFM_CFG_STACKDUMP_SIZE
 
+#ifndef DFM_CFG_CRASH_SEEN_TABLE_SIZE
+#define DFM_CFG_CRASH_SEEN_TABLE_SIZE 0
+#endif
+
+#ifndef DFM_CFG_CRASH_HASH_NAMES
+#define DFM_CFG_CRASH_HASH_NAMES 0
+#endif
+
+/* No return addresses are recognized unless the code memory is configured */
+#ifndef DFM_CFG_CODE_BEGIN
+#define DFM_CFG_CODE_BEGIN 0
+#endif
+
+#ifndef DFM_CFG_CODE_NEXT
+#define DFM_CFG_CODE_NEXT 0
+#endif
+
+/* The part of the used task stack that is dumped in full when all of it doesn't fit in CRASH_STACK_CAPTURE_SIZE */
+#define CRASH_STACK_HEAD_SIZE (((CRASH_STACK_CAPTURE_SIZE) / 2) & ~3UL)
+
+/* The return addresses dumped from the rest of the stack, each takes 12 bytes (address range and value) */
+#define CRASH_STACK_MAX_RETURN_ADDRESSES (((CRASH_STACK_CAPTURE_SIZE) - (CRASH_STACK_HEAD_SIZE)) / 12)
+
 /* Additional memory ranges to include in the crash dump (e.g. heap memory) */
 #define CRASH_MEM_REGION1_START	0xFFFFFFFF /* 0xFFFFFFFF = not used */
 #define CRASH_MEM_REGION1_SIZE	0
@@ -65,6 +88,9 @@ typedef struct{
 
 extern dfmTrapInfo_t dfmTrapInfo;
 
+/* Marks the crash dump of the alert as delivered, see DFM_CFG_AFTER_ALERT_DELIVERED */
+void vDfmCrashCatcherAlertDelivered(const char* szSessionId, uint32_t ulAlertId);
+
 // This is specific for Arm Cortex-M devices, but so is CrashCatcher.
 #define DFM_TRIGGER_NMI() SCB->ICSR |= SCB_ICSR_NMIPENDSET_Msk;
 
@@ -103,6 +103,25 @@ DfmResult_t xDfmEntryCreatePayloadHeader(DfmAlertHandle_t xAlertHandle, uint16_t
  */
 DfmResult_t xDfmEntryCreatePayloadChunk(DfmAlertHandle_t xAlertHandle, uint16_t usEntryId, uint16_t usChunkIndex, uint16_t usChunkCount, void* pvPayload, uint32_t ulSize, char* szDescription, DfmEntryHandle_t* pxEntryHandle);
 
+/**
+ * @brief Create an Payload chunk Entry from Alert handle and Payload chunk information,
+ * reading the Payload chunk directly into the Entry using a callback.
+ *
+ * @param[in] xAlertHandle Alert handle.
+ * @param[in] usEntryId Entry Id.
+ * @param[in] usChunkIndex This chunk's index.
+ * @param[in] usChunkCount Payload's total chunk count.
+ * @param[in] xReadCallback Callback that reads the Payload.
+ * @param[in] ulOffset Payload chunk offset in the Payload.
+ * @param[in] ulSize Payload chunk size.
+ * @param[in] szDescription Payload description.
+ * @param[out] pxEntryHandle Pointer to Entry handle.
+ *
+ * @retval DFM_FAIL Failure
+ * @retval DFM_SUCCESS Success
+ */
+DfmResult_t xDfmEntryCreatePayloadChunkFromCallback(DfmAlertHandle_t xAlertHandle, uint16_t usEntryId, uint16_t usChunkIndex, uint16_t usChunkCount, DfmPayloadReadCallback_t xReadCallback, uint32_t ulOffset, uint32_t ulSize, char* szDescription, DfmEntryHandle_t* pxEntryHandle);
+
 /**
  * @brief Create an Alert Entry from the Entry system buffer.
  *
@@ -332,6 +351,7 @@ DfmResult_t xDfmEntryGetEndMarkers(DfmEntryHandle_t xEntryHandle, uint8_t** pucM
 #define xDfmEntryCreateAlert(xAlertHandle, pxEntryHandle) (DFM_FAIL)
 #define xDfmEntryCreatePayloadHeader(xAlertHandle, usEntryId, ulPayloadSize, szDescription, pxEntryHandle) (DFM_FAIL)
 #define xDfmEntryCreatePayloadChunk(xAlertHandle, usEntryId, usChunkIndex, usChunkCount, pvPayload, ulSize, szDescription, pxEntryHandle) (DFM_FAIL)
+#define xDfmEntryCreatePayloadChunkFromCallback(xAlertHandle, usEntryId, usChunkIndex, usChunkCount, xReadCallback, ulOffset, ulSize, szDescription, pxEntryHandle) (DFM_FAIL)
 #define xDfmEntryCreateAlertFromBuffer(pxEntryHandle) (DFM_FAIL)
 #define xDfmEntryCreatePayloadChunkFromBuffer(szSessionId, ulAlertId, pxEntryHandle) (DFM_FAIL)
 #define xDfmEntryGetSize(xEntryHandle, pulSize) (DFM_FAIL)
@@ -37,17 +37,61 @@ extern "C" {
  * @{
  */
 
+#ifndef DFM_CFG_RETAINED_MEMORY_RECORDS
+#define DFM_CFG_RETAINED_MEMORY_RECORDS (4)
+#endif
+
+#ifndef DFM_CFG_RETAINED_MEMORY_RECORD_SIZE
+#define DFM_CFG_RETAINED_MEMORY_RECORD_SIZE (2048)
+#endif
+
+#ifndef DFM_CFG_RETAINED_MEMORY_STRATEGY
+#define DFM_CFG_RETAINED_MEMORY_STRATEGY DFM_RETAINED_MEMORY_STRATEGY_OVERWRITE
+#endif
+
+#ifndef DFM_CFG_RETAINED_MEMORY_PRIORITY
+#define DFM_CFG_RETAINED_MEMORY_PRIORITY(ulAlertType) (0)
+#endif
+
+#if ((DFM_CFG_RETAINED_MEMORY_RECORDS) <= 0)
+#error "DFM_CFG_RETAINED_MEMORY_RECORDS invalid"
+#endif
+
+#if (((DFM_CFG_RETAINED_MEMORY_RECORD_SIZE) % 4) != 0)
+#error "DFM_CFG_RETAINED_MEMORY_RECORD_SIZE must be a multiple of 4"
+#endif
+
+/**
+ * @brief RAM copy of what a retained alert record holds, rebuilt by scanning the records at startup
+ */
+typedef struct DfmRetainedMemoryRecordInfo
+{
+	uint32_t ulSequence;	/* The order the records were written in, 0 for a free record */
+	uint32_t ulPriority;	/* DFM_CFG_RETAINED_MEMORY_PRIORITY() of the alert */
+} DfmRetainedMemoryRecordInfo_t;
+
 typedef struct DfmRetainedMemoryData
 {
 	uint32_t ulInitialized;
-	uint32_t ulWriteOffset;
+	uint32_t ulNextSequence;
+	uint32_t ulWriteRecord;			/* The record that payload chunks are appended to */
+	uint32_t ulWriteSequence;
+	uint32_t ulWritePriority;
+	uint32_t ulWriteVersion;		/* Incremented for each committed header */
+	uint32_t ulWriteSize;			/* Committed data size */
+	uint32_t ulWriteCrc;			/* CRC of the committed data */
+	uint32_t ulReadRecord;
+	uint32_t ulReadSequence;		/* Records up to this sequence have been read */
 	uint32_t ulReadOffset;
-	uint32_t alignment;
+	uint32_t ulReadSize;
+	DfmRetainedMemoryRecordInfo_t xRecords[DFM_CFG_RETAINED_MEMORY_RECORDS];
 	DfmRetainedMemoryPortData_t xRetainedMemoryPortData;
 } DfmRetainedMemoryData_t;
 
 /**
- * @brief Initialize Retained Memory system
+ * @brief Initialize Retained Memory system. Scans the retained alert records and keeps the valid
+ * ones, so they can be read in the order they were written. Records that were not completely
+ * written, e.g. due to a reset during fault handling, are freed.
  *
  * @param[in] pxBuffer Retained Memory system buffer.
  *
@@ -57,7 +101,8 @@ typedef struct DfmRetainedMemoryData
 DfmResult_t xDfmRetainedMemoryInitialize(DfmRetainedMemoryData_t *pxBuffer);
 
 /**
- * @brief Write Alert Entry
+ * @brief Write Alert Entry to a new record. When all records are in use, DFM_CFG_RETAINED_MEMORY_STRATEGY
+ * decides if a pending record is replaced or if the Alert is skipped.
  *
  * @param[in] xEntryHandle Entry handle.
  *
@@ -67,7 +112,7 @@ DfmResult_t xDfmRetainedMemoryInitialize(DfmRetainedMemoryData_t *pxBuffer);
 DfmResult_t xDfmRetainedMemoryWriteAlert(DfmEntryHandle_t xEntryHandle);
 
 /**
- * @brief Read Alert Entry
+ * @brief Read the next pending Alert Entry, oldest first
  *
  * @param[in] pvBuffer Pointer to Alert Entry buffer.
  * @param[in] ulBufferSize Alert Entry buffer size.
@@ -78,7 +123,7 @@ DfmResult_t xDfmRetainedMemoryWriteAlert(DfmEntryHandle_t xEntryHandle);
 DfmResult_t xDfmRetainedMemoryReadAlert(void* pvBuffer, uint32_t ulBufferSize);
 
 /**
- * @brief Write Payload chunk Entry
+ * @brief Write Payload chunk Entry to the record of the last written Alert
  *
  * @param[in] xEntryHandle Entry handle.
  *
@@ -88,7 +133,7 @@ DfmResult_t xDfmRetainedMemoryReadAlert(void* pvBuffer, uint32_t ulBufferSize);
 DfmResult_t xDfmRetainedMemoryWritePayloadChunk(DfmEntryHandle_t xEntryHandle);
 
 /**
- * @brief Read Payload chunk Entry
+ * @brief Read the next Payload chunk Entry of the last read Alert
  *
  * @param[in] szSessionId Requested Session Id.
  * @param[in] ulAlertId Requested Alert Id.
@@ -26,6 +26,9 @@ typedef uint32_t DfmResult_t;
 typedef void* DfmAlertHandle_t;
 typedef void* DfmEntryHandle_t;
 
+/* Reads ulSize bytes from offset ulOffset of a payload into pvBuffer */
+typedef DfmResult_t (*DfmPayloadReadCallback_t)(uint32_t ulOffset, void* pvBuffer, uint32_t ulSize);
+
 typedef enum DfmEntryType
 {
 	DFM_ENTRY_TYPE_ALERT = 0x1512,
@@ -40,6 +43,13 @@ typedef enum DfmStorageStrategy
 	DFM_STORAGE_STRATEGY_SKIP,			/** Skip if full */
 } DfmStorageStrategy_t;
 
+typedef enum DfmRetainedMemoryStrategy
+{
+	DFM_RETAINED_MEMORY_STRATEGY_OVERWRITE,		/** Overwrite the oldest alert if full */
+	DFM_RETAINED_MEMORY_STRATEGY_SKIP,			/** Skip the new alert if full */
+	DFM_RETAINED_MEMORY_STRATEGY_PRIORITY,		/** Overwrite the oldest alert with lower priority if full, otherwise skip */
+} DfmRetainedMemoryStrategy_t;
+
 typedef enum DfmCloudStrategy
 {
 	DFM_CLOUD_STRATEGY_OFFLINE,			/** Will not attempt to send alerts/payloads */
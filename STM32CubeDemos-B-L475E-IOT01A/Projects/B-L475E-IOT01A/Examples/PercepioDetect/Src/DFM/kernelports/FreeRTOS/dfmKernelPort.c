@@ -55,4 +55,37 @@ DfmResult_t xDfmKernelPortGetCurrentTaskName(char** pszTaskName)
 	return DFM_SUCCESS;
 }
 
+DfmResult_t xDfmKernelPortGetCurrentTaskStack(uint32_t* pulStackLow, uint32_t* pulStackHigh)
+{
+#if (portSTACK_GROWTH < 0) && ((configRECORD_STACK_HIGH_ADDRESS) == 1)
+	StaticTask_t* pxTCB;
+
+	if ((pulStackLow == (void*)0) || (pulStackHigh == (void*)0))
+	{
+		return DFM_FAIL;
+	}
+
+	/* The TCB is opaque but StaticTask_t has the same layout, pxDummy6 is pxStack
+	 * (the lowest address) and pxDummy8 is pxEndOfStack (the highest word). This
+	 * avoids vTaskGetInfo(), which isn't meant to be called from a fault handler. */
+	pxTCB = (StaticTask_t*)xTaskGetCurrentTaskHandle();
+
+	if (pxTCB == (void*)0)
+	{
+		return DFM_FAIL;
+	}
+
+	*pulStackLow = (uint32_t)pxTCB->pxDummy6;
+	*pulStackHigh = (uint32_t)pxTCB->pxDummy8 + sizeof(StackType_t);
+
+	return DFM_SUCCESS;
+#else
+	(void)pulStackLow;
+	(void)pulStackHigh;
+
+	/* The top of the stack is only recorded with configRECORD_STACK_HIGH_ADDRESS */
+	return DFM_FAIL;
+#endif
+}
+
 #endif
@@ -57,6 +57,19 @@ DfmResult_t xDfmKernelPortInitialize(DfmKernelPortData_t* pxBuffer);
  */
 DfmResult_t xDfmKernelPortGetCurrentTaskName(char** pszTaskName);
 
+/**
+ * @brief Retrieves the stack bounds of the current task
+ *
+ * Must be safe to call from a fault handler.
+ *
+ * @param[out] pulStackLow Pointer where the lowest address of the stack will be written.
+ * @param[out] pulStackHigh Pointer where the first address after the stack will be written.
+ *
+ * @retval DFM_FAIL Failure, e.g. no current task or the bounds aren't known
+ * @retval DFM_SUCCESS Success
+ */
+DfmResult_t xDfmKernelPortGetCurrentTaskStack(uint32_t* pulStackLow, uint32_t* pulStackHigh);
+
 /** @} */
 
 
@@ -33,4 +33,13 @@ DfmResult_t xDfmKernelPortGetCurrentTaskName(char** pszTaskName)
 	return DFM_SUCCESS;
 }
 
+DfmResult_t xDfmKernelPortGetCurrentTaskStack(uint32_t* pulStackLow, uint32_t* pulStackHigh)
+{
+	(void)pulStackLow;
+	(void)pulStackHigh;
+
+	/* No tasks */
+	return DFM_FAIL;
+}
+
 #endif
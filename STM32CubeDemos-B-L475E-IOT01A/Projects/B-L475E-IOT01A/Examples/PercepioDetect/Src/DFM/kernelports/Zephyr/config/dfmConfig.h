@@ -83,6 +83,28 @@ extern "C" {
  */
 #define DFM_CFG_RETAINED_MEMORY CONFIG_PERCEPIO_DFM_CFG_RETAINED_MEMORY
 
+#if CONFIG_PERCEPIO_DFM_CFG_RETAINED_MEMORY == 1
+/**
+ * @brief The number and size of the alert records in Retained Memory.
+ */
+#define DFM_CFG_RETAINED_MEMORY_RECORDS CONFIG_PERCEPIO_DFM_CFG_RETAINED_MEMORY_RECORDS
+#define DFM_CFG_RETAINED_MEMORY_RECORD_SIZE CONFIG_PERCEPIO_DFM_CFG_RETAINED_MEMORY_RECORD_SIZE
+
+/**
+ * @brief The strategy used when all Retained Memory records are pending. Possible values are:
+ *	DFM_RETAINED_MEMORY_STRATEGY_OVERWRITE	Overwrite the oldest alert
+ *	DFM_RETAINED_MEMORY_STRATEGY_SKIP		Skip the new alert
+ *	DFM_RETAINED_MEMORY_STRATEGY_PRIORITY	Overwrite the oldest alert with lower DFM_CFG_RETAINED_MEMORY_PRIORITY, otherwise skip
+ */
+#if CONFIG_PERCEPIO_DFM_CFG_SELECTED_RETAINED_MEMORY_STRATEGY_SKIP == 1
+	#define DFM_CFG_RETAINED_MEMORY_STRATEGY DFM_RETAINED_MEMORY_STRATEGY_SKIP
+#elif CONFIG_PERCEPIO_DFM_CFG_SELECTED_RETAINED_MEMORY_STRATEGY_PRIORITY == 1
+	#define DFM_CFG_RETAINED_MEMORY_STRATEGY DFM_RETAINED_MEMORY_STRATEGY_PRIORITY
+#else
+	#define DFM_CFG_RETAINED_MEMORY_STRATEGY DFM_RETAINED_MEMORY_STRATEGY_OVERWRITE
+#endif
+#endif
+
 /**
  * @brief The strategy used for storing alerts/payload. Possible values are:
  *	DFM_STORAGE_STRATEGY_IGNORE			Never store alerts/payloads
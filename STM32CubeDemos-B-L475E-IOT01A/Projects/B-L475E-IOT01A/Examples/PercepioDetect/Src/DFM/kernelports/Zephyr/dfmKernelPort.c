@@ -27,8 +27,6 @@
 #error "DFM is configured to store Core Dumps in Retained Memory but that isn't enabled in DFM."
 #endif
 
-#define MAX_COREDUMP_PARTS 4
-
 DfmKernelPortData_t* pxKernelPortData;
 
 DfmResult_t xDfmKernelPortInitialize(DfmKernelPortData_t *pxBuffer)
@@ -52,6 +50,28 @@ DfmResult_t xDfmKernelPortGetCurrentTaskName(char** pszTaskName)
 	return DFM_SUCCESS;
 }
 
+DfmResult_t xDfmKernelPortGetCurrentTaskStack(uint32_t* pulStackLow, uint32_t* pulStackHigh)
+{
+#if defined(CONFIG_THREAD_STACK_INFO)
+	k_tid_t current_thread = k_current_get();
+
+	if ((pulStackLow == (void*)0) || (pulStackHigh == (void*)0) || (current_thread == (void*)0))
+	{
+		return DFM_FAIL;
+	}
+
+	*pulStackLow = (uint32_t)current_thread->stack_info.start;
+	*pulStackHigh = (uint32_t)(current_thread->stack_info.start + current_thread->stack_info.size);
+
+	return DFM_SUCCESS;
+#else
+	(void)pulStackLow;
+	(void)pulStackHigh;
+
+	return DFM_FAIL;
+#endif
+}
+
 /**
  * @brief Initialize aspects of the devalert module that must 
  * preceed the kernel initialization (scheduling, threads, etc.).
@@ -83,87 +103,93 @@ SYS_INIT(devalert_post_kernel_init, POST_KERNEL, 99);
  * TODO: We probably don't want this in the kernel port but rather in its own file, like with crashcatcher.
  */
 
-enum eDfmCoredumpState {
-	DFM_COREDUMP_STATE_STARTED,
-	DFM_COREDUMP_STATE_HEADER,
-	DFM_COREDUMP_STATE_DATA
-};
-
-typedef struct DfmCoredumpPayload {
+/**
+ * A part of a coredump, as output by the Zephyr coredump module. Small parts, i.e. the headers
+ * which Zephyr outputs from temporary variables, are copied. Larger parts are memory regions
+ * that remain in place while the alert is created, so only the address is kept and the data is
+ * read directly into the payload chunks.
+ */
+typedef struct DfmCoredumpPart {
 	uint8_t pubHeaderBuffer[32]; /* The header structs are packed, this is way more than the size they'll ever reach */
-	size_t ulHeaderSize;
 	void* pxContent;
-	size_t ulContentSize;
-} DfmCoredumpPayload_t;
+	size_t ulSize;
+} DfmCoredumpPart_t;
 
 #if DFM_CFG_ENABLE_COREDUMPS == 1
 
-static enum eDfmCoredumpState eCoreDumpState = DFM_COREDUMP_STATE_STARTED;
-static DfmCoredumpPayload_t pxDfmCoredumpParts[MAX_COREDUMP_PARTS]; // The zephyr coredump process won't add more than 3 headers
-static uint8_t ubDfmCoreDumpHeaderCounter = 0;
-static uint8_t ubDfmPayloadBuffer[CONFIG_PERCEPIO_DFM_CFG_MAX_COREDUMP_SIZE];
-static uint32_t ulDfmPayloadBufferBytesUsed = 0;
+static DfmCoredumpPart_t pxDfmCoredumpParts[CONFIG_PERCEPIO_DFM_CFG_MAX_COREDUMP_PARTS];
+static uint32_t ulDfmCoredumpPartCounter = 0;
+static uint32_t ulDfmCoredumpSize = 0;
 
-DfmResult_t xDfmAlertAddCoredump(DfmAlertHandle_t xAlertHandle)
+/**
+ * Read a part of the recorded coredump, called by DFM for each payload chunk.
+ * @param ulOffset Offset in the coredump
+ * @param pvBuffer Buffer to read into
+ * @param ulSize Number of bytes to read
+ */
+static DfmResult_t prvDfmCoredumpRead(uint32_t ulOffset, void* pvBuffer, uint32_t ulSize)
 {
-	if (ubDfmCoreDumpHeaderCounter < 1)
-		return DFM_FAIL;
-
-	ulDfmPayloadBufferBytesUsed = 0;
-	memset(ubDfmPayloadBuffer, 0, sizeof(ubDfmPayloadBuffer));
-	uint8_t* pubDfmPayloadBufferPosition = ubDfmPayloadBuffer;
+	uint8_t* pubBuffer = (uint8_t*)pvBuffer;
 
-	for (int i=0; i<ubDfmCoreDumpHeaderCounter; i++)
+	for (uint32_t i = 0; (i < ulDfmCoredumpPartCounter) && (ulSize > 0); i++)
 	{
-		DfmCoredumpPayload_t* pxCurrentPayload = &pxDfmCoredumpParts[i];
+		DfmCoredumpPart_t* pxCurrentPart = &pxDfmCoredumpParts[i];
 
-		size_t ulContentSize = pxCurrentPayload->ulContentSize;
-		if (ulContentSize > CONFIG_PERCEPIO_DFM_CFG_STACKDUMP_SIZE)
-			ulContentSize = CONFIG_PERCEPIO_DFM_CFG_STACKDUMP_SIZE;
-
-		/* Initial size check to avoid overflowing the buffer, i.e. does this part of the chunk fit within the chunk */
-		if (ulDfmPayloadBufferBytesUsed + pxCurrentPayload->ulHeaderSize + ulContentSize > CONFIG_PERCEPIO_DFM_CFG_MAX_COREDUMP_SIZE)
-			return DFM_FAIL;
+		if (ulOffset >= pxCurrentPart->ulSize)
+		{
+			ulOffset -= pxCurrentPart->ulSize;
+			continue;
+		}
 
-		/* Copy the header */
-		memcpy(pubDfmPayloadBufferPosition, pxCurrentPayload->pubHeaderBuffer, pxCurrentPayload->ulHeaderSize);
-		pubDfmPayloadBufferPosition += pxCurrentPayload->ulHeaderSize;
-		ulDfmPayloadBufferBytesUsed += pxCurrentPayload->ulHeaderSize;
+		size_t ulBytesToCopy = pxCurrentPart->ulSize - ulOffset;
+		if (ulBytesToCopy > ulSize)
+			ulBytesToCopy = ulSize;
 
-		if (pxCurrentPayload->pxContent != NULL)
+		if (pxCurrentPart->pxContent != NULL)
 		{
-			/* Copy the content */
-			memcpy(pubDfmPayloadBufferPosition, pxCurrentPayload->pxContent, ulContentSize);
-			pubDfmPayloadBufferPosition += ulContentSize;
-			ulDfmPayloadBufferBytesUsed += ulContentSize;
+			memcpy(pubBuffer, (uint8_t*)pxCurrentPart->pxContent + ulOffset, ulBytesToCopy);
 		}
+		else
+		{
+			memcpy(pubBuffer, &pxCurrentPart->pubHeaderBuffer[ulOffset], ulBytesToCopy);
+		}
+
+		pubBuffer += ulBytesToCopy;
+		ulSize -= ulBytesToCopy;
+		ulOffset = 0;
 	}
 
-	DfmResult_t xResult;
-	xResult = xDfmAlertAddPayload(
+	return (ulSize == 0) ? DFM_SUCCESS : DFM_FAIL;
+}
+
+DfmResult_t xDfmAlertAddCoredump(DfmAlertHandle_t xAlertHandle)
+{
+	if (ulDfmCoredumpPartCounter < 1)
+		return DFM_FAIL;
+
+	/* The coredump is read part by part into the payload chunks when the alert is ended */
+	return xDfmAlertAddPayloadFromCallback(
 		xAlertHandle,
-		ubDfmPayloadBuffer,
-		ulDfmPayloadBufferBytesUsed,
+		prvDfmCoredumpRead,
+		ulDfmCoredumpSize,
 		"Coredump.dmp"
 	);
-
-	return xResult;
 }
 
 /**
- * Start a new coredump, will wipe the memory area and reset the internal counters used by this kernel port when a coredump
+ * Start a new coredump, will reset the internal counters used by this kernel port when a coredump
  * is saved.
  * This function is called from the Zephyr kernel.
  */
 static void xDfmCoredumpBackendStart(void)
 {
-	eCoreDumpState = DFM_COREDUMP_STATE_STARTED;
-	ubDfmCoreDumpHeaderCounter = 0;
+	ulDfmCoredumpPartCounter = 0;
+	ulDfmCoredumpSize = 0;
 	memset(pxDfmCoredumpParts, 0, sizeof(pxDfmCoredumpParts));
 }
 
 /**
- * Internally store a part of a coredump within the internal array of DfmCoreDumpPayloads.
+ * Internally store a part of a coredump within the internal array of DfmCoredumpParts.
  * This function is called from the Zephyr kernel.
  * @param pxBuffer
  * @param ulBufferLength
@@ -172,51 +198,34 @@ static void xDfmCoredumpBackendBufferOutput(uint8_t* pxBuffer, size_t ulBufferLe
 {
 	/*
 	 * To avoid nasty buffer overflows, stop dumping any more data in case the maximum
-	 * amount of payloads has been reached. Since the signature of the function expected by Zephyr
+	 * amount of parts or size has been reached. Since the signature of the function expected by Zephyr
 	 * for outputting backend data is a void, error handling can unfortunately not be implemented here.
 	 */
-	if (ubDfmCoreDumpHeaderCounter >= MAX_COREDUMP_PARTS)
+	if (ulDfmCoredumpPartCounter >= CONFIG_PERCEPIO_DFM_CFG_MAX_COREDUMP_PARTS)
 		return;
 
-	DfmCoredumpPayload_t* pxCurrentPayload = &pxDfmCoredumpParts[ubDfmCoreDumpHeaderCounter];
-
-	switch (eCoreDumpState)
-	{
-
-		case DFM_COREDUMP_STATE_STARTED:
-		{
-			/* TODO: Might be nice with some assertion here or similar */
-			if (ulBufferLength > 32)
-				return;
-
-			pxCurrentPayload->ulHeaderSize = ulBufferLength;
-			memcpy(pxCurrentPayload->pubHeaderBuffer, pxBuffer, ulBufferLength);
-			ubDfmCoreDumpHeaderCounter++;
-			eCoreDumpState = DFM_COREDUMP_STATE_HEADER;
-			break;
-		}
-
-		case DFM_COREDUMP_STATE_HEADER:
-		{
-			if (ulBufferLength > 32)
-				return;
+	if (ulBufferLength == 0)
+		return;
 
-			pxCurrentPayload->ulHeaderSize = ulBufferLength;
-			memcpy(pxCurrentPayload->pubHeaderBuffer, pxBuffer, ulBufferLength);
-			eCoreDumpState = DFM_COREDUMP_STATE_DATA;
-			break;
-		}
+	if (ulDfmCoredumpSize + ulBufferLength > CONFIG_PERCEPIO_DFM_CFG_MAX_COREDUMP_SIZE)
+		return;
 
-		case DFM_COREDUMP_STATE_DATA: {
-			pxCurrentPayload->ulContentSize = ulBufferLength;
-			pxCurrentPayload->pxContent = pxBuffer;
-			ubDfmCoreDumpHeaderCounter++;
-			eCoreDumpState = DFM_COREDUMP_STATE_HEADER;
-			break;
-		}
+	DfmCoredumpPart_t* pxCurrentPart = &pxDfmCoredumpParts[ulDfmCoredumpPartCounter];
 
+	if (ulBufferLength <= sizeof(pxCurrentPart->pubHeaderBuffer))
+	{
+		/* Headers are output from temporary variables, copy them */
+		memcpy(pxCurrentPart->pubHeaderBuffer, pxBuffer, ulBufferLength);
+		pxCurrentPart->pxContent = NULL;
+	}
+	else
+	{
+		pxCurrentPart->pxContent = pxBuffer;
 	}
 
+	pxCurrentPart->ulSize = ulBufferLength;
+	ulDfmCoredumpSize += ulBufferLength;
+	ulDfmCoredumpPartCounter++;
 }
 
 /**
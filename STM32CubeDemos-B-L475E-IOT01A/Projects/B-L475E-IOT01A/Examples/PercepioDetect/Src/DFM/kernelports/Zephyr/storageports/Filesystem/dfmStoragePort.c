@@ -7,6 +7,542 @@
 #define DFM_STORAGE_PORT_ALERT_TYPE		0x34561842
 #define DFM_STORAGE_PORT_PAYLOAD_TYPE	0x82713124
 
+#if defined(CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_SINGLE_FILE) && CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_SINGLE_FILE == 1
+
+/* Each alert is stored in one append-only file, "<session>_<alert>", holding the alert entry
+ * followed by its payload entries, each preceded by a DfmStoragePortRecord_t. When the file is
+ * closed a trailer record with the offset of every entry is appended, followed by a footer
+ * pointing at it, so the entries can be read by seeking. Files left without a trailer (e.g. when
+ * the device restarts right after storing a crash alert) are indexed by walking the records. */
+
+#define DFM_STORAGE_PORT_ALERT_PAYLOAD_NUMBER	0
+#define DFM_STORAGE_PORT_TRAILER_ID				0xFFFF
+#define DFM_STORAGE_PORT_FOOTER_MAGIC			0x494D4644 /* "DFMI" */
+
+typedef struct DfmStoragePortRecord
+{
+    uint32_t ulSize;
+    uint16_t usPayloadNumber;
+    uint16_t usChunkIndex;
+} DfmStoragePortRecord_t;
+
+typedef struct DfmStoragePortIndexEntry
+{
+    uint32_t ulOffset;
+    uint16_t usPayloadNumber;
+    uint16_t usChunkIndex;
+} DfmStoragePortIndexEntry_t;
+
+typedef struct DfmStoragePortFooter
+{
+    uint32_t ulTrailerOffset;
+    uint32_t ulMagic;
+} DfmStoragePortFooter_t;
+
+typedef struct DfmStoragePortAlertFile
+{
+    struct fs_file_t xFile;
+    uint32_t ulOpen;
+    uint32_t ulSize;
+    uint32_t ulUnsyncedBytes;
+    uint32_t ulIndexCount;
+    DfmStoragePortIndexEntry_t axIndex[CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_MAX_ENTRIES];
+    char pbPath[64];
+} DfmStoragePortAlertFile_t;
+
+static char pbFileNameBuffer[64];
+static DfmStoragePortData_t* pxStoragePortData;
+static struct fs_dir_t xFsDirHandle;
+static struct fs_dirent xLfsInfo;
+static struct fs_dirent xStatInfo;
+
+static DfmStoragePortAlertFile_t xWriteFile;
+static DfmStoragePortAlertFile_t xReadFile;
+static uint32_t ulReadIndexPosition;
+
+static DfmResult_t prvDfmStoragePortWriteAll(struct fs_file_t* pxFile, const void* pvData, uint32_t ulSize)
+{
+    if (fs_write(pxFile, pvData, ulSize) != (ssize_t)ulSize)
+    {
+        return DFM_FAIL;
+    }
+
+    return DFM_SUCCESS;
+}
+
+static DfmResult_t prvDfmStoragePortReadAt(struct fs_file_t* pxFile, uint32_t ulOffset, void* pvData, uint32_t ulSize)
+{
+    if (fs_seek(pxFile, (off_t)ulOffset, FS_SEEK_SET) != 0)
+    {
+        return DFM_FAIL;
+    }
+
+    if (fs_read(pxFile, pvData, ulSize) != (ssize_t)ulSize)
+    {
+        return DFM_FAIL;
+    }
+
+    return DFM_SUCCESS;
+}
+
+/* Appends the trailer and footer, then closes the alert file that is being written */
+static void prvDfmStoragePortCloseWriteFile(void)
+{
+    DfmStoragePortRecord_t xTrailer;
+    DfmStoragePortFooter_t xFooter;
+
+    if (xWriteFile.ulOpen == 0)
+    {
+        return;
+    }
+
+    xTrailer.ulSize = xWriteFile.ulIndexCount * sizeof(DfmStoragePortIndexEntry_t);
+    xTrailer.usPayloadNumber = DFM_STORAGE_PORT_TRAILER_ID;
+    xTrailer.usChunkIndex = DFM_STORAGE_PORT_TRAILER_ID;
+    xFooter.ulTrailerOffset = xWriteFile.ulSize;
+    xFooter.ulMagic = DFM_STORAGE_PORT_FOOTER_MAGIC;
+
+    /* Without a valid trailer the reader walks the records instead, so failures are not fatal */
+    if (prvDfmStoragePortWriteAll(&xWriteFile.xFile, &xTrailer, sizeof(xTrailer)) == DFM_SUCCESS)
+    {
+        if (prvDfmStoragePortWriteAll(&xWriteFile.xFile, xWriteFile.axIndex, xTrailer.ulSize) == DFM_SUCCESS)
+        {
+            (void)prvDfmStoragePortWriteAll(&xWriteFile.xFile, &xFooter, sizeof(xFooter));
+        }
+    }
+
+    (void)fs_close(&xWriteFile.xFile);
+    xWriteFile.ulOpen = 0;
+}
+
+static DfmResult_t prvDfmStoragePortAppend(DfmEntryHandle_t xEntryHandle, uint16_t usPayloadNumber, uint16_t usChunkIndex)
+{
+    DfmStoragePortRecord_t xRecord;
+    uint32_t ulBytesToWrite = 0;
+
+    if (xDfmEntryGetSize(xEntryHandle, &ulBytesToWrite) == DFM_FAIL)
+    {
+        return DFM_FAIL;
+    }
+
+    if (ulBytesToWrite == 0)
+    {
+        return DFM_FAIL;
+    }
+
+    if (xWriteFile.ulIndexCount >= CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_MAX_ENTRIES)
+    {
+        return DFM_FAIL;
+    }
+
+    xRecord.ulSize = ulBytesToWrite;
+    xRecord.usPayloadNumber = usPayloadNumber;
+    xRecord.usChunkIndex = usChunkIndex;
+
+    if (prvDfmStoragePortWriteAll(&xWriteFile.xFile, &xRecord, sizeof(xRecord)) == DFM_FAIL)
+    {
+        return DFM_FAIL;
+    }
+
+    if (prvDfmStoragePortWriteAll(&xWriteFile.xFile, (void*)xEntryHandle, ulBytesToWrite) == DFM_FAIL)
+    {
+        return DFM_FAIL;
+    }
+
+    xWriteFile.axIndex[xWriteFile.ulIndexCount].ulOffset = xWriteFile.ulSize;
+    xWriteFile.axIndex[xWriteFile.ulIndexCount].usPayloadNumber = usPayloadNumber;
+    xWriteFile.axIndex[xWriteFile.ulIndexCount].usChunkIndex = usChunkIndex;
+    xWriteFile.ulIndexCount++;
+
+    xWriteFile.ulSize += sizeof(xRecord) + ulBytesToWrite;
+    xWriteFile.ulUnsyncedBytes += sizeof(xRecord) + ulBytesToWrite;
+
+    return DFM_SUCCESS;
+}
+
+static DfmResult_t prvDfmStoragePortSync(void)
+{
+    if (fs_sync(&xWriteFile.xFile) != 0)
+    {
+        return DFM_FAIL;
+    }
+
+    xWriteFile.ulUnsyncedBytes = 0;
+
+    return DFM_SUCCESS;
+}
+
+/* Loads the index of the alert file opened for reading, from its trailer if it has one */
+static DfmResult_t prvDfmStoragePortLoadReadIndex(void)
+{
+    struct fs_dirent xEntry;
+    DfmStoragePortRecord_t xRecord;
+    DfmStoragePortFooter_t xFooter;
+    uint32_t ulFileSize;
+    uint32_t ulOffset = 0;
+
+    xReadFile.ulIndexCount = 0;
+
+    if (fs_stat(xReadFile.pbPath, &xEntry) != 0)
+    {
+        return DFM_FAIL;
+    }
+    ulFileSize = (uint32_t)xEntry.size;
+
+    if ((ulFileSize >= sizeof(xFooter)) &&
+        (prvDfmStoragePortReadAt(&xReadFile.xFile, ulFileSize - sizeof(xFooter), &xFooter, sizeof(xFooter)) == DFM_SUCCESS) &&
+        (xFooter.ulMagic == DFM_STORAGE_PORT_FOOTER_MAGIC) &&
+        (xFooter.ulTrailerOffset + sizeof(xRecord) <= ulFileSize) &&
+        (prvDfmStoragePortReadAt(&xReadFile.xFile, xFooter.ulTrailerOffset, &xRecord, sizeof(xRecord)) == DFM_SUCCESS) &&
+        (xRecord.usPayloadNumber == DFM_STORAGE_PORT_TRAILER_ID) &&
+        (xRecord.ulSize <= sizeof(xReadFile.axIndex)) &&
+        (fs_read(&xReadFile.xFile, xReadFile.axIndex, xRecord.ulSize) == (ssize_t)xRecord.ulSize))
+    {
+        xReadFile.ulIndexCount = xRecord.ulSize / sizeof(DfmStoragePortIndexEntry_t);
+
+        return DFM_SUCCESS;
+    }
+
+    /* No trailer, walk the record headers and stop at the first incomplete record */
+    while ((ulOffset + sizeof(xRecord)) <= ulFileSize)
+    {
+        if (prvDfmStoragePortReadAt(&xReadFile.xFile, ulOffset, &xRecord, sizeof(xRecord)) == DFM_FAIL)
+        {
+            break;
+        }
+
+        if ((xRecord.usPayloadNumber == DFM_STORAGE_PORT_TRAILER_ID) || (xRecord.ulSize > (ulFileSize - ulOffset - sizeof(xRecord))))
+        {
+            break;
+        }
+
+        if (xReadFile.ulIndexCount >= CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_MAX_ENTRIES)
+        {
+            break;
+        }
+
+        xReadFile.axIndex[xReadFile.ulIndexCount].ulOffset = ulOffset;
+        xReadFile.axIndex[xReadFile.ulIndexCount].usPayloadNumber = xRecord.usPayloadNumber;
+        xReadFile.axIndex[xReadFile.ulIndexCount].usChunkIndex = xRecord.usChunkIndex;
+        xReadFile.ulIndexCount++;
+
+        ulOffset += sizeof(xRecord) + xRecord.ulSize;
+    }
+
+    return (xReadFile.ulIndexCount > 0) ? DFM_SUCCESS : DFM_FAIL;
+}
+
+/* Reads the entry at the given index position of the alert file opened for reading */
+static DfmResult_t prvDfmStoragePortReadEntry(uint32_t ulPosition, void* pvBuffer, uint32_t ulBufferSize)
+{
+    DfmStoragePortRecord_t xRecord;
+
+    if (ulPosition >= xReadFile.ulIndexCount)
+    {
+        return DFM_FAIL;
+    }
+
+    if (prvDfmStoragePortReadAt(&xReadFile.xFile, xReadFile.axIndex[ulPosition].ulOffset, &xRecord, sizeof(xRecord)) == DFM_FAIL)
+    {
+        return DFM_FAIL;
+    }
+
+    if (xRecord.ulSize > ulBufferSize)
+    {
+        return DFM_FAIL;
+    }
+
+    if (fs_read(&xReadFile.xFile, pvBuffer, xRecord.ulSize) != (ssize_t)xRecord.ulSize)
+    {
+        return DFM_FAIL;
+    }
+
+    return DFM_SUCCESS;
+}
+
+/* Closes and removes the alert file that was read last */
+static void prvDfmStoragePortRemoveReadFile(void)
+{
+    if (xReadFile.ulOpen == 0)
+    {
+        return;
+    }
+
+    (void)fs_close(&xReadFile.xFile);
+    (void)fs_unlink(xReadFile.pbPath);
+    xReadFile.ulOpen = 0;
+}
+
+DfmResult_t xDfmStoragePortInitialize(DfmStoragePortData_t *pxBuffer)
+{
+    /* Check if the alerts directory exists, handle issues with it being nonexistant*/
+    int32_t result = fs_stat(CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_PATH "/alerts", &xStatInfo);
+    if (result != 0)
+    {
+        if (result != -ENOENT)
+        {
+            return DFM_FAIL;
+        }
+
+        result = fs_mkdir(CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_PATH "/alerts");
+        if (result != 0)
+        {
+            return DFM_FAIL;
+        }
+        result = fs_stat(CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_PATH "/alerts", &xStatInfo);
+
+        if (result != 0)
+        {
+            return DFM_FAIL;
+        }
+    }
+
+    /* Verify that "CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_PATH/alerts" actually is a directory */
+    if (xStatInfo.type != FS_DIR_ENTRY_DIR)
+    {
+        return DFM_FAIL;
+    }
+
+    xWriteFile.ulOpen = 0;
+    xReadFile.ulOpen = 0;
+
+    pxStoragePortData = pxBuffer;
+    pxStoragePortData->ulInitialized = 1;
+    pxStoragePortData->ulOngoingTraversal = 0;
+    return DFM_SUCCESS;
+}
+
+DfmResult_t xDfmStoragePortStoreAlert(DfmEntryHandle_t xEntryHandle, uint32_t ulOverwrite)
+{
+    const char* pbUniqueSessionid;
+    uint32_t ulDfmAlertId;
+
+    (void)ulOverwrite;
+
+    if (pxStoragePortData == (void*)0)
+    {
+        return DFM_FAIL;
+    }
+
+    if (pxStoragePortData->ulInitialized == 0)
+    {
+        return DFM_FAIL;
+    }
+
+    if (xEntryHandle == 0)
+    {
+        return DFM_FAIL;
+    }
+
+    /* The previous alert is complete */
+    prvDfmStoragePortCloseWriteFile();
+
+    (void)xDfmEntryGetSessionId(xEntryHandle, &pbUniqueSessionid);
+    (void)xDfmEntryGetAlertId(xEntryHandle, &ulDfmAlertId);
+
+    snprintf(xWriteFile.pbPath, sizeof(xWriteFile.pbPath), CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_PATH "/alerts/%s_%lu", pbUniqueSessionid, ulDfmAlertId);
+
+    /* Remove any stale file with the same name, fs_open doesn't truncate */
+    (void)fs_unlink(xWriteFile.pbPath);
+
+    fs_file_t_init(&xWriteFile.xFile);
+    if (fs_open(&xWriteFile.xFile, xWriteFile.pbPath, (0x00000000 | FS_O_WRITE | FS_O_CREATE)) != 0)
+    {
+        return DFM_FAIL;
+    }
+
+    xWriteFile.ulOpen = 1;
+    xWriteFile.ulSize = 0;
+    xWriteFile.ulUnsyncedBytes = 0;
+    xWriteFile.ulIndexCount = 0;
+
+    if (prvDfmStoragePortAppend(xEntryHandle, DFM_STORAGE_PORT_ALERT_PAYLOAD_NUMBER, 0) == DFM_FAIL)
+    {
+        return DFM_FAIL;
+    }
+
+    return prvDfmStoragePortSync();
+}
+
+DfmResult_t xDfmStoragePortStorePayloadChunk(DfmEntryHandle_t xEntryHandle, uint32_t ulOverwrite)
+{
+    const char* pbUniqueSessionid;
+    uint32_t ulAlertId;
+    uint16_t usPayloadNum;
+    uint16_t usChunkIndex;
+    uint16_t usChunkCount;
+    uint16_t usEntryType;
+
+    (void)ulOverwrite;
+
+    if (pxStoragePortData == (void*)0)
+    {
+        return DFM_FAIL;
+    }
+
+    if (pxStoragePortData->ulInitialized == 0)
+    {
+        return DFM_FAIL;
+    }
+
+    if (xEntryHandle == 0)
+    {
+        return DFM_FAIL;
+    }
+
+    if (xWriteFile.ulOpen == 0)
+    {
+        return DFM_FAIL;
+    }
+
+    (void)xDfmEntryGetAlertId(xEntryHandle, &ulAlertId);
+    (void)xDfmEntryGetSessionId(xEntryHandle, &pbUniqueSessionid);
+
+    /* Payloads are always stored right after their alert, which is the file being written */
+    snprintf(pbFileNameBuffer, sizeof(pbFileNameBuffer), CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_PATH "/alerts/%s_%lu", pbUniqueSessionid, ulAlertId);
+    if (strncmp(pbFileNameBuffer, xWriteFile.pbPath, sizeof(pbFileNameBuffer)) != 0)
+    {
+        return DFM_FAIL;
+    }
+
+    (void)xDfmEntryGetEntryId(xEntryHandle, &usPayloadNum);
+    (void)xDfmEntryGetChunkIndex(xEntryHandle, &usChunkIndex);
+    (void)xDfmEntryGetChunkCount(xEntryHandle, &usChunkCount);
+    (void)xDfmEntryGetType(xEntryHandle, &usEntryType);
+
+    if (usEntryType == DFM_ENTRY_TYPE_PAYLOAD_HEADER)
+    {
+        usChunkIndex = 0;
+    }
+
+    if (prvDfmStoragePortAppend(xEntryHandle, usPayloadNum, usChunkIndex) == DFM_FAIL)
+    {
+        return DFM_FAIL;
+    }
+
+    /* Commit when a payload is complete, and in between when enough data is pending */
+    if (((usEntryType != DFM_ENTRY_TYPE_PAYLOAD_HEADER) && (usChunkIndex == usChunkCount)) ||
+        ((CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_SYNC_BYTES > 0) && (xWriteFile.ulUnsyncedBytes >= CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_SYNC_BYTES)))
+    {
+        return prvDfmStoragePortSync();
+    }
+
+    return DFM_SUCCESS;
+}
+
+DfmResult_t xDfmStoragePortGetAlert(void* pvBuffer, uint32_t ulBufferSize)
+{
+    DfmEntryHandle_t xEntryHandle = 0;
+    int32_t lFsResult;
+
+    if (pxStoragePortData == (void*)0)
+    {
+        return DFM_FAIL;
+    }
+
+    if (pxStoragePortData->ulInitialized == 0)
+    {
+        return DFM_FAIL;
+    }
+
+    if (pvBuffer == (void*)0)
+    {
+        return DFM_FAIL;
+    }
+
+    if (ulBufferSize == 0)
+    {
+        return DFM_FAIL;
+    }
+
+    /* The alert being written may be read now, so finish it */
+    prvDfmStoragePortCloseWriteFile();
+
+    /* If no ongoing traversal is ongoing, traverse the alert folder to check for new alerts to send */
+    if (pxStoragePortData->ulOngoingTraversal == 0)
+    {
+        fs_dir_t_init(&xFsDirHandle);
+        lFsResult = fs_opendir(&xFsDirHandle, CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_PATH "/alerts");
+        if (lFsResult != 0)
+        {
+            return DFM_FAIL;
+        }
+        pxStoragePortData->ulOngoingTraversal = 1;
+    }
+    else
+    {
+        /* If we have handled a previous alert, it's time to remove it */
+        prvDfmStoragePortRemoveReadFile();
+    }
+
+    while (xDfmEntryCreateAlertFromBuffer(&xEntryHandle) == DFM_FAIL)
+    {
+        prvDfmStoragePortRemoveReadFile();
+
+        do {
+            lFsResult = fs_readdir(&xFsDirHandle, &xLfsInfo);
+
+            /* We're done, no more alerts available*/
+            if (lFsResult < 0 || (lFsResult == 0 && xLfsInfo.name[0] == 0))
+            {
+                pxStoragePortData->ulOngoingTraversal = 0;
+                fs_closedir(&xFsDirHandle);
+                return DFM_FAIL;
+            }
+            /* Ignore . and .., and directories left by the per-chunk file layout */
+        } while (strncmp(xLfsInfo.name, ".", sizeof(xLfsInfo.name)) == 0 || strncmp(xLfsInfo.name, "..", sizeof(xLfsInfo.name)) == 0 || xLfsInfo.type != FS_DIR_ENTRY_FILE);
+
+        snprintf(xReadFile.pbPath, sizeof(xReadFile.pbPath), CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FILESYSTEM_PATH "/alerts/%s", xLfsInfo.name);
+
+        fs_file_t_init(&xReadFile.xFile);
+        if (fs_open(&xReadFile.xFile, xReadFile.pbPath, (0x00000000 | FS_O_READ)) != 0)
+        {
+            return DFM_FAIL;
+        }
+        xReadFile.ulOpen = 1;
+
+        /* The alert entry is always the first record. Files that can't be read are removed on the next pass. */
+        if (prvDfmStoragePortLoadReadIndex() == DFM_FAIL)
+        {
+            continue;
+        }
+
+        if (xReadFile.axIndex[0].usPayloadNumber != DFM_STORAGE_PORT_ALERT_PAYLOAD_NUMBER)
+        {
+            continue;
+        }
+
+        (void)prvDfmStoragePortReadEntry(0, pvBuffer, ulBufferSize);
+    }
+
+    ulReadIndexPosition = 1;
+
+    return DFM_SUCCESS;
+}
+
+DfmResult_t xDfmStoragePortGetPayloadChunk(char* szSessionId, uint32_t ulAlertId, void* pvBuffer, uint32_t ulBufferSize)
+{
+    (void)szSessionId;
+    (void)ulAlertId;
+
+    if (xReadFile.ulOpen == 0)
+    {
+        return DFM_FAIL;
+    }
+
+    /* The alert file read by xDfmStoragePortGetAlert() holds this alert's payloads, in order */
+    if (prvDfmStoragePortReadEntry(ulReadIndexPosition, pvBuffer, ulBufferSize) == DFM_FAIL)
+    {
+        return DFM_FAIL;
+    }
+
+    ulReadIndexPosition++;
+
+    return DFM_SUCCESS;
+}
+
+#else
+
 static char pbFileNameBuffer[64];
 static char pbCurrentReadDirectory[64];
 static DfmStoragePortData_t* pxStoragePortData;
@@ -355,6 +891,8 @@ DfmResult_t xDfmStoragePortGetPayloadChunk(char* szSessionId, uint32_t ulAlertId
     return DFM_SUCCESS;
 }
 
+#endif
+
 DfmResult_t xDfmStoragePortStoreSession(void* pvData, uint32_t ulSize)
 {
     (void)pvData;
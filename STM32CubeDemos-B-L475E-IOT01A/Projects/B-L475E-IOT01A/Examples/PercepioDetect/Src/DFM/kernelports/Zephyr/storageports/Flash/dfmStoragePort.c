@@ -58,6 +58,7 @@ typedef struct DfmStorageMetadata {
 
 #define DFM_STORAGE_PORT_ALERT_TYPE		0x34561842
 #define DFM_STORAGE_PORT_PAYLOAD_TYPE	0x82713124
+#define DFM_STORAGE_PORT_SENT_TYPE		0x53454E54
 
 DfmResult_t prvDfmStoragePortWrite(DfmEntryHandle_t xEntryHandle, uint32_t ulType, uint32_t ulOverwrite);
 
@@ -83,14 +84,45 @@ typedef struct DfmWalkData
 
 static DfmStoragePortData_t* pxStoragePortData;
 
-typedef struct DfmTraversionState {
-	struct fcb_entry_ctx xEntryCtx;
-	uint8_t ucIsDirty;
-} DfmTraversionState_t;
+#define DFM_STORAGE_PORT_INDEX_ALERT_FREE		0
+#define DFM_STORAGE_PORT_INDEX_ALERT_STORED		1
+#define DFM_STORAGE_PORT_INDEX_ALERT_SENT		2
 
-static DfmTraversionState_t xTraversionState = {
-	.xEntryCtx = {}
-};
+ /**
+  * @internal DFM index entry, one for every stored alert or payload entry, in flash order
+  */
+typedef struct DfmStorageIndexRecord {
+	struct fcb_entry xLocation;								/**< Location of the first FCB entry */
+	uint16_t usType;										/**< DFM entry type */
+	uint16_t usPayloadNumber;								/**< Payload number, 0 for alerts */
+	uint16_t usChunkIndex;									/**< Chunk index */
+	uint16_t usAlertSlot;									/**< Index in xIndexAlerts */
+} DfmStorageIndexRecord_t;
+
+ /**
+  * @internal DFM index alert, one for every alert that has entries in the FCB
+  */
+typedef struct DfmStorageIndexAlert {
+	char cSessionId[DFM_SESSION_ID_MAX_LEN];
+	uint32_t ulAlertId;
+	uint16_t usRecordsRead;									/**< Payload entries read since the alert was read */
+	uint16_t usState;										/**< DFM_STORAGE_PORT_INDEX_ALERT_* */
+} DfmStorageIndexAlert_t;
+
+ /**
+  * @internal DFM sent record, written after the last entry of an alert has been sent so it isn't sent again after a restart
+  */
+typedef struct DfmStorageSentRecord {
+	char cSessionId[DFM_SESSION_ID_MAX_LEN];
+	uint32_t ulAlertId;
+} __attribute__((aligned(8))) DfmStorageSentRecord_t;
+
+static DfmStorageIndexRecord_t xIndexRecords[CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FCB_INDEX_MAX_ENTRIES];
+static DfmStorageIndexAlert_t xIndexAlerts[CONFIG_PERCEPIO_DFM_CFG_STORAGE_PORT_FCB_INDEX_MAX_ALERTS];
+static uint32_t ulIndexRecordCount = 0;
+
+/* Index of the record after the alert that was read last, where the next xDfmStoragePortGetAlert() continues */
+static uint32_t ulIndexAlertCursor = 0;
 
 /**
  * Verify the metadata header, making sure that the data being held in the current entry matches what was expected
@@ -131,110 +163,409 @@ static int prvVerifyMetadata(DfmStorageMetadata_t* pxFlashMetadata, DfmWalkData_
 }
 
 /**
- * Get the next payload chunk/alert from the fcb. This can mean reading multiple fcb entries.
+ * Read a complete alert/payload chunk, which can span multiple fcb entries, without modifying the fcb.
  * @param pxFcb Pointer to the struct which describes the FCB
- * @param pxTraversionState A container object for keeping the fcb context, needed between the traversions
- * @param pvBuffer The buffer containing the current alert/payload chunk which is supposed to be retrieved
+ * @param pxLocation The location of the first fcb entry
+ * @param pvBuffer The buffer to read the alert/payload chunk into
  * @param ulBufferSize Size of the aforementioned buffer
  * @return 0 => success, !0 => fail
  */
-static int prvDfmGetNext(struct fcb *pxFcb, DfmTraversionState_t* pxTraversionState, void* pvBuffer, uint32_t ulBufferSize)
+static int prvDfmReadEntry(struct fcb *pxFcb, const struct fcb_entry* pxLocation, void* pvBuffer, uint32_t ulBufferSize)
 {
 	DfmWalkData_t xWalkData = { 0 };
-	void* pvStartSector = NULL;
-	int lWalkResult = 0;
-	int lReadResult = 0;
-
-	if (pxTraversionState->xEntryCtx.loc.fe_sector == NULL)
-		pvStartSector = (void*)pxFcb->f_oldest;
-	else
-		pvStartSector = (void*)pxTraversionState->xEntryCtx.loc.fe_sector;
+	struct fcb_entry xLocation = *pxLocation;
 
 	while (1)
 	{
-		lWalkResult = fcb_getnext(pxFcb, &pxTraversionState->xEntryCtx.loc);
-		pxTraversionState->xEntryCtx.fap = pxFcb->fap;
+		/* Start by reading the metadata */
+		if (flash_area_read(pxFcb->fap, FCB_ENTRY_FA_DATA_OFF(xLocation), &xDfmFlashMetadata, sizeof(DfmStorageMetadata_t)) != 0)
+		{
+			return -1;
+		}
 
-		if (lWalkResult == -ENOTSUP)
+		if (xWalkData.usExpectedEntryId == 0)
 		{
-			if (pxTraversionState->ucIsDirty)
-			{
-				fcb_rotate(pxFcb);
-			}
+			xWalkData.ulCurrentType = xDfmFlashMetadata.ulType;
+			xWalkData.usExpectedEntryCount = xDfmFlashMetadata.usEntryCount;
+		}
 
-			/* Reset the traversion context, we've traversed the FCB */
-			memset(&xTraversionState, 0, sizeof(DfmTraversionState_t));
+		if (prvVerifyMetadata(&xDfmFlashMetadata, &xWalkData, ulBufferSize) != 0)
+		{
+			return -1;
+		}
 
+		/* Read the actual data */
+		/* TODO: 64bit compatiblity */
+		if (flash_area_read(pxFcb->fap, FCB_ENTRY_FA_DATA_OFF(xLocation) + sizeof(DfmStorageMetadata_t), (void*)((uint32_t)pvBuffer + xWalkData.ulOffset), xDfmFlashMetadata.ulDataSize) != 0)
+		{
 			return -1;
 		}
 
-		pxTraversionState->ucIsDirty = 1;
+		xWalkData.usExpectedEntryId++;
+		xWalkData.ulOffset += xDfmFlashMetadata.ulDataSize;
 
-		if (pvStartSector != pxTraversionState->xEntryCtx.loc.fe_sector)
+		if (xWalkData.usExpectedEntryId == xWalkData.usExpectedEntryCount)
 		{
-			/* We've entered a new sector, increase the counter */
-			/* Since we've traversed the previous block, we can now rotate it */
-			fcb_rotate(pxFcb);
+			/* Found the entire alert/payload chunk */
+			return 0;
 		}
 
-		/* Start by reading the metadata */
-		lReadResult = flash_area_read(
-			pxTraversionState->xEntryCtx.fap,
-			FCB_ENTRY_FA_DATA_OFF(pxTraversionState->xEntryCtx.loc),
-			&xDfmFlashMetadata,
-			sizeof(DfmStorageMetadata_t)
-		);
-
-		if (lReadResult != 0)
-		{
-			/* Read failed, reset the buffer and continue */
-			memset(pvBuffer, 0, ulBufferSize);
-			memset(&xWalkData, 0, sizeof(DfmWalkData_t));
-			continue;
+		/* The remaining parts are always stored in the following fcb entries */
+		if (fcb_getnext(pxFcb, &xLocation) != 0)
+		{
+			return -1;
 		}
+	}
+}
 
-		if (prvVerifyMetadata(&xDfmFlashMetadata, &xWalkData, ulBufferSize) != 0)
+static int32_t prvDfmIndexFindAlert(const char* szSessionId, uint32_t ulAlertId)
+{
+	int32_t i;
+
+	for (i = 0; i < ARRAY_SIZE(xIndexAlerts); i++)
+	{
+		if ((xIndexAlerts[i].usState != DFM_STORAGE_PORT_INDEX_ALERT_FREE) &&
+			(xIndexAlerts[i].ulAlertId == ulAlertId) &&
+			(strncmp(xIndexAlerts[i].cSessionId, szSessionId, sizeof(xIndexAlerts[i].cSessionId)) == 0))
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+static int32_t prvDfmIndexFindFreeAlert(void)
+{
+	int32_t i;
+
+	for (i = 0; i < ARRAY_SIZE(xIndexAlerts); i++)
+	{
+		if (xIndexAlerts[i].usState == DFM_STORAGE_PORT_INDEX_ALERT_FREE)
+		{
+			return i;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Check that an entry can be indexed, and find the alert it belongs to
+ * @param xEntryHandle The entry
+ * @param plAlertSlot Set to the index in xIndexAlerts, or -1 if a new alert slot is needed
+ * @return 0 => success, !0 => fail
+ */
+static int prvDfmIndexPrepare(DfmEntryHandle_t xEntryHandle, int32_t* plAlertSlot)
+{
+	const char* szSessionId = (void*)0;
+	uint32_t ulAlertId = 0;
+	uint16_t usType = 0;
+
+	if (ulIndexRecordCount >= ARRAY_SIZE(xIndexRecords))
+	{
+		return -1;
+	}
+
+	if ((xDfmEntryGetType(xEntryHandle, &usType) == DFM_FAIL) ||
+		(xDfmEntryGetSessionId(xEntryHandle, &szSessionId) == DFM_FAIL) ||
+		(xDfmEntryGetAlertId(xEntryHandle, &ulAlertId) == DFM_FAIL))
+	{
+		return -1;
+	}
+
+	*plAlertSlot = prvDfmIndexFindAlert(szSessionId, ulAlertId);
+
+	if (usType == (uint16_t)DFM_ENTRY_TYPE_ALERT)
+	{
+		if (*plAlertSlot >= 0)
+		{
+			/* The same alert has already been stored */
+			return -1;
+		}
+
+		if (prvDfmIndexFindFreeAlert() < 0)
+		{
+			return -1;
+		}
+	}
+	else if (*plAlertSlot < 0)
+	{
+		/* The payload doesn't belong to any stored alert */
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Add an entry that is stored in the fcb to the index
+ * @param pxLocation The location of the first fcb entry
+ * @param xEntryHandle The entry
+ * @return 0 => success, !0 => fail
+ */
+static int prvDfmIndexAdd(const struct fcb_entry* pxLocation, DfmEntryHandle_t xEntryHandle)
+{
+	DfmStorageIndexRecord_t* pxRecord;
+	const char* szSessionId = (void*)0;
+	int32_t lAlertSlot = -1;
+
+	if (prvDfmIndexPrepare(xEntryHandle, &lAlertSlot) != 0)
+	{
+		return -1;
+	}
+
+	pxRecord = &xIndexRecords[ulIndexRecordCount];
+	pxRecord->xLocation = *pxLocation;
+
+	if ((xDfmEntryGetType(xEntryHandle, &pxRecord->usType) == DFM_FAIL) ||
+		(xDfmEntryGetChunkIndex(xEntryHandle, &pxRecord->usChunkIndex) == DFM_FAIL))
+	{
+		return -1;
+	}
+
+	if (pxRecord->usType == (uint16_t)DFM_ENTRY_TYPE_ALERT)
+	{
+		lAlertSlot = prvDfmIndexFindFreeAlert();
+
+		(void)xDfmEntryGetSessionId(xEntryHandle, &szSessionId);
+		(void)xDfmEntryGetAlertId(xEntryHandle, &xIndexAlerts[lAlertSlot].ulAlertId);
+		strncpy(xIndexAlerts[lAlertSlot].cSessionId, szSessionId, sizeof(xIndexAlerts[lAlertSlot].cSessionId) - 1U);
+		xIndexAlerts[lAlertSlot].cSessionId[sizeof(xIndexAlerts[lAlertSlot].cSessionId) - 1U] = (char)0;
+		xIndexAlerts[lAlertSlot].usRecordsRead = 0;
+		xIndexAlerts[lAlertSlot].usState = DFM_STORAGE_PORT_INDEX_ALERT_STORED;
+
+		pxRecord->usPayloadNumber = 0;
+	}
+	else if (xDfmEntryGetEntryId(xEntryHandle, &pxRecord->usPayloadNumber) == DFM_FAIL)
+	{
+		return -1;
+	}
+
+	pxRecord->usAlertSlot = (uint16_t)lAlertSlot;
+	ulIndexRecordCount++;
+
+	return 0;
+}
+
+/**
+ * Remove the index records of the oldest fcb sector, which is about to be erased by fcb_rotate()
+ * @param pxFcb Pointer to the struct which describes the FCB
+ */
+static void prvDfmIndexRemoveOldestSector(struct fcb *pxFcb)
+{
+	uint32_t ulRemoved = 0;
+	int32_t i;
+	uint32_t j;
+
+	/* Records are kept in flash order, so the oldest sector's records come first */
+	while ((ulRemoved < ulIndexRecordCount) && (xIndexRecords[ulRemoved].xLocation.fe_sector == pxFcb->f_oldest))
+	{
+		if (xIndexRecords[ulRemoved].usType == (uint16_t)DFM_ENTRY_TYPE_ALERT)
+		{
+			/* Whatever remains of an overwritten alert can't be sent, don't let it block rotation */
+			xIndexAlerts[xIndexRecords[ulRemoved].usAlertSlot].usState = DFM_STORAGE_PORT_INDEX_ALERT_SENT;
+		}
+
+		ulRemoved++;
+	}
+
+	if (ulRemoved == 0)
+	{
+		return;
+	}
+
+	memmove(&xIndexRecords[0], &xIndexRecords[ulRemoved], (ulIndexRecordCount - ulRemoved) * sizeof(DfmStorageIndexRecord_t));
+	ulIndexRecordCount -= ulRemoved;
+
+	ulIndexAlertCursor = (ulIndexAlertCursor > ulRemoved) ? (ulIndexAlertCursor - ulRemoved) : 0;
+
+	/* Free alerts that no longer have any records */
+	for (i = 0; i < ARRAY_SIZE(xIndexAlerts); i++)
+	{
+		for (j = 0; j < ulIndexRecordCount; j++)
 		{
-			/* Start over, this will always happen at the first read, only on failure for subsequent reads */
-			if (xDfmFlashMetadata.usEntryId == 0) {
-				xWalkData.ulCurrentType = xDfmFlashMetadata.ulType;
-				xWalkData.usExpectedEntryId = 0;
-				xWalkData.usExpectedEntryCount = xDfmFlashMetadata.usEntryCount;
-				xWalkData.ulOffset = 0;
+			if (xIndexRecords[j].usAlertSlot == (uint16_t)i)
+			{
+				break;
 			}
-			else
+		}
+
+		if (j == ulIndexRecordCount)
+		{
+			xIndexAlerts[i].usState = DFM_STORAGE_PORT_INDEX_ALERT_FREE;
+		}
+	}
+}
+
+/**
+ * Erase the oldest fcb sectors as long as they only hold alerts that have been sent
+ * @param pxFcb Pointer to the struct which describes the FCB
+ */
+static void prvDfmRotateSent(struct fcb *pxFcb)
+{
+	uint32_t i;
+
+	while (1)
+	{
+		/* Records are kept in flash order, so only the first records can start in the oldest sector */
+		for (i = 0; (i < ulIndexRecordCount) && (xIndexRecords[i].xLocation.fe_sector == pxFcb->f_oldest); i++)
+		{
+			if (xIndexAlerts[xIndexRecords[i].usAlertSlot].usState != DFM_STORAGE_PORT_INDEX_ALERT_SENT)
 			{
-				memset(&xWalkData, 0, sizeof(DfmWalkData_t));
-				continue;
+				return;
 			}
 		}
 
-		/* Read the actual data */
-		/* TODO: 64bit compatiblity */
-		lReadResult = flash_area_read(
-			pxTraversionState->xEntryCtx.fap,
-			FCB_ENTRY_FA_DATA_OFF(pxTraversionState->xEntryCtx.loc) + sizeof(DfmStorageMetadata_t),
-			(void*)((uint32_t)pvBuffer + xWalkData.ulOffset),
-			xDfmFlashMetadata.ulDataSize
-		);
-
-		if (lReadResult != 0)
-		{
-			/* Read failed, reset the buffer and continue */
-			memset(pvBuffer, 0, ulBufferSize);
-			memset(&xWalkData, 0, sizeof(DfmWalkData_t));
+		if ((pxFcb->f_oldest == pxFcb->f_active.fe_sector) && ((i == 0) || (i < ulIndexRecordCount)))
+		{
+			/* Only erase the sector being written when everything in it has been sent */
+			return;
+		}
+
+		prvDfmIndexRemoveOldestSector(pxFcb);
+
+		if (fcb_rotate(pxFcb) != 0)
+		{
+			return;
+		}
+
+		if (ulIndexRecordCount == 0)
+		{
+			return;
+		}
+	}
+}
+
+/**
+ * Append a sent record for an alert, so it stays sent after a restart
+ * @param pxFcb Pointer to the struct which describes the FCB
+ * @param pxAlert The alert that has been sent
+ * @return 0 => success, !0 => fail
+ */
+static int prvDfmWriteSentRecord(struct fcb *pxFcb, const DfmStorageIndexAlert_t* pxAlert)
+{
+	DfmStorageSentRecord_t xSentRecord = { 0 };
+	struct fcb_entry xLocation = { 0 };
+
+	memcpy(xSentRecord.cSessionId, pxAlert->cSessionId, sizeof(xSentRecord.cSessionId));
+	xSentRecord.ulAlertId = pxAlert->ulAlertId;
+
+	xDfmFlashMetadata.ucStartMarker[0] = 0x44;	/* 'D' */
+	xDfmFlashMetadata.ucStartMarker[1] = 0x46;	/* 'F' */
+	xDfmFlashMetadata.ucStartMarker[2] = 0x6C;	/* 'l' */
+	xDfmFlashMetadata.ucStartMarker[3] = 0x61;	/* 'a' */
+	xDfmFlashMetadata.ulType = DFM_STORAGE_PORT_SENT_TYPE;
+	xDfmFlashMetadata.usEntryId = 0;
+	xDfmFlashMetadata.usEntryCount = 1;
+	xDfmFlashMetadata.ulDataSize = sizeof(DfmStorageSentRecord_t);
+
+	/* Without room the alert is sent again after a restart, which is better than erasing unsent alerts */
+	if (fcb_append(pxFcb, (uint16_t)(sizeof(DfmStorageMetadata_t) + sizeof(DfmStorageSentRecord_t)), &xLocation) != 0)
+	{
+		return -1;
+	}
+
+	if (flash_area_write(pxFcb->fap, FCB_ENTRY_FA_DATA_OFF(xLocation), &xDfmFlashMetadata, sizeof(DfmStorageMetadata_t)) != 0)
+	{
+		return -1;
+	}
+
+	if (flash_area_write(pxFcb->fap, FCB_ENTRY_FA_DATA_OFF(xLocation) + sizeof(DfmStorageMetadata_t), &xSentRecord, sizeof(DfmStorageSentRecord_t)) != 0)
+	{
+		return -1;
+	}
+
+	if (fcb_append_finish(pxFcb, &xLocation) != 0)
+	{
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+ * Mark the alert of a sent record as sent in the index
+ * @param pxFcb Pointer to the struct which describes the FCB
+ * @param pxLocation The location of the sent record
+ */
+static void prvDfmIndexReadSentRecord(struct fcb *pxFcb, const struct fcb_entry* pxLocation)
+{
+	DfmStorageSentRecord_t xSentRecord = { 0 };
+	int32_t lAlertSlot;
+
+	if (xDfmFlashMetadata.ulDataSize != sizeof(DfmStorageSentRecord_t))
+	{
+		return;
+	}
+
+	if (flash_area_read(pxFcb->fap, FCB_ENTRY_FA_DATA_OFF(*pxLocation) + sizeof(DfmStorageMetadata_t), &xSentRecord, sizeof(DfmStorageSentRecord_t)) != 0)
+	{
+		return;
+	}
+
+	xSentRecord.cSessionId[sizeof(xSentRecord.cSessionId) - 1U] = (char)0;
+
+	/* Always after the alert in flash, so the alert is already indexed unless its sector was erased */
+	lAlertSlot = prvDfmIndexFindAlert(xSentRecord.cSessionId, xSentRecord.ulAlertId);
+	if (lAlertSlot >= 0)
+	{
+		xIndexAlerts[lAlertSlot].usState = DFM_STORAGE_PORT_INDEX_ALERT_SENT;
+	}
+}
+
+/**
+ * Build the index from the entries in the fcb
+ * @param pxFcb Pointer to the struct which describes the FCB
+ */
+static void prvDfmIndexBuild(struct fcb *pxFcb)
+{
+	struct fcb_entry xLocation = { 0 };
+	void* pvBuffer = (void*)0;
+	uint32_t ulBufferSize = 0;
+
+	memset(xIndexAlerts, 0, sizeof(xIndexAlerts));
+	ulIndexRecordCount = 0;
+	ulIndexAlertCursor = 0;
+
+	/* The Entry buffer isn't used by anything else during initialization */
+	if (xDfmEntryGetBuffer(&pvBuffer, &ulBufferSize) == DFM_FAIL)
+	{
+		return;
+	}
+
+	while (fcb_getnext(pxFcb, &xLocation) == 0)
+	{
+		if (flash_area_read(pxFcb->fap, FCB_ENTRY_FA_DATA_OFF(xLocation), &xDfmFlashMetadata, sizeof(DfmStorageMetadata_t)) != 0)
+		{
 			continue;
 		}
 
-		xWalkData.usExpectedEntryId++;
-		xWalkData.ulOffset += xDfmFlashMetadata.ulDataSize;
+		if (xDfmFlashMetadata.ulType == DFM_STORAGE_PORT_SENT_TYPE)
+		{
+			prvDfmIndexReadSentRecord(pxFcb, &xLocation);
+			continue;
+		}
 
-		if (xWalkData.usExpectedEntryId == xWalkData.usExpectedEntryCount)
+		if (xDfmFlashMetadata.usEntryId != 0)
 		{
-			/* Found the entire alert/payload chunk */
-			return 0;
+			/* Not the first part of an entry */
+			continue;
+		}
+
+		if (prvDfmReadEntry(pxFcb, &xLocation, pvBuffer, ulBufferSize) != 0)
+		{
+			continue;
 		}
+
+		/* Entries that can't be indexed will be erased along with their sector once the other alerts are sent */
+		(void)prvDfmIndexAdd(&xLocation, (DfmEntryHandle_t)pvBuffer);
 	}
+
+	memset(pvBuffer, 0, ulBufferSize);
+
+	/* Reclaim the space of alerts that were sent before the restart */
+	prvDfmRotateSent(pxFcb);
 }
 
 /* This function is used to avoid "unreachable code" warnings */
@@ -272,6 +603,9 @@ DfmResult_t xDfmStoragePortInitialize(DfmStoragePortData_t *pxBuffer)
 		return DFM_FAIL;
 	}
 
+	/* Index what was stored before the restart, so entries can be found without walking the FCB */
+	prvDfmIndexBuild(&xFlashCircularBuffer);
+
 	pxStoragePortData = pxBuffer;
 	pxStoragePortData->ulInitialized = 1;
 
@@ -330,6 +664,7 @@ DfmResult_t xDfmStoragePortStoreAlert(DfmEntryHandle_t xEntryHandle, uint32_t ul
 DfmResult_t xDfmStoragePortGetAlert(void* pvBuffer, uint32_t ulBufferSize)
 {
 	DfmEntryHandle_t xEntryHandle = 0;
+	DfmStorageIndexRecord_t* pxRecord;
 
 	if (pxStoragePortData == (void*)0)
 	{
@@ -351,15 +686,38 @@ DfmResult_t xDfmStoragePortGetAlert(void* pvBuffer, uint32_t ulBufferSize)
 		return DFM_FAIL;
 	}
 
-	while (xDfmEntryCreateAlertFromBuffer(&xEntryHandle) == DFM_FAIL)
+	/* Alerts that haven't been sent stay in the FCB and are returned again by the next traversal */
+	while (ulIndexAlertCursor < ulIndexRecordCount)
 	{
-		if (prvDfmGetNext(&xFlashCircularBuffer, &xTraversionState, pvBuffer, ulBufferSize) != 0)
+		pxRecord = &xIndexRecords[ulIndexAlertCursor];
+		ulIndexAlertCursor++;
+
+		if ((pxRecord->usType != (uint16_t)DFM_ENTRY_TYPE_ALERT) ||
+			(xIndexAlerts[pxRecord->usAlertSlot].usState != DFM_STORAGE_PORT_INDEX_ALERT_STORED))
 		{
-			return DFM_FAIL;
+			continue;
 		}
+
+		if (prvDfmReadEntry(&xFlashCircularBuffer, &pxRecord->xLocation, pvBuffer, ulBufferSize) != 0)
+		{
+			continue;
+		}
+
+		if (xDfmEntryCreateAlertFromBuffer(&xEntryHandle) == DFM_FAIL)
+		{
+			continue;
+		}
+
+		xIndexAlerts[pxRecord->usAlertSlot].usRecordsRead = 0;
+
+		return DFM_SUCCESS;
 	}
 
-	return DFM_SUCCESS;
+	/* We've traversed the index, start over next time */
+	ulIndexAlertCursor = 0;
+	memset(pvBuffer, 0, ulBufferSize);
+
+	return DFM_FAIL;
 }
 
 DfmResult_t xDfmStoragePortStorePayloadChunk(DfmEntryHandle_t xEntryHandle, uint32_t ulOverwrite)
@@ -369,10 +727,11 @@ DfmResult_t xDfmStoragePortStorePayloadChunk(DfmEntryHandle_t xEntryHandle, uint
 
 DfmResult_t xDfmStoragePortGetPayloadChunk(char* szSessionId, uint32_t ulAlertId, void* pvBuffer, uint32_t ulBufferSize)
 {
-	/* We don't need these to find a payload */
-	(void)szSessionId;
-	(void)ulAlertId;
 	DfmEntryHandle_t xEntryHandle = 0;
+	DfmStorageIndexRecord_t* pxRecord;
+	int32_t lAlertSlot;
+	uint32_t ulSkip;
+	uint32_t i;
 
 	if (pxStoragePortData == (void*)0)
 	{
@@ -394,17 +753,61 @@ DfmResult_t xDfmStoragePortGetPayloadChunk(char* szSessionId, uint32_t ulAlertId
 		return DFM_FAIL;
 	}
 
-	if (prvDfmGetNext(&xFlashCircularBuffer, &xTraversionState, pvBuffer, ulBufferSize) != 0)
+	lAlertSlot = prvDfmIndexFindAlert(szSessionId, ulAlertId);
+	if (lAlertSlot < 0)
 	{
 		return DFM_FAIL;
 	}
 
-	if (xDfmEntryCreatePayloadChunkFromBuffer(szSessionId, ulAlertId, &xEntryHandle) == DFM_FAIL)
+	/* Find the next payload entry of this alert, in the order they were stored */
+	ulSkip = xIndexAlerts[lAlertSlot].usRecordsRead;
+	for (i = 0; i < ulIndexRecordCount; i++)
 	{
-		return DFM_FAIL;
+		pxRecord = &xIndexRecords[i];
+
+		if ((pxRecord->usAlertSlot != (uint16_t)lAlertSlot) || (pxRecord->usType == (uint16_t)DFM_ENTRY_TYPE_ALERT))
+		{
+			continue;
+		}
+
+		if (ulSkip > 0)
+		{
+			ulSkip--;
+			continue;
+		}
+
+		xIndexAlerts[lAlertSlot].usRecordsRead++;
+
+		if (prvDfmReadEntry(&xFlashCircularBuffer, &pxRecord->xLocation, pvBuffer, ulBufferSize) != 0)
+		{
+			/* Unreadable, skip it */
+			continue;
+		}
+
+		if (xDfmEntryCreatePayloadChunkFromBuffer(szSessionId, ulAlertId, &xEntryHandle) == DFM_FAIL)
+		{
+			continue;
+		}
+
+		return DFM_SUCCESS;
 	}
 
-	return DFM_SUCCESS;
+	/* The caller only asks for the next chunk after the previous one was handled, so getting here
+	 * means the alert and all its payload chunks have been sent and the space can be reused */
+	if (xIndexAlerts[lAlertSlot].usState == DFM_STORAGE_PORT_INDEX_ALERT_STORED)
+	{
+		xIndexAlerts[lAlertSlot].usState = DFM_STORAGE_PORT_INDEX_ALERT_SENT;
+		prvDfmRotateSent(&xFlashCircularBuffer);
+
+		/* Its entries are still in flash if the sector couldn't be erased yet */
+		if (xIndexAlerts[lAlertSlot].usState == DFM_STORAGE_PORT_INDEX_ALERT_SENT)
+		{
+			(void)prvDfmWriteSentRecord(&xFlashCircularBuffer, &xIndexAlerts[lAlertSlot]);
+		}
+	}
+	memset(pvBuffer, 0, ulBufferSize);
+
+	return DFM_FAIL;
 }
 
 DfmResult_t prvDfmStoragePortWrite(DfmEntryHandle_t xEntryHandle, uint32_t ulType, uint32_t ulOverwrite)
@@ -413,6 +816,8 @@ DfmResult_t prvDfmStoragePortWrite(DfmEntryHandle_t xEntryHandle, uint32_t ulTyp
 	uint32_t ulBytesToWrite;
 	void* pvData = (void*)xEntryHandle;
 	uint32_t ulRemainingBytes = 0;
+	struct fcb_entry xFirstLocation = { 0 };
+	int32_t lAlertSlot = -1;
 	const uint32_t ulMaxUsableSectorSize = (DFM_STORAGE_PORT_FCB_SECTOR_SIZE_ALIGNED) - sizeof(xDfmFlashMetadata) - sizeof(struct fcb_entry);
 
 	if (pxStoragePortData == (void*)0)
@@ -445,6 +850,18 @@ DfmResult_t prvDfmStoragePortWrite(DfmEntryHandle_t xEntryHandle, uint32_t ulTyp
 		return DFM_FAIL;
 	}
 
+	/* Don't store anything that can't be indexed, it could never be retrieved */
+	if (prvDfmIndexPrepare(xEntryHandle, &lAlertSlot) != 0)
+	{
+		/* Make room if sent alerts are still occupying the index */
+		prvDfmRotateSent(&xFlashCircularBuffer);
+
+		if (prvDfmIndexPrepare(xEntryHandle, &lAlertSlot) != 0)
+		{
+			return DFM_FAIL;
+		}
+	}
+
 	/* Configure start markers, used to find the start of flash sections
 	 * when parsing binary blobs. */
 	xDfmFlashMetadata.ucStartMarker[0] = 0x44;	/* 'D' */
@@ -485,6 +902,8 @@ DfmResult_t prvDfmStoragePortWrite(DfmEntryHandle_t xEntryHandle, uint32_t ulTyp
 		{
 			if (ulOverwrite == 1)
 			{
+				prvDfmIndexRemoveOldestSector(&xFlashCircularBuffer);
+
 				if (fcb_rotate(&xFlashCircularBuffer) != 0)
 				{
 					return DFM_FAIL;
@@ -501,6 +920,11 @@ DfmResult_t prvDfmStoragePortWrite(DfmEntryHandle_t xEntryHandle, uint32_t ulTyp
 			}
 		}
 
+		if (xDfmFlashMetadata.usEntryId == 0)
+		{
+			xFirstLocation = xFcbEntry;
+		}
+
 		/* Store size of entry data in this sector */
 		xDfmFlashMetadata.ulDataSize = ulBytesToWrite - sizeof(DfmStorageMetadata_t);
 
@@ -532,7 +956,152 @@ DfmResult_t prvDfmStoragePortWrite(DfmEntryHandle_t xEntryHandle, uint32_t ulTyp
 		ulBytesWritten += xDfmFlashMetadata.ulDataSize;
     }
 
+	if (prvDfmIndexAdd(&xFirstLocation, xEntryHandle) != 0)
+	{
+		return DFM_FAIL;
+	}
+
 	return DFM_SUCCESS;
 }
 
+#if (INCLUDE_STORAGE_PORT_TESTS == 1)
+
+static uint32_t ulStoragePortTestErrors = 0;
+static uint32_t ulStoragePortTestAlerts = 0;
+
+static void prvDfmStoragePortTestCheck(const char* szTest, uint32_t ulPassed)
+{
+	printf("%s %s\n", szTest, (ulPassed != 0) ? "(OK)" : "(ERROR)");
+
+	if (ulPassed == 0)
+	{
+		ulStoragePortTestErrors++;
+	}
+}
+
+/* Stores an alert with a payload, returns its alert id or 0 */
+static uint32_t prvDfmStoragePortTestStoreAlert(void)
+{
+	static uint8_t ucPayload[64] = { 0 };
+	DfmAlertHandle_t xAlertHandle = 0;
+	uint32_t ulAlertId = 0;
+
+	ulStoragePortTestAlerts++;
+
+	if (xDfmAlertBegin(1, "Storage port test", &xAlertHandle) == DFM_FAIL)
+	{
+		return 0;
+	}
+
+	/* Different symptoms, so the rate limiter doesn't drop the alerts */
+	(void)xDfmAlertAddSymptom(xAlertHandle, 1, ulStoragePortTestAlerts);
+	(void)xDfmAlertAddPayload(xAlertHandle, ucPayload, sizeof(ucPayload), "test.bin");
+
+	if ((xDfmSessionGetAlertId(&ulAlertId) == DFM_FAIL) || (xDfmAlertEndOffline(xAlertHandle) == DFM_FAIL))
+	{
+		return 0;
+	}
+
+	return ulAlertId;
+}
+
+/* Gets the next stored alert and up to ulMaxChunks of its payload chunks, like xDfmAlertSendAll(), returns its alert id or 0 */
+static uint32_t prvDfmStoragePortTestSendAlert(uint32_t ulMaxChunks)
+{
+	char cSessionId[DFM_SESSION_ID_MAX_LEN] = { 0 };
+	const char* szSessionId = (void*)0;
+	uint32_t ulAlertId = 0;
+	void* pvBuffer = (void*)0;
+	uint32_t ulBufferSize = 0;
+	uint32_t i;
+
+	if (xDfmEntryGetBuffer(&pvBuffer, &ulBufferSize) == DFM_FAIL)
+	{
+		return 0;
+	}
+
+	if (xDfmStoragePortGetAlert(pvBuffer, ulBufferSize) == DFM_FAIL)
+	{
+		return 0;
+	}
+
+	if ((xDfmEntryGetSessionId((DfmEntryHandle_t)pvBuffer, &szSessionId) == DFM_FAIL) ||
+		(xDfmEntryGetAlertId((DfmEntryHandle_t)pvBuffer, &ulAlertId) == DFM_FAIL))
+	{
+		return 0;
+	}
+
+	strncpy(cSessionId, szSessionId, sizeof(cSessionId) - 1U);
+
+	for (i = 0; i < ulMaxChunks; i++)
+	{
+		if (xDfmStoragePortGetPayloadChunk(cSessionId, ulAlertId, pvBuffer, ulBufferSize) == DFM_FAIL)
+		{
+			break;
+		}
+	}
+
+	return ulAlertId;
+}
+
+/* Simulates a restart, the index is rebuilt from what is in flash */
+static void prvDfmStoragePortTestRestart(void)
+{
+	prvDfmIndexBuild(&xFlashCircularBuffer);
+}
+
+/* Stores and sends alerts with uploads interrupted by restarts, prints the results. Erases the storage.
+ * Meant for a simulated flash, e.g. native_sim with the dfm_partition on the flash simulator. */
+DfmResult_t xDfmStoragePortRunTests(void)
+{
+	uint32_t ulAlertId1;
+	uint32_t ulAlertId2;
+
+	if ((pxStoragePortData == (void*)0) || (pxStoragePortData->ulInitialized == 0))
+	{
+		return DFM_FAIL;
+	}
+
+	ulStoragePortTestErrors = 0;
+
+	if (fcb_clear(&xFlashCircularBuffer) != 0)
+	{
+		return DFM_FAIL;
+	}
+	prvDfmStoragePortTestRestart();
+
+	printf("\nTest 1: An interrupted upload is sent again after a restart.\n");
+	ulAlertId1 = prvDfmStoragePortTestStoreAlert();
+	prvDfmStoragePortTestCheck("Stored", ulAlertId1 != 0);
+	prvDfmStoragePortTestCheck("Alert read", prvDfmStoragePortTestSendAlert(1) == ulAlertId1);
+	prvDfmStoragePortTestRestart();
+	prvDfmStoragePortTestCheck("Alert read again", prvDfmStoragePortTestSendAlert(0xFFFFFFFFUL) == ulAlertId1);
+	prvDfmStoragePortTestCheck("No more alerts", prvDfmStoragePortTestSendAlert(0xFFFFFFFFUL) == 0);
+
+	printf("\nTest 2: A sent alert isn't sent again after a restart.\n");
+	prvDfmStoragePortTestRestart();
+	prvDfmStoragePortTestCheck("No alerts", prvDfmStoragePortTestSendAlert(0xFFFFFFFFUL) == 0);
+
+	printf("\nTest 3: Only the alerts that haven't been sent are read after a restart.\n");
+	ulAlertId1 = prvDfmStoragePortTestStoreAlert();
+	ulAlertId2 = prvDfmStoragePortTestStoreAlert();
+	prvDfmStoragePortTestCheck("Stored", (ulAlertId1 != 0) && (ulAlertId2 != 0));
+	prvDfmStoragePortTestCheck("First alert sent", prvDfmStoragePortTestSendAlert(0xFFFFFFFFUL) == ulAlertId1);
+	prvDfmStoragePortTestCheck("Second alert read", prvDfmStoragePortTestSendAlert(0) == ulAlertId2);
+	prvDfmStoragePortTestRestart();
+	prvDfmStoragePortTestCheck("Second alert read again", prvDfmStoragePortTestSendAlert(0xFFFFFFFFUL) == ulAlertId2);
+	prvDfmStoragePortTestCheck("No more alerts", prvDfmStoragePortTestSendAlert(0xFFFFFFFFUL) == 0);
+	prvDfmStoragePortTestRestart();
+	prvDfmStoragePortTestCheck("No alerts", prvDfmStoragePortTestSendAlert(0xFFFFFFFFUL) == 0);
+
+	printf("\nStorage port tests %s\n", (ulStoragePortTestErrors == 0) ? "passed" : "FAILED");
+
+	(void)fcb_clear(&xFlashCircularBuffer);
+	prvDfmStoragePortTestRestart();
+
+	return (ulStoragePortTestErrors == 0) ? DFM_SUCCESS : DFM_FAIL;
+}
+
+#endif /* (INCLUDE_STORAGE_PORT_TESTS == 1) */
+
 #endif
@@ -117,6 +117,18 @@ DfmResult_t xDfmStoragePortStorePayloadChunk(DfmEntryHandle_t xEntryHandle, uint
  */
 DfmResult_t xDfmStoragePortGetPayloadChunk(char* szSessionId, uint32_t ulAlertId, void* pvBuffer, uint32_t ulBufferSize);
 
+#if (INCLUDE_STORAGE_PORT_TESTS == 1)
+/**
+ * @brief Stores and sends alerts with uploads interrupted by simulated restarts and prints
+ * the results. Erases the storage, so it is meant for a simulated flash, e.g. native_sim
+ * with the dfm_partition on the flash simulator. Requires DFM to be initialized.
+ *
+ * @retval DFM_FAIL A test failed
+ * @retval DFM_SUCCESS All tests passed
+ */
+DfmResult_t xDfmStoragePortRunTests(void);
+#endif
+
 /** @} */
 
 #ifdef __cplusplus
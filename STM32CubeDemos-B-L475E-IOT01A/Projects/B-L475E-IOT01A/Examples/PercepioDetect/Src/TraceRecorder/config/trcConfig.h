@@ -67,6 +67,171 @@ extern "C" {
  */
 #define TRC_CFG_INCLUDE_MEMMANG_EVENTS 1
 
+/**
+ * @def TRC_CFG_HEAP_AGGREGATION
+ * @brief Macro which should be defined as either zero (0) or one (1).
+ *
+ * If one (1), successful malloc and free calls are not stored as individual
+ * events. Instead the recorder counts them per size class and per task, and
+ * xTraceHeapReport() stores a summary of the counters as User Events. The
+ * report is made periodically by TzCtrl, if anything changed since the last
+ * report. Failed malloc and free calls are still stored as events.
+ *
+ * Use this if allocation-heavy code (network stacks, parsers) fills the trace
+ * buffer with malloc/free events, evicting the scheduling history.
+ * Requires TRC_CFG_INCLUDE_MEMMANG_EVENTS and TRC_CFG_INCLUDE_USER_EVENTS.
+ *
+ * Allocations are counted by the size passed to malloc, see
+ * TRC_CFG_HEAP_AGGREGATION_BLOCK_HEADER.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_HEAP_AGGREGATION 0
+
+/**
+ * @def TRC_CFG_HEAP_AGGREGATION_BLOCK_HEADER
+ * @brief Macro which should be defined as either zero (0) or one (1).
+ *
+ * If one (1), TRC_CFG_HEAP_AGGREGATION counts system heap allocations by the
+ * size in the heap_4/heap_5 block header, right below the returned address.
+ * These heaps pass the size of the whole block to traceFREE, which can be
+ * larger than the requested size, so the free calls then end up in the same
+ * size class as the malloc calls. Only use this with heap_4 or heap_5, with
+ * other heaps (heap_1/2/3, newlib malloc) the header read is garbage.
+ *
+ * If zero (0), allocations are counted by the size passed to malloc and free.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_HEAP_AGGREGATION_BLOCK_HEADER 0
+
+/**
+ * @def TRC_CFG_HEAP_AGGREGATION_SIZE_CLASSES
+ * @brief Macro which should be defined as a non-zero integer value.
+ *
+ * The number of size classes used by TRC_CFG_HEAP_AGGREGATION. The first
+ * class holds allocations of up to 16 bytes, each following class twice as
+ * much as the previous one, and the last class holds all larger allocations.
+ *
+ * Default value is 8.
+ */
+#define TRC_CFG_HEAP_AGGREGATION_SIZE_CLASSES 8
+
+/**
+ * @def TRC_CFG_HEAP_AGGREGATION_TASKS
+ * @brief Macro which should be defined as a non-zero integer value.
+ *
+ * The number of tasks that get their own totals with TRC_CFG_HEAP_AGGREGATION.
+ * Allocations made by further tasks are added to a shared "other" entry.
+ *
+ * Default value is 8.
+ */
+#define TRC_CFG_HEAP_AGGREGATION_TASKS 8
+
+/**
+ * @def TRC_CFG_INTERVAL_AGGREGATION_SLOTS
+ * @brief Macro which should be defined as an integer value.
+ *
+ * If non-zero, interval channels are aggregated on target instead of storing
+ * an event for every xTraceIntervalStart/xTraceIntervalStop. Each channel
+ * keeps the number of intervals and the total, min and max duration, and
+ * xTraceIntervalReport() stores these as one User Event per channel. The
+ * report is made by TzCtrl, see TRC_CFG_AGGREGATION_REPORT_PERIOD.
+ *
+ * This is the number of channels that can be aggregated. Channels created
+ * after that, and channels enabled with xTraceIntervalSetRawEvents(), still
+ * store all events. Requires TRC_CFG_INCLUDE_USER_EVENTS.
+ *
+ * Default value is 0 (= no aggregation).
+ */
+#define TRC_CFG_INTERVAL_AGGREGATION_SLOTS 0
+
+/**
+ * @def TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS
+ * @brief Macro which should be defined as an integer value.
+ *
+ * If non-zero, state machines are aggregated on target instead of storing an
+ * event for every state change. Each state keeps the number of visits and the
+ * total time spent in it, and xTraceStateMachineReport() stores these as one
+ * User Event per state. The report is made by TzCtrl,
+ * see TRC_CFG_AGGREGATION_REPORT_PERIOD.
+ *
+ * This is the number of states that can be aggregated. State changes to
+ * states created after that, and all state changes of state machines enabled
+ * with xTraceStateMachineSetRawEvents(), are still stored as events.
+ * Requires TRC_CFG_INCLUDE_USER_EVENTS.
+ *
+ * Default value is 0 (= no aggregation).
+ */
+#define TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS 0
+
+/**
+ * @def TRC_CFG_AGGREGATION_REPORT_PERIOD
+ * @brief Macro which should be defined as a non-zero integer value.
+ *
+ * How often TzCtrl reports the interval and state machine aggregation, in
+ * number of TzCtrl cycles (see TRC_CFG_CTRL_TASK_DELAY). The counters are
+ * reset after each report.
+ *
+ * Default value is 1.
+ */
+#define TRC_CFG_AGGREGATION_REPORT_PERIOD 1
+
+/**
+ * @def TRC_CFG_PRINT_ARRAY_FLUSH_TICKS
+ * @brief Macro which should be defined as an integer value.
+ *
+ * The maximum age, in OS ticks, of the oldest sample in a print array buffer
+ * (see xTracePrintArrayBufferAdd()). A buffer is flushed when it is full, or
+ * when the oldest sample is older than this. The age is checked when samples
+ * are added and on every TzCtrl cycle, so it can be exceeded by up to one
+ * TzCtrl period (TRC_CFG_CTRL_TASK_DELAY). Requires
+ * TRC_CFG_INCLUDE_USER_EVENTS.
+ *
+ * Default value is 10. Set to 0 to only flush full buffers.
+ */
+#define TRC_CFG_PRINT_ARRAY_FLUSH_TICKS 10
+
+/**
+ * @def TRC_CFG_COUNTER_FILTER_SLOTS
+ * @brief Macro which should be defined as an integer value.
+ *
+ * If non-zero, xTraceCounterSetFilter() can give a counter a deadband and a
+ * minimum interval between stored values. Values within the deadband of the
+ * last stored value, or set before the minimum interval has passed, only
+ * update the counter state and a min/max/last summary. The summary is stored
+ * as a User Event, on a channel with the counter name, once the interval has
+ * passed. TzCtrl stores it for counters that are no longer set.
+ * Limit checks and the counter callback still see every value.
+ *
+ * This is the number of counters that can be filtered. Requires
+ * TRC_CFG_INCLUDE_USER_EVENTS for the summary events.
+ *
+ * Default value is 0 (= no filtering).
+ */
+#define TRC_CFG_COUNTER_FILTER_SLOTS 0
+
+/**
+ * @def TRC_CFG_EVENT_DECIMATION_SLOTS
+ * @brief Macro which should be defined as an integer value.
+ *
+ * If non-zero, xTraceEventSetDecimation() can limit how many successful
+ * queue and semaphore send/receive events are stored, either as 1 of every N
+ * events or as at most M events per millisecond. The limit applies per event
+ * code and object. The number of skipped events is stored in a User Event on
+ * the "Decimation" channel before the next stored event for the same object,
+ * or by TzCtrl once the object has no more events.
+ * All other events are always stored.
+ *
+ * This is the number of objects that are tracked at the same time. Objects
+ * share slots by address, and when a slot is taken over its skipped events
+ * are reported first. If that report can't be stored, the slot is not taken
+ * over and the new object's event is stored as is.
+ *
+ * Default value is 0 (= no decimation).
+ */
+#define TRC_CFG_EVENT_DECIMATION_SLOTS 0
+
 /**
  * @def TRC_CFG_INCLUDE_USER_EVENTS
  * @brief Macro which should be defined as either zero (0) or one (1).
@@ -181,6 +346,24 @@ extern "C" {
  */
 #define TRC_CFG_TASK_MONITOR_MAX_TASKS 5
 
+/**
+ * @def TRC_CFG_TASK_MONITOR_WINDOW_MS
+ * @brief Set this to a window length in milliseconds to check the CPU load of
+ * each monitored task when it is switched out, instead of only when
+ * xTraceTaskMonitorPoll() is called. A task's window ends at the first switch
+ * out after this many milliseconds, and its load over the window is then checked
+ * against the limits. A task exceeding its high limit is detected as soon as its
+ * runtime within the current window crosses it.
+ *
+ * The first failure is latched in the task switch hook, and the callback is
+ * called with it by the next xTraceTaskMonitorPoll(), in the polling task.
+ * xTraceTaskMonitorPoll() also detects tasks that stop running entirely, or
+ * never stop running.
+ *
+ * Default value is 0 (only check the load in xTraceTaskMonitorPoll()).
+ */
+#define TRC_CFG_TASK_MONITOR_WINDOW_MS 0
+
 /**
  * @def TRC_CFG_ENABLE_STACK_MONITOR
  * @brief If enabled (1), the recorder periodically reports the unused stack space of
@@ -223,6 +406,25 @@ extern "C" {
  */
 #define TRC_CFG_STACK_MONITOR_MAX_REPORTS 1
 
+/**
+ * @def TRC_CFG_STACK_MONITOR_SCAN_WORDS
+ * @brief Macro which should be defined as an integer value.
+ *
+ * If non-zero, the stack analysis done by TzCtrl is incremental and checks at
+ * most this many stack words per execution, resuming where it left off. Only
+ * the area below the previous low water mark of a task is scanned, since the
+ * stack can only have grown into that area. This bounds the execution time of
+ * the stack monitor regardless of the stack sizes, while the reported values
+ * are the same as with full scans. Requires that the kernel port can provide
+ * the stack base, tasks where it can't are scanned fully.
+ *
+ * If 0, the full stack of TRC_CFG_STACK_MONITOR_MAX_REPORTS tasks is analyzed
+ * each time.
+ *
+ * Default value is 0. This demo scans 64 words per TzCtrl execution.
+ */
+#define TRC_CFG_STACK_MONITOR_SCAN_WORDS 64
+
 /**
  * @def TRC_CFG_CTRL_TASK_PRIORITY
  * @brief The scheduling priority of the Tracealyzer Control (TzCtrl) task. 
@@ -255,6 +457,51 @@ extern "C" {
  */
 #define TRC_CFG_CTRL_TASK_DELAY 500
 
+/**
+ * @def TRC_CFG_CTRL_TASK_TRANSFER_BUDGET
+ * @brief Enables the adaptive transfer scheduling of the internal buffer,
+ * for stream ports using it (like TCP/IP), and sets the time TzCtrl may spend
+ * on transfers per loop. The unit is timestamp ticks (TRC_HWTC_COUNT), e.g.
+ * CPU cycles when the DWT cycle counter is used.
+ *
+ * When enabled, chunk transfers (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_TRANSFER_MODE)
+ * continue beyond the normal limit while the buffer is above the high water
+ * level (see TRC_CFG_CTRL_TASK_HIGH_WATER_PERCENT) and stop when the budget
+ * is used up. Crossing the high water level also wakes up TzCtrl early, from
+ * the next OS tick, and TzCtrl sleeps up to TRC_CFG_CTRL_TASK_DELAY_MAX while
+ * the buffer stays empty.
+ *
+ * Dropped events, the longest transfer time and the number of early wakeups
+ * are also recorded as diagnostics, but only when this is enabled.
+ *
+ * If 0, TzCtrl polls the buffer every TRC_CFG_CTRL_TASK_DELAY.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_CTRL_TASK_TRANSFER_BUDGET 0
+
+/**
+ * @def TRC_CFG_CTRL_TASK_HIGH_WATER_PERCENT
+ * @brief The internal buffer fill level, in percent, that wakes up TzCtrl
+ * early and lets transfers exceed the normal chunk count limit. Only used if
+ * TRC_CFG_CTRL_TASK_TRANSFER_BUDGET is non-zero.
+ *
+ * Default value is 75.
+ */
+#define TRC_CFG_CTRL_TASK_HIGH_WATER_PERCENT 75
+
+/**
+ * @def TRC_CFG_CTRL_TASK_DELAY_MAX
+ * @brief The longest delay between loops of the TzCtrl task. While the internal
+ * buffer is empty, the delay is doubled each loop up to this value, and it goes
+ * back to TRC_CFG_CTRL_TASK_DELAY as soon as there is data. Note that this also
+ * delays the handling of commands from Tracealyzer. Only used if
+ * TRC_CFG_CTRL_TASK_TRANSFER_BUDGET is non-zero.
+ *
+ * Default value is TRC_CFG_CTRL_TASK_DELAY.
+ */
+#define TRC_CFG_CTRL_TASK_DELAY_MAX (TRC_CFG_CTRL_TASK_DELAY)
+
 /**
  * @def TRC_CFG_CTRL_TASK_STACK_SIZE
  * @brief The stack size of the Tracealyzer Control (TzCtrl) task.
@@ -360,6 +607,21 @@ extern "C" {
  */
 #define TRC_CFG_USE_TRACE_ASSERT 0
 
+/**
+ * @def TRC_CFG_ENABLE_HEALTH_METRICS
+ * @brief Enable or disable the recorder health metrics. If enabled (1), the
+ * recorder keeps per-core counters of the events and bytes written, events
+ * dropped or overwritten because the buffer was full, the highest buffer fill
+ * level, the longest critical section when creating an event and failed string
+ * registrations. The counters can be read with xTraceDiagnosticsGetHealthMetrics()
+ * and are useful when sizing the trace buffers.
+ *
+ * This adds a few increments and one extra timestamp read per event.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_ENABLE_HEALTH_METRICS 0
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,12 +15,20 @@
 #ifndef TRC_COUNTER_H
 #define TRC_COUNTER_H
 
+#ifndef TRC_CFG_COUNTER_FILTER_SLOTS
+#define TRC_CFG_COUNTER_FILTER_SLOTS 0
+#endif
+
 #if (TRC_USE_TRACEALYZER_RECORDER == 1)
 
 #define TRC_COUNTER_VALUE_INDEX 0
 #define TRC_COUNTER_LOWER_LIMIT_INDEX 1
 #define TRC_COUNTER_UPPER_LIMIT_INDEX 2
 
+/* All counter states are used, so the filter slot (index + 1) is kept in the entry options */
+#define TRC_COUNTER_FILTER_OPTION_SHIFT 8u
+#define TRC_COUNTER_FILTER_OPTION_MASK 0x0000FF00UL
+
 #include <trcTypes.h>
 
 #ifdef __cplusplus
@@ -38,6 +46,26 @@ typedef struct TraceCounterData /* Aligned */
 	TraceCounterCallback_t xCallbackFunction;
 } TraceCounterData_t;
 
+#if (TRC_CFG_COUNTER_FILTER_SLOTS > 0)
+
+typedef struct TraceCounterFilter	/* Aligned */
+{
+	TraceCounterHandle_t xCounterHandle;
+	TraceBaseType_t xLowerLimit;
+	TraceBaseType_t xUpperLimit;
+	TraceUnsignedBaseType_t uxDeadband;
+	TraceUnsignedBaseType_t uxMinInterval;
+	TraceUnsignedBaseType_t uxLastTimestamp;
+	TraceBaseType_t xLastStored;
+	TraceUnsignedBaseType_t uxSamples;
+	TraceBaseType_t xMin;
+	TraceBaseType_t xMax;
+	TraceBaseType_t xLast;
+	TraceStringHandle_t xChannel;
+} TraceCounterFilter_t;
+
+#endif
+
 /**
  * @brief Initializes the Counter trace system
  * 
@@ -158,6 +186,48 @@ traceResult xTraceCounterSet(TraceCounterHandle_t xCounterHandle, TraceBaseType_
  */
 #define xTraceCounterGetName(xCounterHandle, pszName) xTraceObjectGetName((TraceObjectHandle_t)(xCounterHandle), pszName)
 
+#if (TRC_CFG_COUNTER_FILTER_SLOTS > 0)
+
+/**
+ * @brief Sets deadband and minimum interval for trace counter.
+ *
+ * Only available with TRC_CFG_COUNTER_FILTER_SLOTS. A value is only stored
+ * as an event if it differs more than uxDeadband from the last stored value
+ * and at least uxMinInterval timestamp ticks have passed since then. Other
+ * values are summarized as min/max/last and stored as one User Event, on a
+ * channel with the counter name, when the interval has passed. The counter
+ * limits are cached when the filter is set and are checked for every value.
+ *
+ * @param[in] xCounterHandle Initialized trace counter handle.
+ * @param[in] uxDeadband Deadband, 0 to store all changed values.
+ * @param[in] uxMinInterval Minimum interval in timestamp ticks, 0 for none.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceCounterSetFilter(TraceCounterHandle_t xCounterHandle, TraceUnsignedBaseType_t uxDeadband, TraceUnsignedBaseType_t uxMinInterval);
+
+/**
+ * @brief Stores the pending summaries of filtered counters.
+ *
+ * Only available with TRC_CFG_COUNTER_FILTER_SLOTS. A summary is otherwise
+ * only stored when the counter is set again, so this stores it for counters
+ * that are no longer set once their minimum interval has passed. Called
+ * periodically by TzCtrl.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceCounterFlush(void);
+
+#else
+
+#define xTraceCounterSetFilter(_xCounterHandle, _uxDeadband, _uxMinInterval) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_4((void)(_xCounterHandle), (void)(_uxDeadband), (void)(_uxMinInterval), TRC_FAIL)
+
+#define xTraceCounterFlush() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#endif
+
 /** @} */
 
 #ifdef __cplusplus
@@ -186,6 +256,10 @@ traceResult xTraceCounterSet(TraceCounterHandle_t xCounterHandle, TraceBaseType_
 
 #define xTraceCounterGetName(_xCounterHandle, _pszName) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(_xCounterHandle), (void)(_pszName), TRC_SUCCESS)
 
+#define xTraceCounterSetFilter(_xCounterHandle, _uxDeadband, _uxMinInterval) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_4((void)(_xCounterHandle), (void)(_uxDeadband), (void)(_uxMinInterval), TRC_SUCCESS)
+
+#define xTraceCounterFlush() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
 #endif
 
 #endif
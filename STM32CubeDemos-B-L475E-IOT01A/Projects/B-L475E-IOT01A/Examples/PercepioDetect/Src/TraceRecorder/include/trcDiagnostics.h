@@ -23,7 +23,7 @@
 extern "C" {
 #endif
 
-#define TRC_DIAGNOSTICS_COUNT 5UL
+#define TRC_DIAGNOSTICS_COUNT 8UL
 
 typedef enum TraceDiagnosticsType
 {
@@ -32,13 +32,59 @@ typedef enum TraceDiagnosticsType
 	TRC_DIAGNOSTICS_BLOB_MAX_BYTES_TRUNCATED = 0x02UL,
 	TRC_DIAGNOSTICS_STACK_MONITOR_NO_SLOTS = 0x03UL,
 	TRC_DIAGNOSTICS_ASSERTS_TRIGGERED = 0x04UL,
+	TRC_DIAGNOSTICS_INTERNAL_BUFFER_DROPPED_EVENTS = 0x05UL,
+	TRC_DIAGNOSTICS_INTERNAL_BUFFER_TRANSFER_TIME_MAX = 0x06UL,
+	TRC_DIAGNOSTICS_INTERNAL_BUFFER_EARLY_WAKEUPS = 0x07UL,
 } TraceDiagnosticsType_t;
 
+#ifndef TRC_CFG_ENABLE_HEALTH_METRICS
+#define TRC_CFG_ENABLE_HEALTH_METRICS 0
+#endif
+
+/**
+ * @brief Recorder health metrics for one core. Only updated from within the
+ * recorder's critical sections on the owning core, so no atomics are needed.
+ */
+typedef struct TraceHealthMetrics /* Aligned */
+{
+	TraceUnsignedBaseType_t uxEventsWritten;		/**< Events stored in the buffer */
+	TraceUnsignedBaseType_t uxBytesWritten;			/**< Bytes stored in the buffer */
+	TraceUnsignedBaseType_t uxEventsDropped;		/**< Events lost since the buffer was full */
+	TraceUnsignedBaseType_t uxEventsOverwritten;	/**< Old events overwritten to make room for new ones */
+	TraceUnsignedBaseType_t uxMaxFill;				/**< Highest buffer fill level, in bytes */
+	TraceUnsignedBaseType_t uxMaxCriticalSection;	/**< Longest critical section when creating an event, in timestamp ticks */
+	TraceUnsignedBaseType_t uxStringMisses;			/**< Failed string registrations */
+} TraceHealthMetrics_t;
+
 typedef struct TraceDiagnostics /* Aligned */
 {
 	TraceBaseType_t metrics[TRC_DIAGNOSTICS_COUNT];
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+	TraceHealthMetrics_t xHealthMetrics[TRC_CFG_CORE_COUNT];
+#endif
 } TraceDiagnosticsData_t;
 
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+
+extern TraceHealthMetrics_t* pxTraceHealthMetrics;
+
+/**
+ * @internal Adds to a health metric of the current core.
+ */
+#define TRC_HEALTH_METRICS_ADD(xField, uxValue) (pxTraceHealthMetrics[TRC_CFG_GET_CURRENT_CORE()].xField += (TraceUnsignedBaseType_t)(uxValue))
+
+/**
+ * @internal Sets a health metric of the current core if the value is higher.
+ */
+#define TRC_HEALTH_METRICS_SET_IF_HIGHER(xField, uxValue) if ((TraceUnsignedBaseType_t)(uxValue) > pxTraceHealthMetrics[TRC_CFG_GET_CURRENT_CORE()].xField) { pxTraceHealthMetrics[TRC_CFG_GET_CURRENT_CORE()].xField = (TraceUnsignedBaseType_t)(uxValue); }
+
+#else
+
+#define TRC_HEALTH_METRICS_ADD(xField, uxValue)
+#define TRC_HEALTH_METRICS_SET_IF_HIGHER(xField, uxValue)
+
+#endif
+
 /**
  * @internal Initialize diagnostics
  *
@@ -132,6 +178,50 @@ traceResult xTraceDiagnosticsSetIfLower(TraceDiagnosticsType_t xType, TraceBaseT
  */
 traceResult xTraceDiagnosticsCheckStatus(void);
 
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+
+/**
+ * @brief Retrieve a copy of the health metrics of a core
+ *
+ * @param[in] uiCoreId Core
+ * @param[out] pxMetrics Pointer to metrics
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceDiagnosticsGetHealthMetrics(uint32_t uiCoreId, TraceHealthMetrics_t* pxMetrics);
+
+/**
+ * @brief Retrieve the health metrics of all cores as a block of memory, e.g.
+ * for adding them as a DFM Alert payload. The block is an array of
+ * TraceHealthMetrics_t with one element per core.
+ *
+ * @param[out] ppvData Pointer to the metrics
+ * @param[out] puxSize Size of the metrics
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceDiagnosticsGetHealthMetricsData(void** ppvData, TraceUnsignedBaseType_t* puxSize);
+
+/**
+ * @brief Clear the health metrics of all cores
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceDiagnosticsClearHealthMetrics(void);
+
+#else
+
+#define xTraceDiagnosticsGetHealthMetrics(__uiCoreId, __pxMetrics) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(__uiCoreId), (void)(__pxMetrics), TRC_FAIL)
+
+#define xTraceDiagnosticsGetHealthMetricsData(__ppvData, __puxSize) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(__ppvData), (void)(__puxSize), TRC_FAIL)
+
+#define xTraceDiagnosticsClearHealthMetrics() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -15,6 +15,10 @@
 #ifndef TRC_EVENT_H
 #define TRC_EVENT_H
 
+#ifndef TRC_CFG_EVENT_DECIMATION_SLOTS
+#define TRC_CFG_EVENT_DECIMATION_SLOTS 0
+#endif
+
 #if (TRC_USE_TRACEALYZER_RECORDER == 1)
 
 #include <trcTypes.h>
@@ -169,6 +173,22 @@ traceResult xTraceEventCreate1(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
  */
 traceResult xTraceEventCreate2(uint32_t uiEventCode, TraceUnsignedBaseType_t uxParam1, TraceUnsignedBaseType_t uxParam2);
 
+/**
+ * @internal Creates an event with 2 parameters from within a critical section.
+ *
+ * Same as xTraceEventCreate2() but the caller has already entered a trace
+ * critical section, so no nested critical section is used. Intended for the
+ * task switch.
+ *
+ * @param[in] uiEventCode Event code.
+ * @param[in] uxParam1 First parameter.
+ * @param[in] uxParam2 Second parameter.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceEventCreate2InCriticalSection(uint32_t uiEventCode, TraceUnsignedBaseType_t uxParam1, TraceUnsignedBaseType_t uxParam2);
+
 /**
  * @brief Creates an event with 3 parameters.
  *
@@ -356,6 +376,66 @@ traceResult xTraceEventCreateData6(uint32_t uiEventCode, TraceUnsignedBaseType_t
  */
 traceResult xTraceEventGetSize(const void* const pvAddress, uint32_t* puiSize);
 
+#if (TRC_CFG_EVENT_DECIMATION_SLOTS > 0)
+
+/**
+ * @brief Sets decimation for an event code.
+ *
+ * Only available with TRC_CFG_EVENT_DECIMATION_SLOTS. Only the first of every
+ * uiOneOfN events per object is stored, and at most uiMaxPerMs events per
+ * object and millisecond. Skipped events don't count as lost events in
+ * Tracealyzer. Instead, a User Event on the "Decimation" channel tells how
+ * many events were skipped for the object.
+ *
+ * Only the events listed in TRC_KERNEL_PORT_DECIMATION_EVENTS can be
+ * decimated, i.e. successful queue and semaphore transfers. Other events are
+ * needed by Tracealyzer to rebuild the timeline and are always stored.
+ *
+ * Example:
+ *	 xTraceEventSetDecimation(PSF_EVENT_QUEUE_SEND, 10, 0);
+ *
+ * @param[in] uiEventCode Event code, e.g. PSF_EVENT_QUEUE_SEND.
+ * @param[in] uiOneOfN Store 1 of every N events, 0 or 1 to store all.
+ * @param[in] uiMaxPerMs Max events per millisecond, 0 for no limit.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceEventSetDecimation(uint32_t uiEventCode, uint32_t uiOneOfN, uint32_t uiMaxPerMs);
+
+/**
+ * @brief Stores the skipped counts of objects that went quiet.
+ *
+ * Only available with TRC_CFG_EVENT_DECIMATION_SLOTS. The skipped count is
+ * otherwise only stored with the next stored event for the same object, so
+ * this stores it for objects that had no events since the previous call.
+ * Called periodically by TzCtrl.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceEventDecimationFlush(void);
+
+#if (INCLUDE_EVENT_DECIMATION_TESTS == 1)
+/**
+ * @brief Runs the decimation on simulated events and prints the results.
+ * Requires the recorder to be enabled, since the summaries are stored as
+ * events. Erases the decimation state.
+ *
+ * @retval TRC_FAIL A test failed
+ * @retval TRC_SUCCESS All tests passed
+ */
+traceResult xTraceEventDecimationRunTests(void);
+#endif
+
+#else
+
+#define xTraceEventSetDecimation(_uiEventCode, _uiOneOfN, _uiMaxPerMs) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_4((void)(_uiEventCode), (void)(_uiOneOfN), (void)(_uiMaxPerMs), TRC_FAIL)
+
+#define xTraceEventDecimationFlush() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#endif
+
 /* Helper macros */
 
 /**
@@ -434,6 +514,12 @@ traceResult xTraceEventGetSize(const void* const pvAddress, uint32_t* puiSize);
 }
 #endif
 
+#else
+
+#define xTraceEventSetDecimation(_uiEventCode, _uiOneOfN, _uiMaxPerMs) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_4((void)(_uiEventCode), (void)(_uiOneOfN), (void)(_uiMaxPerMs), TRC_SUCCESS)
+
+#define xTraceEventDecimationFlush() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
 #endif /* (TRC_USE_TRACEALYZER_RECORDER == 1) */
 
 #endif /* TRC_EVENT_H */
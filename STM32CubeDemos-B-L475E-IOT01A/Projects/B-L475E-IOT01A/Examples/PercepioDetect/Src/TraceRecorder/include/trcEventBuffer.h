@@ -165,6 +165,17 @@ traceResult xTraceEventBufferTransferChunk(TraceEventBuffer_t* pxTraceEventBuffe
  */
 traceResult xTraceEventBufferClear(TraceEventBuffer_t* pxTraceEventBuffer);
 
+/**
+ * @brief Gets the number of bytes currently used in the event buffer.
+ *
+ * @param[in] pxTraceEventBuffer Pointer to initialized trace event buffer.
+ * @param[out] puiUsed Used bytes.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceEventBufferGetUsed(const TraceEventBuffer_t* pxTraceEventBuffer, uint32_t* puiUsed);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -19,6 +19,27 @@
 #define TRC_USE_HEAPS 1
 #endif
 
+#ifndef TRC_CFG_HEAP_AGGREGATION
+#define TRC_CFG_HEAP_AGGREGATION 0
+#endif
+
+#ifndef TRC_CFG_HEAP_AGGREGATION_SIZE_CLASSES
+#define TRC_CFG_HEAP_AGGREGATION_SIZE_CLASSES 8
+#endif
+
+#ifndef TRC_CFG_HEAP_AGGREGATION_TASKS
+#define TRC_CFG_HEAP_AGGREGATION_TASKS 8
+#endif
+
+#ifndef TRC_CFG_HEAP_AGGREGATION_BLOCK_HEADER
+#define TRC_CFG_HEAP_AGGREGATION_BLOCK_HEADER 0
+#endif
+
+/* The size xTraceHeapFree() will be called with for the block at pvAddress */
+#ifndef TRC_KERNEL_PORT_HEAP_BLOCK_SIZE
+#define TRC_KERNEL_PORT_HEAP_BLOCK_SIZE(xHeapHandle, pvAddress, uxSize) (uxSize)
+#endif
+
 #if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_USE_HEAPS == 1)
 
 #include <trcTypes.h>
@@ -31,6 +52,37 @@ extern "C" {
 #define TRC_HEAP_STATE_INDEX_HIGHWATERMARK	1u
 #define TRC_HEAP_STATE_INDEX_MAX			2u
 
+#if (TRC_CFG_HEAP_AGGREGATION == 1)
+
+/* Upper limit of the first size class, each following class is twice as large */
+#define TRC_HEAP_AGGREGATION_FIRST_CLASS_SIZE 16u
+
+typedef struct TraceHeapSizeClass	/* Aligned */
+{
+	TraceUnsignedBaseType_t uxAllocCount;
+	TraceUnsignedBaseType_t uxFreeCount;
+	TraceUnsignedBaseType_t uxCurrent;
+	TraceUnsignedBaseType_t uxHighWaterMark;
+} TraceHeapSizeClass_t;
+
+typedef struct TraceHeapTaskTotals	/* Aligned */
+{
+	void* pvTask;
+	TraceUnsignedBaseType_t uxAllocCount;
+	TraceUnsignedBaseType_t uxAllocBytes;
+	TraceUnsignedBaseType_t uxFreeBytes;
+} TraceHeapTaskTotals_t;
+
+typedef struct TraceHeapAggregation	/* Aligned */
+{
+	TraceHeapSizeClass_t xSizeClasses[TRC_CFG_HEAP_AGGREGATION_SIZE_CLASSES];
+	TraceHeapTaskTotals_t xTasks[TRC_CFG_HEAP_AGGREGATION_TASKS];
+	TraceHeapTaskTotals_t xOtherTasks;
+	TraceUnsignedBaseType_t uxChanged;
+} TraceHeapAggregation_t;
+
+#endif
+
 /**
  * @defgroup trace_heap_apis Trace Heap APIs
  * @ingroup trace_recorder_apis
@@ -139,6 +191,44 @@ traceResult xTraceHeapFree(TraceHeapHandle_t xHeapHandle, void* pvAddress, Trace
  */
 #define xTraceHeapSetMax(xHeapHandle, uxMax) xTraceEntrySetState(xHeapHandle, TRC_HEAP_STATE_INDEX_MAX, uxMax)
 
+#if (TRC_CFG_HEAP_AGGREGATION == 1)
+
+/**
+ * @brief Stores a summary of the heap aggregation counters as User Events.
+ *
+ * Only available with TRC_CFG_HEAP_AGGREGATION. Stores one event with the
+ * totals, followed by one event per used size class and task. Nothing is
+ * stored if no malloc or free has been made since the last report. Called
+ * periodically by TzCtrl, and may be called by the application, e.g. before
+ * taking a snapshot for an alert.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceHeapReport(void);
+
+/**
+ * @brief Gets the heap aggregation counters.
+ *
+ * The counters are stored as a TraceHeapAggregation_t and may be added to a
+ * DFM alert as a payload.
+ *
+ * @param[out] ppvData Pointer to the counters.
+ * @param[out] puxSize Size of the counters.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceHeapGetAggregation(void** ppvData, TraceUnsignedBaseType_t* puxSize);
+
+#else
+
+#define xTraceHeapReport() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceHeapGetAggregation(__ppvData, __puxSize) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(__ppvData), (void)(__puxSize), TRC_FAIL)
+
+#endif
+
 /** @} */
 
 #ifdef __cplusplus
@@ -159,6 +249,10 @@ traceResult xTraceHeapFree(TraceHeapHandle_t xHeapHandle, void* pvAddress, Trace
 
 #define xTraceHeapGetMax(__xHeapHandle, __puxMax) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(__xHeapHandle), (void)(__puxMax), TRC_SUCCESS)
 
+#define xTraceHeapReport() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceHeapGetAggregation(__ppvData, __puxSize) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(__ppvData), (void)(__puxSize), TRC_FAIL)
+
 #endif
 
 #endif
@@ -47,6 +47,18 @@
 #define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT (5UL)
 #endif
 
+#ifndef TRC_CFG_CTRL_TASK_TRANSFER_BUDGET
+#define TRC_CFG_CTRL_TASK_TRANSFER_BUDGET 0
+#endif
+
+#ifndef TRC_CFG_CTRL_TASK_HIGH_WATER_PERCENT
+#define TRC_CFG_CTRL_TASK_HIGH_WATER_PERCENT 75
+#endif
+
+#ifndef TRC_CFG_CTRL_TASK_DELAY_MAX
+#define TRC_CFG_CTRL_TASK_DELAY_MAX (TRC_CFG_CTRL_TASK_DELAY)
+#endif
+
 #if (TRC_USE_INTERNAL_BUFFER == 1)
 
 #include <trcTypes.h>
@@ -160,6 +172,30 @@ traceResult xTraceInternalEventBufferTransferChunk(void);
  */
 traceResult xTraceInternalEventBufferClear(void);
 
+/**
+ * @brief Gets the fill level of the internal trace event buffer. With
+ * multiple cores, the fullest core buffer is reported.
+ *
+ * @param[out] puiPercent Fill level in percent
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceInternalEventBufferGetFill(uint32_t* puiPercent);
+
+/**
+ * @internal Checks if the internal trace event buffer has crossed the high
+ * water level (TRC_CFG_CTRL_TASK_HIGH_WATER_PERCENT) since the last transfer.
+ * Each crossing is reported once, so the kernel port can wake up TzCtrl
+ * without repeating the wakeup every tick.
+ *
+ * @param[out] puiWakeup 1 if TzCtrl should be woken up, otherwise 0
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceInternalEventBufferGetWakeup(uint32_t* puiWakeup);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -175,6 +211,8 @@ traceResult xTraceInternalEventBufferClear(void);
 #define xTraceInternalEventBufferTransfer() (void)(TRC_SUCCESS)
 #define xTraceInternalEventBufferTransferChunk(piBytesWritten, uiChunkSize) ((void)(piBytesWritten), (void)(uiChunkSize), TRC_SUCCESS)
 #define xTraceInternalEventBufferClear() (void)(TRC_SUCCESS)
+#define xTraceInternalEventBufferGetFill(puiPercent) (*(puiPercent) = 0u, TRC_SUCCESS)
+#define xTraceInternalEventBufferGetWakeup(puiWakeup) (*(puiWakeup) = 0u, TRC_SUCCESS)
 
 #endif /* (TRC_USE_INTERNAL_BUFFER == 1)*/
 
@@ -15,6 +15,10 @@
 #ifndef TRC_INTERVAL_H
 #define TRC_INTERVAL_H
 
+#ifndef TRC_CFG_INTERVAL_AGGREGATION_SLOTS
+#define TRC_CFG_INTERVAL_AGGREGATION_SLOTS 0
+#endif
+
 #if (TRC_USE_TRACEALYZER_RECORDER == 1)
 
 #ifdef __cplusplus
@@ -24,6 +28,21 @@ extern "C" {
 #include <trcTypes.h>
 
 #define TRC_INTERVAL_CHANNEL_SET_INDEX 0u
+#define TRC_INTERVAL_AGGREGATION_INDEX 1u
+#define TRC_INTERVAL_RAW_EVENTS_INDEX 2u
+
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0)
+
+typedef struct TraceIntervalAggregation	/* Aligned */
+{
+	TraceIntervalChannelHandle_t xIntervalChannelHandle;
+	TraceUnsignedBaseType_t uxCount;
+	TraceUnsignedBaseType_t uxTotal;
+	TraceUnsignedBaseType_t uxMin;
+	TraceUnsignedBaseType_t uxMax;
+} TraceIntervalAggregation_t;
+
+#endif
 
 /**
  * @defgroup trace_interval_apis Trace Interval APIs
@@ -88,6 +107,56 @@ traceResult xTraceIntervalStop(TraceIntervalChannelHandle_t xIntervalChannelHand
  */
 #define xTraceIntervalGetState(xIntervalChannelHandle, puxState) xTraceEntryGetState((TraceEntryHandle_t)(xIntervalChannelHandle), TRC_INTERVAL_CHANNEL_SET_INDEX, puxState)
 
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0)
+
+/**
+ * @brief Stores the aggregated intervals as User Events and resets them.
+ *
+ * Only available with TRC_CFG_INTERVAL_AGGREGATION_SLOTS. Stores one event per
+ * channel that had intervals since the last report, on a User Event channel
+ * with the channel name. The channel strings use one entry slot each. Durations
+ * are in timestamp ticks. Called periodically by TzCtrl.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceIntervalReport(void);
+
+/**
+ * @brief Gets the interval aggregation table.
+ *
+ * The table is an array of TraceIntervalAggregation_t and may be added to a
+ * DFM alert as a payload.
+ *
+ * @param[out] ppvData Pointer to the table.
+ * @param[out] puxSize Size of the table.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceIntervalGetAggregation(void** ppvData, TraceUnsignedBaseType_t* puxSize);
+
+/**
+ * @brief Sets if an aggregated interval channel should also store all events.
+ *
+ * @param[in] xIntervalChannelHandle Interval handle.
+ * @param[in] uxEnabled 1 to store all events, 0 to only aggregate.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+#define xTraceIntervalSetRawEvents(xIntervalChannelHandle, uxEnabled) xTraceEntrySetState((TraceEntryHandle_t)(xIntervalChannelHandle), TRC_INTERVAL_RAW_EVENTS_INDEX, uxEnabled)
+
+#else
+
+#define xTraceIntervalReport() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceIntervalGetAggregation(_ppvData, _puxSize) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(_ppvData), (void)(_puxSize), TRC_FAIL)
+
+#define xTraceIntervalSetRawEvents(_xIntervalHandle, _uxEnabled) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(_xIntervalHandle), (void)(_uxEnabled), TRC_SUCCESS)
+
+#endif
+
 /** @} */
 
 #ifdef __cplusplus
@@ -106,6 +175,12 @@ traceResult xTraceIntervalStop(TraceIntervalChannelHandle_t xIntervalChannelHand
 
 #define xTraceIntervalGetState(_xIntervalHandle, _puxState) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(_xIntervalHandle), (void)(_puxState), TRC_SUCCESS)
 
+#define xTraceIntervalReport() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceIntervalGetAggregation(_ppvData, _puxSize) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(_ppvData), (void)(_puxSize), TRC_FAIL)
+
+#define xTraceIntervalSetRawEvents(_xIntervalHandle, _uxEnabled) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(_xIntervalHandle), (void)(_uxEnabled), TRC_SUCCESS)
+
 #endif
 
 #endif
@@ -107,6 +107,14 @@ extern "C" {
 
 #define TRC_KERNEL_PORT_KERNEL_CAN_SWITCH_TO_SAME_TASK 0
 
+#if defined(TRC_CFG_HEAP_AGGREGATION_BLOCK_HEADER) && (TRC_CFG_HEAP_AGGREGATION_BLOCK_HEADER == 1) && !defined(TRC_KERNEL_PORT_HEAP_BLOCK_SIZE)
+/* traceMALLOC gets the requested size while heap_4/heap_5 pass the size of the
+ * whole block to traceFREE, which can be larger if the free block was not split.
+ * The block size is stored right below the returned address, with the top bit
+ * marking the block as allocated. Only valid for heap_4/heap_5. */
+#define TRC_KERNEL_PORT_HEAP_BLOCK_SIZE(xHeapHandle, pvAddress, uxSize) (((xHeapHandle) == xTraceKernelPortGetSystemHeapHandle()) ? (TraceUnsignedBaseType_t)(((const size_t*)(pvAddress))[-1] & ~((size_t)1 << ((sizeof(size_t) * 8u) - 1u))) : (uxSize))
+#endif
+
 #include <trcHeap.h>
 
 #define TRC_KERNEL_PORT_BUFFER_SIZE (sizeof(TraceHeapHandle_t) + sizeof(void*))
@@ -155,6 +163,18 @@ traceResult xTraceKernelPortEnable(void);
  */
 traceResult xTraceKernelPortDelay(uint32_t uiTicks);
 
+#if defined(TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) && ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+/**
+ * @internal Wakes up TzCtrl if the internal buffer has crossed the high water
+ * level since the last transfer (see TRC_CFG_CTRL_TASK_TRANSFER_BUDGET).
+ * Called from traceTASK_INCREMENT_TICK.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceKernelPortWakeTzCtrl(void);
+#endif
+
 /**
  * @internal Query if FreeRTOS scheduler is suspended
  *
@@ -310,6 +330,24 @@ void vTraceSetMessageBufferName(void* pvMessageBuffer, const char* szName);
   */
 traceResult xTraceKernelPortGetUnusedStack(void* pvTask, TraceUnsignedBaseType_t *puxUnusedStack);
 
+ /**
+  * @internal Retrieves the lowest address of the stack area for a task.
+  *
+  * The unused part of a descending stack starts here and is filled with
+  * TRC_KERNEL_PORT_STACK_FILL_WORD, which allows the stack monitor to scan
+  * it incrementally.
+  *
+  * @param[in] pvTask Task pointer
+  * @param[out] ppvStackBase The stack base
+  *
+  * @retval TRC_FAIL Failure, e.g. if the stack grows upwards
+  * @retval TRC_SUCCESS Success
+  */
+traceResult xTraceKernelPortGetStackBase(void* pvTask, void** ppvStackBase);
+
+/* The word pattern FreeRTOS fills unused task stacks with (tskSTACK_FILL_BYTE) */
+#define TRC_KERNEL_PORT_STACK_FILL_WORD 0xA5A5A5A5UL
+
 #endif
 
 #else
@@ -349,6 +387,11 @@ traceResult xTraceKernelPortGetUnusedStack(void* pvTask, TraceUnsignedBaseType_t
  */
 #define xTraceKernelPortGetUnusedStack(pvTask, puxUnusedStack) ((void)(pvTask), (void)(puxUnusedStack))
 
+/**
+ * @brief Disabled by TRC_CFG_SCHEDULING_ONLY
+ */
+#define xTraceKernelPortGetStackBase(pvTask, ppvStackBase) ((void)(pvTask), (void)(ppvStackBase))
+
 #endif
 
 /* Required for ISR tracing */
@@ -720,7 +763,19 @@ TraceHeapHandle_t xTraceKernelPortGetSystemHeapHandle(void);
 
 #define PSF_EVENT_DEPENDENCY_REGISTER						0xFC
 
-#define TRC_EVENT_LAST_ID									(PSF_EVENT_DEPENDENCY_REGISTER)
+#define PSF_EVENT_USER_EVENT_ARRAY							0xFD
+
+#define TRC_EVENT_LAST_ID									(PSF_EVENT_USER_EVENT_ARRAY)
+
+/* The events that xTraceEventSetDecimation() accepts, only successful queue and
+ * semaphore transfers. Task states, blocking, delays, suspend/resume and object
+ * creation are always stored, since Tracealyzer needs them to rebuild the timeline. */
+#define TRC_KERNEL_PORT_DECIMATION_EVENTS { \
+	PSF_EVENT_QUEUE_SEND, PSF_EVENT_QUEUE_SEND_FROMISR, \
+	PSF_EVENT_QUEUE_SEND_FRONT, PSF_EVENT_QUEUE_SEND_FRONT_FROMISR, \
+	PSF_EVENT_QUEUE_RECEIVE, PSF_EVENT_QUEUE_RECEIVE_FROMISR, \
+	PSF_EVENT_SEMAPHORE_GIVE, PSF_EVENT_SEMAPHORE_GIVE_FROMISR, \
+	PSF_EVENT_SEMAPHORE_TAKE, PSF_EVENT_SEMAPHORE_TAKE_FROMISR }
 
 /*** The trace macros for streaming ******************************************/
 
@@ -739,25 +794,38 @@ TraceHeapHandle_t xTraceKernelPortGetSystemHeapHandle(void);
 
 #endif
 
+#if defined(TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) && ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+
+#define TRC_KERNEL_PORT_TZCTRL_WAKEUP() (void)xTraceKernelPortWakeTzCtrl()
+
+#else
+
+#define TRC_KERNEL_PORT_TZCTRL_WAKEUP()
+
+#endif
+
 /* Called on each OS tick. Will call uiPortGetTimestamp to make sure it is called at least once every OS tick. */
 #undef traceTASK_INCREMENT_TICK
 #if TRC_CFG_FREERTOS_VERSION >= TRC_FREERTOS_VERSION_10_3_0
 
 #define traceTASK_INCREMENT_TICK( xTickCount ) \
 	if (uxSchedulerSuspended == ( TraceUnsignedBaseType_t ) pdTRUE || xPendedTicks == 0) { (void)xTraceTimestampSetOsTickCount((xTickCount) + 1); } \
-	OS_TICK_EVENT(uxSchedulerSuspended, (xTickCount) + 1)
+	OS_TICK_EVENT(uxSchedulerSuspended, (xTickCount) + 1); \
+	TRC_KERNEL_PORT_TZCTRL_WAKEUP()
 
 #elif TRC_CFG_FREERTOS_VERSION >= TRC_FREERTOS_VERSION_7_5_X
 
 #define traceTASK_INCREMENT_TICK( xTickCount ) \
 	if (uxSchedulerSuspended == ( TraceUnsignedBaseType_t ) pdTRUE || uxPendedTicks == 0) { (void)xTraceTimestampSetOsTickCount((xTickCount) + 1); } \
-	OS_TICK_EVENT(uxSchedulerSuspended, (xTickCount) + 1)
+	OS_TICK_EVENT(uxSchedulerSuspended, (xTickCount) + 1); \
+	TRC_KERNEL_PORT_TZCTRL_WAKEUP()
 
 #else
 
 #define traceTASK_INCREMENT_TICK( xTickCount ) \
 	if (uxSchedulerSuspended == ( TraceUnsignedBaseType_t ) pdTRUE || uxMissedTicks == 0) { (void)xTraceTimestampSetOsTickCount((xTickCount) + 1); } \
-	OS_TICK_EVENT(uxSchedulerSuspended, (xTickCount) + 1)
+	OS_TICK_EVENT(uxSchedulerSuspended, (xTickCount) + 1); \
+	TRC_KERNEL_PORT_TZCTRL_WAKEUP()
 
 #endif
 
@@ -188,6 +188,25 @@ traceResult xTraceMultiCoreEventBufferTransferChunk(const TraceMultiCoreEventBuf
  */
 traceResult xTraceMultiCoreEventBufferClear(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer);
 
+/**
+ * @brief Merges the events of all cores into one timestamp ordered buffer.
+ *
+ * Does a k-way merge of the per-core event buffers, oldest event first. If the
+ * destination is too small the oldest events are left out, so the newest
+ * events are always kept. Tracing must be paused (xTracePause) or disabled
+ * while merging, since the per-core buffers are read without locking.
+ *
+ * @param[in] pxTraceMultiCoreEventBuffer Pointer to initialized multi-core trace event buffer.
+ * @param[out] puiDestination Destination buffer.
+ * @param[in] uiDestinationSize Destination buffer size.
+ * @param[out] puiBytesWritten Number of bytes written to the destination.
+ * @param[out] puiEventsLeftOut Number of events that didn't fit.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceMultiCoreEventBufferMerge(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint8_t* puiDestination, uint32_t uiDestinationSize, uint32_t* puiBytesWritten, uint32_t* puiEventsLeftOut);
+
 /** @} */
 
 #ifdef __cplusplus
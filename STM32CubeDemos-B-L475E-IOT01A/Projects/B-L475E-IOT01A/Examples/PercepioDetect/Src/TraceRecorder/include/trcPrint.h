@@ -15,6 +15,22 @@
 #ifndef TRC_PRINT_H
 #define TRC_PRINT_H
 
+#ifndef TRC_CFG_PRINT_ARRAY_FLUSH_TICKS
+#define TRC_CFG_PRINT_ARRAY_FLUSH_TICKS 10
+#endif
+
+/* Element types for xTracePrintArray() */
+#define TRC_PRINT_ARRAY_TYPE_INT16 1U
+#define TRC_PRINT_ARRAY_TYPE_INT32 2U
+#define TRC_PRINT_ARRAY_TYPE_FLOAT 3U
+
+/* Expands to the number of parameters following the format string, or to an undefined macro name if there are more than 4 */
+#define TRC_PRINT_COUNT_ARGS(...) TRC_PRINT_COUNT_ARGS_HELPER(__VA_ARGS__, TOO_MANY_ARGS, 4, 3, 2, 1, 0, TOO_MANY_ARGS)
+#define TRC_PRINT_COUNT_ARGS_HELPER(_f, _p1, _p2, _p3, _p4, _p5, N, ...) N
+
+#define TRC_PRINT_CONCAT(a, b) TRC_PRINT_CONCAT_HELPER(a, b)
+#define TRC_PRINT_CONCAT_HELPER(a, b) a##b
+
 #if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_CFG_INCLUDE_USER_EVENTS == 1)
 
 #include <stdarg.h>
@@ -289,6 +305,60 @@ traceResult xTracePrintCompactF(const char* szChannel, const char* szFormat, ...
  */
 #define xTracePrintF4(xChannelStringHandle, xFormatStringHandle, uxParam1, uxParam2, uxParam3, uxParam4) xTraceEventCreate6(PSF_EVENT_USER_EVENT_FIXED + 4, (TraceUnsignedBaseType_t)(xChannelStringHandle), (TraceUnsignedBaseType_t)(xFormatStringHandle), uxParam1, uxParam2, uxParam3, uxParam4)
 
+/**
+ * @brief Generate a "User Event" with 0-4 parameters and a format string that
+ * is registered on first use.
+ *
+ * Same event as xTracePrintF0() - xTracePrintF4(), but without having to
+ * register the format string up front. The number of parameters is counted by
+ * the preprocessor and each call site keeps the format string handle in a
+ * static variable, so the format string is never parsed on target and only
+ * registered the first time the call is made. This makes it suitable for high
+ * rate data logging where xTracePrintF() would spend most of its time counting
+ * format specifiers.
+ *
+ * Every parameter is stored as a TraceUnsignedBaseType_t. Parameters larger
+ * than that are rejected at compile time, as are floating point parameters when
+ * compiled as C11 or later.
+ *
+ * This is a statement, not an expression, so the result cannot be checked.
+ *
+ * Example:
+ * 	TraceStringHandle_t xChannel;
+ *	xTraceStringRegister("MyChannel", &xChannel);
+ *	...
+ *	xTracePrintFCached(xChannel, "X: %d Y: %d", x, y);
+ *
+ * @param[in] xChannel Channel handle.
+ * @param[in] ... Format string literal followed by 0-4 parameters.
+ */
+#define xTracePrintFCached(xChannel, ...) TRC_PRINT_CONCAT(TRC_PRINT_CACHED_, TRC_PRINT_COUNT_ARGS(__VA_ARGS__))(xChannel, __VA_ARGS__)
+
+#if defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201112L)
+#define TRC_PRINT_ARG_IS_VALID(x) ((sizeof(x) <= sizeof(TraceUnsignedBaseType_t)) && _Generic((x), float: 0, double: 0, long double: 0, default: 1))
+#else
+#define TRC_PRINT_ARG_IS_VALID(x) (sizeof(x) <= sizeof(TraceUnsignedBaseType_t))
+#endif
+
+/* Casts a parameter to TraceUnsignedBaseType_t, fails to compile if it doesn't fit */
+#define TRC_PRINT_ARG(x) ((TraceUnsignedBaseType_t)(x) + (0U * sizeof(char[TRC_PRINT_ARG_IS_VALID(x) ? 1 : -1])))
+
+#define TRC_PRINT_CACHED(szFormat, xPrintCall) \
+	do \
+	{ \
+		static TraceStringHandle_t xTRC_PRINT_FORMAT = 0; \
+		if ((xTRC_PRINT_FORMAT != 0) || (xTraceStringRegister(szFormat, &xTRC_PRINT_FORMAT) == TRC_SUCCESS)) \
+		{ \
+			(void)(xPrintCall); \
+		} \
+	} while (0)
+
+#define TRC_PRINT_CACHED_0(xChannel, szFormat) TRC_PRINT_CACHED(szFormat, xTracePrintF0(xChannel, xTRC_PRINT_FORMAT))
+#define TRC_PRINT_CACHED_1(xChannel, szFormat, p1) TRC_PRINT_CACHED(szFormat, xTracePrintF1(xChannel, xTRC_PRINT_FORMAT, TRC_PRINT_ARG(p1)))
+#define TRC_PRINT_CACHED_2(xChannel, szFormat, p1, p2) TRC_PRINT_CACHED(szFormat, xTracePrintF2(xChannel, xTRC_PRINT_FORMAT, TRC_PRINT_ARG(p1), TRC_PRINT_ARG(p2)))
+#define TRC_PRINT_CACHED_3(xChannel, szFormat, p1, p2, p3) TRC_PRINT_CACHED(szFormat, xTracePrintF3(xChannel, xTRC_PRINT_FORMAT, TRC_PRINT_ARG(p1), TRC_PRINT_ARG(p2), TRC_PRINT_ARG(p3)))
+#define TRC_PRINT_CACHED_4(xChannel, szFormat, p1, p2, p3, p4) TRC_PRINT_CACHED(szFormat, xTracePrintF4(xChannel, xTRC_PRINT_FORMAT, TRC_PRINT_ARG(p1), TRC_PRINT_ARG(p2), TRC_PRINT_ARG(p3), TRC_PRINT_ARG(p4)))
+
 /**
  * @brief Generate "User Events" with unformatted text.
  * 
@@ -411,6 +481,119 @@ traceResult xTracePrintF(TraceStringHandle_t xChannel, const char* szFormat, ...
  */
 traceResult xTraceVPrintF(TraceStringHandle_t xChannel, const char* szFormat, va_list* pxVariableList);
 
+/**
+ * @brief The maximum number of bytes of samples stored in one array event.
+ *
+ * 48 bytes on a 32-bit system, i.e. 24 int16 or 12 int32/float samples.
+ */
+#define TRC_PRINT_ARRAY_MAX_SIZE (TRC_MAX_BLOB_SIZE - 8UL - (2UL * sizeof(TraceUnsignedBaseType_t)))
+
+/**
+ * @brief Returns the size in bytes of an element type, or 0 if the type is unknown.
+ */
+#define TRC_PRINT_ARRAY_ELEMENT_SIZE(uiElementType) (((uiElementType) == TRC_PRINT_ARRAY_TYPE_INT16) ? 2U : ((((uiElementType) == TRC_PRINT_ARRAY_TYPE_INT32) || ((uiElementType) == TRC_PRINT_ARRAY_TYPE_FLOAT)) ? 4U : 0U))
+
+typedef struct TracePrintArrayBuffer	/* Aligned */
+{
+	TraceStringHandle_t xChannel;
+	uint32_t uiElementType;
+	uint32_t uiCount;
+	uint32_t uiFirstTick;
+	struct TracePrintArrayBuffer* pxNext;
+	TraceUnsignedBaseType_t uxData[TRC_PRINT_ARRAY_MAX_SIZE / sizeof(TraceUnsignedBaseType_t)];
+} TracePrintArrayBuffer_t;
+
+/**
+ * @brief Generate a "User Event" with an array of samples.
+ *
+ * Stores up to TRC_PRINT_ARRAY_MAX_SIZE bytes of packed int16, int32 or float
+ * samples in one event, so logging e.g. the three axes of an accelerometer
+ * costs one event header, timestamp and critical section instead of three.
+ * Samples that don't fit are not stored. The event is not shown by
+ * Tracealyzer, use TraceRecorder/tools/print_array_decoder.py to extract the
+ * samples from a trace.
+ *
+ * Example:
+ * 	TraceStringHandle_t xChannel;
+ *	int16_t asXYZ[3];
+ *
+ *	xTraceStringRegister("Acc", &xChannel);
+ *	...
+ *	xTracePrintArray(xChannel, TRC_PRINT_ARRAY_TYPE_INT16, asXYZ, 3);
+ *
+ * @param[in] xChannel Channel handle.
+ * @param[in] uiElementType TRC_PRINT_ARRAY_TYPE_INT16, TRC_PRINT_ARRAY_TYPE_INT32 or TRC_PRINT_ARRAY_TYPE_FLOAT.
+ * @param[in] pvData Pointer to the samples.
+ * @param[in] uiCount Number of samples.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTracePrintArray(TraceStringHandle_t xChannel, uint32_t uiElementType, const void* pvData, uint32_t uiCount);
+
+/**
+ * @brief Initialize a print array buffer.
+ *
+ * A print array buffer collects samples for one channel and stores them with
+ * xTracePrintArray() when it is full, or when the oldest sample is older than
+ * TRC_CFG_PRINT_ARRAY_FLUSH_TICKS. The event then also records how many OS
+ * ticks before the event the first sample was added. The buffer is registered
+ * so that TzCtrl can flush it, and must stay valid while the recorder runs.
+ *
+ * Example:
+ *	static TracePrintArrayBuffer_t xAccBuffer;
+ *	...
+ *	xTracePrintArrayBufferInitialize(&xAccBuffer, xChannel, TRC_PRINT_ARRAY_TYPE_INT16);
+ *	...
+ *	xTracePrintArrayBufferAdd(&xAccBuffer, asXYZ, 3);
+ *
+ * @param[out] pxBuffer Buffer.
+ * @param[in] xChannel Channel handle.
+ * @param[in] uiElementType TRC_PRINT_ARRAY_TYPE_INT16, TRC_PRINT_ARRAY_TYPE_INT32 or TRC_PRINT_ARRAY_TYPE_FLOAT.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTracePrintArrayBufferInitialize(TracePrintArrayBuffer_t* pxBuffer, TraceStringHandle_t xChannel, uint32_t uiElementType);
+
+/**
+ * @brief Add samples to a print array buffer.
+ *
+ * The buffer is flushed first if the samples don't fit, or if the oldest sample
+ * is older than TRC_CFG_PRINT_ARRAY_FLUSH_TICKS, and again if it is full
+ * afterwards.
+ *
+ * @param[in] pxBuffer Buffer.
+ * @param[in] pvData Pointer to the samples, of the buffer's element type.
+ * @param[in] uiCount Number of samples. At most TRC_PRINT_ARRAY_MAX_SIZE bytes.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTracePrintArrayBufferAdd(TracePrintArrayBuffer_t* pxBuffer, const void* pvData, uint32_t uiCount);
+
+/**
+ * @brief Store the samples in a print array buffer, if any.
+ *
+ * @param[in] pxBuffer Buffer.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTracePrintArrayBufferFlush(TracePrintArrayBuffer_t* pxBuffer);
+
+/**
+ * @brief Store the samples in all print array buffers whose oldest sample is
+ * older than TRC_CFG_PRINT_ARRAY_FLUSH_TICKS.
+ *
+ * Catches buffers that no more samples are added to. Called periodically by
+ * TzCtrl.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTracePrintArrayBufferFlushExpired(void);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -440,6 +623,24 @@ typedef struct TracePrintData
 #define xTracePrintF3(_c, _f, _p1, _p2, _p3) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_6((void)(_c), (void)(_f), (void)(_p1), (void)(_p2), (void)(_p3), TRC_SUCCESS)
 #define xTracePrintF4(_c, _f, _p1, _p2, _p3, _p4) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_7((void)(_c), (void)(_f), (void)(_p1), (void)(_p2), (void)(_p3), (void)(_p4), TRC_SUCCESS)
 
+#define xTracePrintFCached(_c, ...) TRC_PRINT_CONCAT(TRC_PRINT_CACHED_DISABLED_, TRC_PRINT_COUNT_ARGS(__VA_ARGS__))(_c, __VA_ARGS__)
+#define TRC_PRINT_CACHED_DISABLED_0(_c, _f) do { (void)(_c); } while (0)
+#define TRC_PRINT_CACHED_DISABLED_1(_c, _f, _p1) do { (void)(_c); (void)(_p1); } while (0)
+#define TRC_PRINT_CACHED_DISABLED_2(_c, _f, _p1, _p2) do { (void)(_c); (void)(_p1); (void)(_p2); } while (0)
+#define TRC_PRINT_CACHED_DISABLED_3(_c, _f, _p1, _p2, _p3) do { (void)(_c); (void)(_p1); (void)(_p2); (void)(_p3); } while (0)
+#define TRC_PRINT_CACHED_DISABLED_4(_c, _f, _p1, _p2, _p3, _p4) do { (void)(_c); (void)(_p1); (void)(_p2); (void)(_p3); (void)(_p4); } while (0)
+
+typedef struct TracePrintArrayBuffer
+{
+	TraceUnsignedBaseType_t buffer[1];
+} TracePrintArrayBuffer_t;
+
+#define xTracePrintArray(_c, _t, _d, _n) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_5((void)(_c), (void)(_t), (void)(_d), (void)(_n), TRC_SUCCESS)
+#define xTracePrintArrayBufferInitialize(_b, _c, _t) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_4((void)(_b), (void)(_c), (void)(_t), TRC_SUCCESS)
+#define xTracePrintArrayBufferAdd(_b, _d, _n) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_4((void)(_b), (void)(_d), (void)(_n), TRC_SUCCESS)
+#define xTracePrintArrayBufferFlush(_b) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_2((void)(_b), TRC_SUCCESS)
+#define xTracePrintArrayBufferFlushExpired() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
 #define xTracePrintCompactF xTracePrintF
 #define xTracePrintCompactF0 xTracePrintF0
 #define xTracePrintCompactF1 xTracePrintF1
@@ -34,6 +34,8 @@ typedef struct TraceStackMonitorEntry	/* Aligned */
 {
 	void *pvTask;
 	TraceUnsignedBaseType_t uxPreviousLowWaterMark;
+	void *pvStackBase;
+	TraceUnsignedBaseType_t uxScanOffset;
 } TraceStackMonitorEntry_t;
 
 typedef struct TraceStackMonitorData	/* Aligned */
@@ -91,7 +93,10 @@ traceResult xTraceStackMonitorGetAtIndex(uint32_t uiIndex, void** ppvTask, Trace
  * 
  * This routine performs a trace stack monitor check and report
  * for TRC_CFG_STACK_MONITOR_MAX_REPORTS number of registered
- * tasks/threads.
+ * tasks/threads. If TRC_CFG_STACK_MONITOR_SCAN_WORDS is non-zero, at most
+ * that many stack words are checked per call. A task is then reported when
+ * the scan of the area below its previous low water mark has completed,
+ * which may take several calls.
  * 
  * @retval TRC_FAIL Failure
  * @retval TRC_SUCCESS Success
@@ -17,12 +17,29 @@
 
 #include <trcTypes.h>
 
+#ifndef TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS
+#define TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS 0
+#endif
+
 #if (TRC_USE_TRACEALYZER_RECORDER == 1)
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define TRC_STATE_MACHINE_RAW_EVENTS_INDEX 2u
+
+#if (TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS > 0)
+
+typedef struct TraceStateMachineAggregation	/* Aligned */
+{
+	TraceStateMachineStateHandle_t xStateHandle;
+	TraceUnsignedBaseType_t uxCount;
+	TraceUnsignedBaseType_t uxTotal;
+} TraceStateMachineAggregation_t;
+
+#endif
+
 /**
  * @defgroup trace_state_machine_apis Trace State Machine APIs
  * @ingroup trace_recorder_apis
@@ -63,6 +80,57 @@ traceResult xTraceStateMachineStateCreate(TraceStateMachineHandle_t xStateMachin
  */
 traceResult xTraceStateMachineSetState(TraceStateMachineHandle_t xStateMachineHandle, TraceStateMachineStateHandle_t xStateHandle);
 
+#if (TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS > 0)
+
+/**
+ * @brief Stores the aggregated states as User Events and resets them.
+ *
+ * Only available with TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS. Stores one
+ * event per state that was left since the last report, on a User Event
+ * channel with the state name. The channel strings use one entry slot each.
+ * Times are in timestamp ticks and are added when a state is left. Called
+ * periodically by TzCtrl.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStateMachineReport(void);
+
+/**
+ * @brief Gets the state aggregation table.
+ *
+ * The table is an array of TraceStateMachineAggregation_t and may be added to
+ * a DFM alert as a payload.
+ *
+ * @param[out] ppvData Pointer to the table.
+ * @param[out] puxSize Size of the table.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStateMachineGetAggregation(void** ppvData, TraceUnsignedBaseType_t* puxSize);
+
+/**
+ * @brief Sets if an aggregated state machine should also store all state changes.
+ *
+ * @param[in] xStateMachineHandle Pointer to initialized trace state machine.
+ * @param[in] uxEnabled 1 to store all state changes, 0 to only aggregate.
+ *
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+#define xTraceStateMachineSetRawEvents(xStateMachineHandle, uxEnabled) xTraceEntrySetState((TraceEntryHandle_t)(xStateMachineHandle), TRC_STATE_MACHINE_RAW_EVENTS_INDEX, uxEnabled)
+
+#else
+
+#define xTraceStateMachineReport() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceStateMachineGetAggregation(__ppvData, __puxSize) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(__ppvData), (void)(__puxSize), TRC_FAIL)
+
+#define xTraceStateMachineSetRawEvents(__xStateMachineHandle, __uxEnabled) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_3((void)(__xStateMachineHandle), (void)(__uxEnabled), TRC_SUCCESS)
+
+#endif
+
 /** @} */
 
 #ifdef __cplusplus
@@ -77,6 +145,12 @@ traceResult xTraceStateMachineSetState(TraceStateMachineHandle_t xStateMachineHa
 
 #define xTraceStateMachineSetState(__xStateMachineHandle, __xStateHandle) ((void)(__xStateMachineHandle), (void)(__xStateHandle), TRC_SUCCESS)
 
+#define xTraceStateMachineReport() (TRC_SUCCESS)
+
+#define xTraceStateMachineGetAggregation(__ppvData, __puxSize) ((void)(__ppvData), (void)(__puxSize), TRC_FAIL)
+
+#define xTraceStateMachineSetRawEvents(__xStateMachineHandle, __uxEnabled) ((void)(__xStateMachineHandle), (void)(__uxEnabled), TRC_SUCCESS)
+
 #endif
 
 #endif
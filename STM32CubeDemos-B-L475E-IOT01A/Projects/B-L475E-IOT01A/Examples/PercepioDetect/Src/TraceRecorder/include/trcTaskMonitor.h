@@ -23,6 +23,10 @@
 #define TRC_KERNEL_PORT_SUPPORTS_TLS 0
 #endif
 
+#ifndef TRC_CFG_TASK_MONITOR_WINDOW_MS
+#define TRC_CFG_TASK_MONITOR_WINDOW_MS 0
+#endif
+
 typedef struct TraceTaskMonitorCallbackData
 {
 	void* pvTaskAddress;
@@ -60,6 +64,10 @@ typedef struct TraceTaskMonitorTaskData
 	TraceUnsignedBaseType_t uxHigh;
         TraceUnsignedBaseType_t uxWatermarkLow;
         TraceUnsignedBaseType_t uxWatermarkHigh;
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+	uint32_t uiWindowStart;
+	uint32_t uiWindowReported;	/* Set when the high limit has been reported in the current window */
+#endif
 } TraceTaskMonitorTaskData_t;
 
 /**
@@ -69,6 +77,10 @@ typedef struct TraceTaskMonitorData	/* Aligned */
 {
 	uint32_t uiPollTimestamp;
 	uint32_t uiLastTimestamp[TRC_ALIGN_FLOOR(TRC_CFG_CORE_COUNT, 2) + 1];	/* Will FLOOR the core count to a multiple of 2, then add 1 to ensure aligned struct with uiPollTimestamp */
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+	uint32_t uiWindowTicks;
+	uint32_t reserved;	/* alignment */
+#endif
 	TraceTaskMonitorCallback_t xCallback;
 	TraceTaskMonitorTaskData_t xMonitoredTasks[TRC_CFG_TASK_MONITOR_MAX_TASKS];
 	TraceTaskMonitorCallbackData_t xCallbackData; /* Data that will be used for callback */
@@ -138,6 +150,9 @@ traceResult xTraceTaskMonitorGetEmptySlot(TraceTaskMonitorTaskData_t** ppxData);
 
 /**
  * @brief Update a task's load. Should be called when task is switched out.
+ * If TRC_CFG_TASK_MONITOR_WINDOW_MS is set, this also checks the task's load
+ * and latches it if it is outside the accepted range. The callback is then
+ * called by the next xTraceTaskMonitorPoll().
  * 
  * @param[in] pvTask Task.
  * 
@@ -148,7 +163,9 @@ traceResult xTraceTaskMonitorSwitchOut(void* pvTask);
 
 /**
  * @brief Call this regularly to poll the system and check if any tasks are
- * outside the accepted range.
+ * outside the accepted range. If TRC_CFG_TASK_MONITOR_WINDOW_MS is set, this
+ * only ends the windows of tasks that have not been switched out during a
+ * whole window, and calls the callback with any failure latched on switch out.
  * 
  * @retval TRC_FAIL Failure
  * @retval TRC_SUCCESS Success
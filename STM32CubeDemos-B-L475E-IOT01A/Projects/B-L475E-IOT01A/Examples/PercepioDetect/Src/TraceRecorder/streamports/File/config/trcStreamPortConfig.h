@@ -81,6 +81,61 @@ extern "C" {
  */
 #define TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT 5
 
+/**
+ * @def TRC_CFG_STREAM_PORT_USE_MMAP
+ *
+ * @brief Set to 1 to write the trace through a memory mapped file instead of
+ * fwrite. The traced code then only copies the event into the mapping, while a
+ * background thread periodically flushes the written range to disk. Requires a
+ * POSIX host (mmap and pthreads), i.e. it is meant for host and simulator builds.
+ *
+ * The file is pre-sized and grown in steps, and the unused tail is zero filled.
+ * A file left behind by a crash therefore holds a prefix of the trace followed by
+ * zeroes, which are read as null events. After a crash of the traced process only
+ * the event being copied at that moment can be incomplete, after a crash of the
+ * host the prefix ends at the last flush. On a clean trace end the file is
+ * truncated to the written length.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_STREAM_PORT_USE_MMAP 0
+
+/**
+ * @def TRC_CFG_STREAM_PORT_MMAP_INITIAL_SIZE
+ *
+ * @brief The size in bytes that the trace file is created with when
+ * TRC_CFG_STREAM_PORT_USE_MMAP is 1.
+ */
+#define TRC_CFG_STREAM_PORT_MMAP_INITIAL_SIZE (1024UL * 1024UL)
+
+/**
+ * @def TRC_CFG_STREAM_PORT_MMAP_GROW_SIZE
+ *
+ * @brief The minimum number of bytes the trace file and its mapping are grown
+ * by when a write does not fit.
+ */
+#define TRC_CFG_STREAM_PORT_MMAP_GROW_SIZE (1024UL * 1024UL)
+
+/**
+ * @def TRC_CFG_STREAM_PORT_MMAP_FLUSH_PERIOD_MS
+ *
+ * @brief The period in milliseconds of the background flusher thread. Each
+ * period it flushes the range written since the previous flush.
+ */
+#define TRC_CFG_STREAM_PORT_MMAP_FLUSH_PERIOD_MS 100
+
+/**
+ * @def TRC_CFG_STREAM_PORT_MMAP_FLUSH_SYNC
+ *
+ * @brief Set to 1 to make each periodic flush durable (msync with MS_SYNC
+ * followed by fdatasync). Set to 0 to only schedule write back (msync with
+ * MS_ASYNC), which protects against a crash of the traced process but not
+ * against a crash of the host.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_STREAM_PORT_MMAP_FLUSH_SYNC 0
+
 #ifdef __cplusplus
 }
 #endif
@@ -42,9 +42,45 @@ extern "C" {
 #define TRC_CFG_STREAM_PORT_TRACE_FILE "trace.psf"
 #endif
 
+#ifndef TRC_CFG_STREAM_PORT_USE_MMAP
+#define TRC_CFG_STREAM_PORT_USE_MMAP 0
+#endif
+
+#if (TRC_CFG_STREAM_PORT_USE_MMAP == 1)
+#include <stddef.h>
+#include <pthread.h>
+
+#ifndef TRC_CFG_STREAM_PORT_MMAP_INITIAL_SIZE
+#define TRC_CFG_STREAM_PORT_MMAP_INITIAL_SIZE (1024UL * 1024UL)
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_MMAP_GROW_SIZE
+#define TRC_CFG_STREAM_PORT_MMAP_GROW_SIZE (1024UL * 1024UL)
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_MMAP_FLUSH_PERIOD_MS
+#define TRC_CFG_STREAM_PORT_MMAP_FLUSH_PERIOD_MS 100
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_MMAP_FLUSH_SYNC
+#define TRC_CFG_STREAM_PORT_MMAP_FLUSH_SYNC 0
+#endif
+#endif
+
 typedef struct TraceStreamPortFile	/* Aligned */
 {
+#if (TRC_CFG_STREAM_PORT_USE_MMAP == 1)
+	int iFileDescriptor;
+	uint8_t* puiMapping;
+	size_t uxMappingSize;
+	volatile size_t uxWritten;	/* Only advanced after an event is completely copied */
+	size_t uxFlushed;
+	volatile uint32_t uiFlusherRunning;
+	pthread_t xFlusherThread;
+	pthread_mutex_t xMappingLock;	/* Held while remapping and while flushing */
+#else
 	FILE* pxFile;
+#endif
 #if (TRC_USE_INTERNAL_BUFFER)
 	uint8_t buffer[TRC_ALIGNED_STREAM_PORT_BUFFER_SIZE];
 #endif
@@ -122,7 +158,11 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
  * @retval TRC_FAIL Write failed
  * @retval TRC_SUCCESS Success
  */
+#if (TRC_CFG_STREAM_PORT_USE_MMAP == 1)
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten);
+#else
 #define xTraceStreamPortWriteData(pvData, uiSize, piBytesWritten) (*(piBytesWritten) = (int32_t)fwrite(pvData, 1, uiSize, pxStreamPortFile->pxFile), TRC_SUCCESS)
+#endif
 
 /**
  * @brief Reads data through the stream port interface.
@@ -16,8 +16,141 @@
 
 #if (TRC_USE_TRACEALYZER_RECORDER == 1)
 
+#if (TRC_CFG_STREAM_PORT_USE_MMAP == 1)
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
 TraceStreamPortFile_t* pxStreamPortFile TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
+#if (TRC_CFG_STREAM_PORT_USE_MMAP == 1)
+
+static size_t prvTraceStreamPortPageAlign(size_t uxSize)
+{
+	size_t uxPageSize = (size_t)sysconf(_SC_PAGESIZE);
+
+	return ((uxSize + uxPageSize - 1u) / uxPageSize) * uxPageSize;
+}
+
+/* Flushes the range written since the previous flush. Must be called with xMappingLock held. */
+static void prvTraceStreamPortFlush(int iFlags)
+{
+	size_t uxPageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t uxWritten = pxStreamPortFile->uxWritten;
+	size_t uxStart = (pxStreamPortFile->uxFlushed / uxPageSize) * uxPageSize;
+
+	if (uxWritten <= pxStreamPortFile->uxFlushed)
+	{
+		return;
+	}
+
+	(void)msync(&pxStreamPortFile->puiMapping[uxStart], uxWritten - uxStart, iFlags);
+
+	if (iFlags == MS_SYNC)
+	{
+		(void)fdatasync(pxStreamPortFile->iFileDescriptor);
+	}
+
+	pxStreamPortFile->uxFlushed = uxWritten;
+}
+
+static void* prvTraceStreamPortFlusher(void* pvArgument)
+{
+	struct timespec xPeriod;
+
+	(void)pvArgument;
+
+	xPeriod.tv_sec = (TRC_CFG_STREAM_PORT_MMAP_FLUSH_PERIOD_MS) / 1000;
+	xPeriod.tv_nsec = ((TRC_CFG_STREAM_PORT_MMAP_FLUSH_PERIOD_MS) % 1000) * 1000000L;
+
+	while (pxStreamPortFile->uiFlusherRunning != 0u)
+	{
+		(void)nanosleep(&xPeriod, 0);
+
+		(void)pthread_mutex_lock(&pxStreamPortFile->xMappingLock);
+#if (TRC_CFG_STREAM_PORT_MMAP_FLUSH_SYNC == 1)
+		prvTraceStreamPortFlush(MS_SYNC);
+#else
+		prvTraceStreamPortFlush(MS_ASYNC);
+#endif
+		(void)pthread_mutex_unlock(&pxStreamPortFile->xMappingLock);
+	}
+
+	return 0;
+}
+
+/* Grows the file and its mapping so that at least uxRequiredSize bytes fit. */
+static traceResult prvTraceStreamPortGrow(size_t uxRequiredSize)
+{
+	size_t uxNewSize = pxStreamPortFile->uxMappingSize + (TRC_CFG_STREAM_PORT_MMAP_GROW_SIZE);
+	void* pvMapping;
+	traceResult xResult = TRC_FAIL;
+
+	if (uxNewSize < uxRequiredSize)
+	{
+		uxNewSize = uxRequiredSize;
+	}
+	uxNewSize = prvTraceStreamPortPageAlign(uxNewSize);
+
+	/* The flusher must not touch the mapping while it is replaced */
+	(void)pthread_mutex_lock(&pxStreamPortFile->xMappingLock);
+
+	if (ftruncate(pxStreamPortFile->iFileDescriptor, (off_t)uxNewSize) == 0)
+	{
+		pvMapping = mmap(0, uxNewSize, PROT_READ | PROT_WRITE, MAP_SHARED, pxStreamPortFile->iFileDescriptor, 0);
+		if (pvMapping != MAP_FAILED)
+		{
+			/* The old pages are shared with the file, so nothing is lost by unmapping them */
+			(void)munmap(pxStreamPortFile->puiMapping, pxStreamPortFile->uxMappingSize);
+			pxStreamPortFile->puiMapping = (uint8_t*)pvMapping;
+			pxStreamPortFile->uxMappingSize = uxNewSize;
+			xResult = TRC_SUCCESS;
+		}
+	}
+
+	(void)pthread_mutex_unlock(&pxStreamPortFile->xMappingLock);
+
+	return xResult;
+}
+
+traceResult xTraceStreamPortWriteData(void* pvData, uint32_t uiSize, int32_t* piBytesWritten)
+{
+	size_t uxWritten;
+
+	*piBytesWritten = 0;
+
+	/* We need to check this */
+	if ((pxStreamPortFile == 0) || (pxStreamPortFile->puiMapping == 0))
+	{
+		return TRC_FAIL;
+	}
+
+	uxWritten = pxStreamPortFile->uxWritten;
+
+	if ((uxWritten + uiSize) > pxStreamPortFile->uxMappingSize)
+	{
+		if (prvTraceStreamPortGrow(uxWritten + uiSize) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+	}
+
+	memcpy(&pxStreamPortFile->puiMapping[uxWritten], pvData, uiSize);
+
+	/* Only publish the new length after the event is completely copied */
+	pxStreamPortFile->uxWritten = uxWritten + uiSize;
+
+	*piBytesWritten = (int32_t)uiSize;
+
+	return TRC_SUCCESS;
+}
+
+#endif
+
 traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
 {
 	TRC_ASSERT_EQUAL_SIZE(TraceStreamPortBuffer_t, TraceStreamPortFile_t);
@@ -25,7 +158,21 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
 	TRC_ASSERT(pxBuffer != 0);
 
 	pxStreamPortFile = (TraceStreamPortFile_t*)pxBuffer;
+#if (TRC_CFG_STREAM_PORT_USE_MMAP == 1)
+	pxStreamPortFile->iFileDescriptor = -1;
+	pxStreamPortFile->puiMapping = 0;
+	pxStreamPortFile->uxMappingSize = 0;
+	pxStreamPortFile->uxWritten = 0;
+	pxStreamPortFile->uxFlushed = 0;
+	pxStreamPortFile->uiFlusherRunning = 0;
+
+	if (pthread_mutex_init(&pxStreamPortFile->xMappingLock, 0) != 0)
+	{
+		return TRC_FAIL;
+	}
+#else
 	pxStreamPortFile->pxFile = 0;
+#endif
 
 #if (TRC_USE_INTERNAL_BUFFER == 1)
 	return xTraceInternalEventBufferInitialize(pxStreamPortFile->buffer, sizeof(pxStreamPortFile->buffer));
@@ -41,6 +188,54 @@ traceResult xTraceStreamPortOnTraceBegin(void)
 		return TRC_FAIL;
 	}
 	
+#if (TRC_CFG_STREAM_PORT_USE_MMAP == 1)
+	if (pxStreamPortFile->puiMapping == 0)
+	{
+		size_t uxSize = prvTraceStreamPortPageAlign(TRC_CFG_STREAM_PORT_MMAP_INITIAL_SIZE);
+		void* pvMapping;
+		int iFileDescriptor = open(TRC_CFG_STREAM_PORT_TRACE_FILE, O_RDWR | O_CREAT | O_TRUNC, 0644);
+		if (iFileDescriptor < 0)
+		{
+			printf("Could not open trace file, error code %d.\n", errno);
+
+			return TRC_FAIL;
+		}
+
+		/* Pre-size the file, the unused tail reads as zeroes (null events) */
+		if (ftruncate(iFileDescriptor, (off_t)uxSize) != 0)
+		{
+			printf("Could not size trace file, error code %d.\n", errno);
+			(void)close(iFileDescriptor);
+
+			return TRC_FAIL;
+		}
+
+		pvMapping = mmap(0, uxSize, PROT_READ | PROT_WRITE, MAP_SHARED, iFileDescriptor, 0);
+		if (pvMapping == MAP_FAILED)
+		{
+			printf("Could not map trace file, error code %d.\n", errno);
+			(void)close(iFileDescriptor);
+
+			return TRC_FAIL;
+		}
+
+		pxStreamPortFile->iFileDescriptor = iFileDescriptor;
+		pxStreamPortFile->puiMapping = (uint8_t*)pvMapping;
+		pxStreamPortFile->uxMappingSize = uxSize;
+		pxStreamPortFile->uxWritten = 0;
+		pxStreamPortFile->uxFlushed = 0;
+		pxStreamPortFile->uiFlusherRunning = 1;
+
+		if (pthread_create(&pxStreamPortFile->xFlusherThread, 0, prvTraceStreamPortFlusher, 0) != 0)
+		{
+			/* Tracing still works, the data is only flushed when the trace ends */
+			pxStreamPortFile->uiFlusherRunning = 0;
+			printf("Could not start trace file flusher.\n");
+		}
+
+		printf("Trace file created.\n");
+	}
+#else
 	if (pxStreamPortFile->pxFile == 0)
 	{
 #if defined(__STDC_WANT_LIB_EXT1__) && __STDC_WANT_LIB_EXT1__ == 1
@@ -70,6 +265,7 @@ traceResult xTraceStreamPortOnTraceBegin(void)
 		}
 #endif
 	}
+#endif
 	
 	return TRC_SUCCESS;
 }
@@ -81,12 +277,36 @@ traceResult xTraceStreamPortOnTraceEnd(void)
 		return TRC_FAIL;
 	}
 	
+#if (TRC_CFG_STREAM_PORT_USE_MMAP == 1)
+	if (pxStreamPortFile->puiMapping != 0)
+	{
+		if (pxStreamPortFile->uiFlusherRunning != 0u)
+		{
+			pxStreamPortFile->uiFlusherRunning = 0;
+			(void)pthread_join(pxStreamPortFile->xFlusherThread, 0);
+		}
+
+		(void)pthread_mutex_lock(&pxStreamPortFile->xMappingLock);
+		prvTraceStreamPortFlush(MS_SYNC);
+		(void)munmap(pxStreamPortFile->puiMapping, pxStreamPortFile->uxMappingSize);
+		pxStreamPortFile->puiMapping = 0;
+		pxStreamPortFile->uxMappingSize = 0;
+		(void)pthread_mutex_unlock(&pxStreamPortFile->xMappingLock);
+
+		/* Drop the pre-sized tail so the file holds exactly the trace */
+		(void)ftruncate(pxStreamPortFile->iFileDescriptor, (off_t)pxStreamPortFile->uxWritten);
+		(void)close(pxStreamPortFile->iFileDescriptor);
+		pxStreamPortFile->iFileDescriptor = -1;
+		printf("Trace file closed.\n");
+	}
+#else
 	if (pxStreamPortFile->pxFile != 0)
 	{
 		fclose(pxStreamPortFile->pxFile);
 		pxStreamPortFile->pxFile = 0;
 		printf("Trace file closed.\n");
 	}
+#endif
 	
 	return TRC_SUCCESS;
 }
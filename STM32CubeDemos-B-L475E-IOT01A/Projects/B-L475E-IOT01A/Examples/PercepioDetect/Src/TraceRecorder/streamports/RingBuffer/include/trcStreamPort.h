@@ -132,6 +132,23 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
  */
 #define xTraceStreamPortCommit(_pvData, _uiSize, _piBytesCommitted) xTraceMultiCoreEventBufferAllocCommit(&pxStreamPortData->xMultiCoreEventBuffer, _pvData, _uiSize, _piBytesCommitted)
 
+/**
+ * @brief Copies the events of all cores, ordered by timestamp, to a buffer.
+ *
+ * The events in the ring buffer are kept per core. This merges them into one
+ * sequence, e.g. for a DFM payload. The oldest events are left out if the
+ * destination is too small. Tracing must be paused while merging.
+ *
+ * @param[out] _puiDestination Destination buffer
+ * @param[in] _uiDestinationSize Destination buffer size
+ * @param[out] _puiBytesWritten Bytes written
+ * @param[out] _puiEventsLeftOut Events that didn't fit
+ *
+ * @retval TRC_FAIL Merge failed
+ * @retval TRC_SUCCESS Success
+ */
+#define xTraceStreamPortMergeEvents(_puiDestination, _uiDestinationSize, _puiBytesWritten, _puiEventsLeftOut) xTraceMultiCoreEventBufferMerge(&pxStreamPortData->xMultiCoreEventBuffer, _puiDestination, _uiDestinationSize, _puiBytesWritten, _puiEventsLeftOut)
+
 /**
  * @brief Writes data through the stream port interface.
  * 
@@ -29,6 +29,37 @@ extern "C" {
  */
 #define TRC_CFG_STREAM_PORT_UDP_PORT 8888
 
+/**
+ * @def TRC_CFG_STREAM_PORT_UDP_BATCHING
+ *
+ * @brief Set to 1 to pack the trace data into datagrams of up to
+ * TRC_CFG_STREAM_PORT_UDP_MAX_DATAGRAM_SIZE bytes instead of sending one datagram
+ * per transfer. Each datagram starts with an 8 byte header, all fields little endian:
+ * a 32-bit sequence number (restarting at 0 when tracing begins), the 16-bit payload
+ * offset of the first transfer that starts in the datagram (0xFFFF if none) and the
+ * 16-bit payload length. A receiver can then detect lost datagrams and resume at the
+ * next transfer start, which is always an event boundary.
+ *
+ * The datagrams are not understood by Tracealyzer directly, use udp_receiver.py
+ * (found in this folder) to receive them and write a .psf file.
+ *
+ * Requires TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER 1 and
+ * TRC_INTERNAL_EVENT_BUFFER_OPTION_TRANSFER_MODE_ALL. A partially filled datagram
+ * is sent at the latest on the next xTraceTzCtrl() call.
+ *
+ * Default value is 0.
+ */
+#define TRC_CFG_STREAM_PORT_UDP_BATCHING 0
+
+/**
+ * @def TRC_CFG_STREAM_PORT_UDP_MAX_DATAGRAM_SIZE
+ *
+ * @brief The maximum size of a batched datagram, including the 8 byte header.
+ * Set it to the path MTU minus the IP and UDP headers (28 bytes for IPv4) to
+ * avoid IP fragmentation.
+ */
+#define TRC_CFG_STREAM_PORT_UDP_MAX_DATAGRAM_SIZE 1472
+
 /**
  * @def TRC_CFG_STREAM_PORT_USE_INTERNAL_BUFFER
  *
@@ -35,6 +35,24 @@ extern "C" {
 
 #define TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT (TRC_CFG_STREAM_PORT_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT)
 
+#ifndef TRC_CFG_STREAM_PORT_UDP_BATCHING
+#define TRC_CFG_STREAM_PORT_UDP_BATCHING 0
+#endif
+
+#ifndef TRC_CFG_STREAM_PORT_UDP_MAX_DATAGRAM_SIZE
+#define TRC_CFG_STREAM_PORT_UDP_MAX_DATAGRAM_SIZE 1472
+#endif
+
+#if (TRC_CFG_STREAM_PORT_UDP_BATCHING == 1)
+#if (TRC_USE_INTERNAL_BUFFER != 1) || (TRC_INTERNAL_EVENT_BUFFER_TRANSFER_MODE != TRC_INTERNAL_EVENT_BUFFER_OPTION_TRANSFER_MODE_ALL)
+#error "TRC_CFG_STREAM_PORT_UDP_BATCHING requires the internal buffer with TRC_INTERNAL_EVENT_BUFFER_OPTION_TRANSFER_MODE_ALL, since transfers must start on event boundaries!"
+#endif
+
+#if ((TRC_CFG_STREAM_PORT_UDP_MAX_DATAGRAM_SIZE) <= 8) || ((TRC_CFG_STREAM_PORT_UDP_MAX_DATAGRAM_SIZE) > 0xFFFF)
+#error "TRC_CFG_STREAM_PORT_UDP_MAX_DATAGRAM_SIZE must be larger than the 8 byte datagram header and fit in 16 bits!"
+#endif
+#endif
+
 typedef struct TraceStreamPortBuffer	/* Aligned */
 {
 #if (TRC_USE_INTERNAL_BUFFER)
@@ -99,7 +117,11 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer);
 
 #define xTraceStreamPortOnDisable() (TRC_SUCCESS)
 
+#if (TRC_CFG_STREAM_PORT_UDP_BATCHING == 1)
+traceResult xTraceStreamPortOnTraceBegin(void);
+#else
 #define xTraceStreamPortOnTraceBegin() (TRC_SUCCESS)
+#endif
 
 traceResult xTraceStreamPortOnTraceEnd(void);
 
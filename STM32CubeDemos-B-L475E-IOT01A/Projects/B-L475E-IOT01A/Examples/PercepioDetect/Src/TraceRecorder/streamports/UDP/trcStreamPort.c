@@ -19,6 +19,10 @@
 #include <lwip/sockets.h>
 #include <lwip/errno.h>
 
+#if (TRC_CFG_STREAM_PORT_UDP_BATCHING == 1)
+#include <string.h>
+#endif
+
 int sock = -1;
 int remoteSize;
 struct sockaddr_in address_out;
@@ -134,6 +138,127 @@ static int32_t prvSocketInitialize(void)
 
 /************** MODIFY THE ABOVE PART TO USE YOUR UDP STACK ****************/
 
+#if (TRC_CFG_STREAM_PORT_UDP_BATCHING == 1)
+
+#define TRC_STREAM_PORT_UDP_HEADER_SIZE 8u
+#define TRC_STREAM_PORT_UDP_PAYLOAD_SIZE ((uint32_t)(TRC_CFG_STREAM_PORT_UDP_MAX_DATAGRAM_SIZE) - TRC_STREAM_PORT_UDP_HEADER_SIZE)
+#define TRC_STREAM_PORT_UDP_NO_FIRST_TRANSFER 0xFFFFu
+
+/* Only accessed from xTraceTzCtrl() since batching requires the internal buffer */
+static uint8_t auiDatagram[TRC_CFG_STREAM_PORT_UDP_MAX_DATAGRAM_SIZE];
+static uint32_t uiDatagramSequence = 0u;
+static uint32_t uiDatagramPayloadSize = 0u;
+static uint32_t uiDatagramFirstTransfer = TRC_STREAM_PORT_UDP_NO_FIRST_TRANSFER;
+
+static void prvDatagramSetField(uint32_t uiOffset, uint32_t uiValue, uint32_t uiSize)
+{
+	uint32_t i;
+
+	for (i = 0u; i < uiSize; i++)
+	{
+		auiDatagram[uiOffset + i] = (uint8_t)(uiValue >> (8u * i));
+	}
+}
+
+static int32_t prvDatagramSend(void)
+{
+	int32_t iBytesWritten = 0;
+	int32_t iResult;
+
+	if (uiDatagramPayloadSize == 0u)
+	{
+		return 0;
+	}
+
+	prvDatagramSetField(0u, uiDatagramSequence, 4u);
+	prvDatagramSetField(4u, uiDatagramFirstTransfer, 2u);
+	prvDatagramSetField(6u, uiDatagramPayloadSize, 2u);
+
+	iResult = prvSocketSend(auiDatagram, TRC_STREAM_PORT_UDP_HEADER_SIZE + uiDatagramPayloadSize, &iBytesWritten);
+
+	/* A datagram that could not be sent still uses its sequence number, so the receiver sees the gap */
+	uiDatagramSequence++;
+	uiDatagramPayloadSize = 0u;
+	uiDatagramFirstTransfer = TRC_STREAM_PORT_UDP_NO_FIRST_TRANSFER;
+
+	return iResult;
+}
+
+int32_t prvTraceUdpWrite(void* pvData, uint32_t uiSize, int32_t *piBytesWritten)
+{
+	const uint8_t* puiData = (const uint8_t*)pvData;
+	uint32_t uiRemaining = uiSize;
+	uint32_t uiBytes;
+	int32_t iResult = 0;
+
+	if (piBytesWritten == (void*)0)
+	{
+		return -1;
+	}
+
+	*piBytesWritten = 0;
+
+	prvSocketInitialize();
+
+	/* Every transfer starts on an event boundary, the first one in each datagram is where a receiver can resynchronize */
+	if ((uiSize > 0u) && (uiDatagramFirstTransfer == TRC_STREAM_PORT_UDP_NO_FIRST_TRANSFER))
+	{
+		uiDatagramFirstTransfer = uiDatagramPayloadSize;
+	}
+
+	while (uiRemaining > 0u)
+	{
+		uiBytes = TRC_STREAM_PORT_UDP_PAYLOAD_SIZE - uiDatagramPayloadSize;
+		if (uiBytes > uiRemaining)
+		{
+			uiBytes = uiRemaining;
+		}
+
+		memcpy(&auiDatagram[TRC_STREAM_PORT_UDP_HEADER_SIZE + uiDatagramPayloadSize], puiData, uiBytes);
+		uiDatagramPayloadSize += uiBytes;
+		puiData += uiBytes;
+		uiRemaining -= uiBytes;
+
+		if (uiDatagramPayloadSize == TRC_STREAM_PORT_UDP_PAYLOAD_SIZE)
+		{
+			/* Datagrams already sent can't be taken back, so the rest is consumed too */
+			if (prvDatagramSend() != 0)
+			{
+				iResult = -1;
+			}
+		}
+	}
+
+	/* Everything is consumed, lost datagrams are reported through the sequence numbers instead */
+	*piBytesWritten = (int32_t)uiSize;
+
+	return iResult;
+}
+
+int32_t prvTraceUdpRead(void* pvData, uint32_t uiSize, int32_t *piBytesRead)
+{
+	prvSocketInitialize();
+
+	/* Called once per xTraceTzCtrl() loop, which bounds the latency of a partially filled datagram */
+	if (prvDatagramSend() != 0)
+	{
+		return -1;
+	}
+
+	return prvSocketReceive(pvData, uiSize, piBytesRead);
+}
+
+traceResult xTraceStreamPortOnTraceBegin(void)
+{
+	uiDatagramSequence = 0u;
+	uiDatagramPayloadSize = 0u;
+	uiDatagramFirstTransfer = TRC_STREAM_PORT_UDP_NO_FIRST_TRANSFER;
+
+	return TRC_SUCCESS;
+}
+
+#else
+
 int32_t prvTraceUdpWrite(void* pvData, uint32_t uiSize, int32_t *piBytesWritten)
 {
 	prvSocketInitialize();
@@ -148,6 +273,8 @@ int32_t prvTraceUdpRead(void* pvData, uint32_t uiSize, int32_t *piBytesRead)
 	return prvSocketReceive(pvData, uiSize, piBytesRead);
 }
 
+#endif
+
 traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
 {
 	TRC_ASSERT_EQUAL_SIZE(TraceStreamPortBuffer_t, TraceStreamPortUDP_t);
@@ -168,6 +295,10 @@ traceResult xTraceStreamPortInitialize(TraceStreamPortBuffer_t* pxBuffer)
 
 traceResult xTraceStreamPortOnTraceEnd(void)
 {
+#if (TRC_CFG_STREAM_PORT_UDP_BATCHING == 1)
+	(void)prvDatagramSend();
+#endif
+
 	if (sock >= 0)
 	{
 		close(sock);
@@ -0,0 +1,179 @@
+#!/usr/bin/python3
+
+# Receives a trace from the UDP stream port with TRC_CFG_STREAM_PORT_UDP_BATCHING
+# enabled and writes it to a .psf file that can be opened in Tracealyzer.
+#
+# Each datagram starts with an 8 byte little endian header: sequence number (32 bits),
+# payload offset of the first transfer starting in the datagram (16 bits, 0xFFFF if none)
+# and payload length (16 bits). Transfers always start on event boundaries, so when
+# datagrams are lost the incomplete transfer is dropped and writing resumes at the
+# next transfer start.
+
+import argparse
+import socket
+import struct
+import sys
+import time
+
+HEADER_FORMAT = "<IHH"
+HEADER_SIZE = struct.calcsize(HEADER_FORMAT)
+NO_FIRST_TRANSFER = 0xFFFF
+
+CMD_SET_ACTIVE = 1
+
+
+def info_log(message):
+    sys.stderr.write("{}\n".format(message))
+
+
+def start_command():
+    """
+    Builds the TraceCommand_t that starts the recorder (CMD_SET_ACTIVE, param1 = 1)
+    """
+    params = [CMD_SET_ACTIVE, 1, 0, 0, 0, 0]
+    checksum = 0xFFFF - (sum(params) & 0xFF)
+    return bytes(params) + bytes([checksum & 0xFF, checksum >> 8])
+
+
+def count_events(data: bytes, param_size: int) -> int:
+    """
+    Counts the events in a sequence of complete events. Returns 0 if the data does not
+    parse as events, e.g. for the header and symbol table blocks sent when tracing starts.
+    """
+    count = 0
+    offset = 0
+    while offset + 8 <= len(data):
+        event_id = struct.unpack_from("<H", data, offset)[0]
+        offset += 8 + ((event_id >> 12) & 0xF) * param_size
+        count += 1
+    return count if offset == len(data) else 0
+
+
+class TraceReassembler:
+
+    def __init__(self, output, param_size: int):
+        self.output = output
+        self.param_size = param_size
+        self.expected_sequence = None
+        self.pending = bytearray()
+        self.in_sync = False
+        self.datagrams = 0
+        self.lost = 0
+        self.late = 0
+        self.bytes_written = 0
+        self.events = 0
+
+    def _write(self, data):
+        if len(data) == 0:
+            return
+        self.output.write(data)
+        self.bytes_written += len(data)
+        self.events += count_events(data, self.param_size)
+
+    def process(self, datagram: bytes):
+        if len(datagram) < HEADER_SIZE:
+            return
+
+        sequence, first_transfer, length = struct.unpack_from(HEADER_FORMAT, datagram, 0)
+        payload = datagram[HEADER_SIZE:HEADER_SIZE + length]
+        if len(payload) != length or (first_transfer != NO_FIRST_TRANSFER and first_transfer > length):
+            info_log("Malformed datagram {}, ignored".format(sequence))
+            return
+
+        if sequence == 0 and self.expected_sequence not in (None, 0):
+            info_log("Sequence restarted, the target began a new trace")
+            self._write(self.pending)
+            self.pending = bytearray()
+            self.in_sync = False
+        elif self.expected_sequence is not None and sequence < self.expected_sequence:
+            # Already given up on, the data around it has been dropped
+            self.late += 1
+            return
+        elif self.expected_sequence is not None and sequence > self.expected_sequence:
+            missing = sequence - self.expected_sequence
+            self.lost += missing
+            info_log("Lost {} datagram(s) before {}, resynchronizing".format(missing, sequence))
+            # The pending transfer continued in the lost datagrams
+            self.pending = bytearray()
+            self.in_sync = False
+
+        self.expected_sequence = (sequence + 1) & 0xFFFFFFFF
+        self.datagrams += 1
+
+        if first_transfer == NO_FIRST_TRANSFER:
+            if self.in_sync:
+                self.pending += payload
+            return
+
+        if self.in_sync:
+            # Everything up to the first transfer start completes the pending transfers
+            self._write(self.pending + payload[:first_transfer])
+        elif self.bytes_written == 0 and sequence != 0:
+            info_log("The start of the trace was lost, the file will lack the trace header")
+
+        self.pending = bytearray(payload[first_transfer:])
+        self.in_sync = True
+
+    def finish(self):
+        if self.in_sync:
+            self._write(self.pending)
+        self.pending = bytearray()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Receives a batched UDP trace and writes it to a .psf file")
+    parser.add_argument("--port", type=int, default=8888, help="Local UDP port (TRC_CFG_STREAM_PORT_UDP_PORT)")
+    parser.add_argument("--output", default="trace.psf", help="Output .psf file")
+    parser.add_argument("--target", default=None, help="Target address to send the start command to")
+    parser.add_argument("--target-port", type=int, default=8888, help="Target UDP port")
+    parser.add_argument("--duration", type=float, default=0, help="Seconds to receive, 0 to receive until Ctrl+C")
+    parser.add_argument("--param-size", type=int, default=4, help="sizeof(TraceUnsignedBaseType_t) on the target")
+    args = parser.parse_args()
+
+    sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+    sock.setsockopt(socket.SOL_SOCKET, socket.SO_RCVBUF, 4 * 1024 * 1024)
+    sock.bind(("", args.port))
+    sock.settimeout(0.5)
+
+    if args.target is not None:
+        sock.sendto(start_command(), (args.target, args.target_port))
+        info_log("Start command sent to {}:{}".format(args.target, args.target_port))
+
+    with open(args.output, "wb") as output:
+        reassembler = TraceReassembler(output, args.param_size)
+        start_time = None
+        last_report = time.monotonic()
+
+        try:
+            while args.duration == 0 or start_time is None or time.monotonic() - start_time < args.duration:
+                try:
+                    datagram = sock.recv(65536)
+                except socket.timeout:
+                    datagram = None
+
+                if datagram is not None:
+                    if start_time is None:
+                        start_time = time.monotonic()
+                    reassembler.process(datagram)
+
+                if time.monotonic() - last_report >= 1.0 and start_time is not None:
+                    last_report = time.monotonic()
+                    elapsed = last_report - start_time
+                    info_log("{:.0f} events/s, {:.0f} bytes/s, {} lost, {} late".format(
+                        reassembler.events / elapsed, reassembler.bytes_written / elapsed,
+                        reassembler.lost, reassembler.late))
+        except KeyboardInterrupt:
+            pass
+
+        reassembler.finish()
+
+    elapsed = (time.monotonic() - start_time) if start_time is not None else 0
+    info_log("Received {} datagrams ({} lost, {} late) in {:.1f} s".format(
+        reassembler.datagrams, reassembler.lost, reassembler.late, elapsed))
+    if elapsed > 0:
+        info_log("Wrote {} bytes, {} events, sustained {:.0f} events/s".format(
+            reassembler.bytes_written, reassembler.events, reassembler.events / elapsed))
+
+
+if __name__ == "__main__":
+    main()
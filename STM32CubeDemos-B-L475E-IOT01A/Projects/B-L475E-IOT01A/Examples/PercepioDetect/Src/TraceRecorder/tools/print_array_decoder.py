@@ -0,0 +1,151 @@
+#!/usr/bin/python3
+
+# Extracts the samples stored with xTracePrintArray() and xTracePrintArrayBufferAdd()
+# from a streamed .psf trace and writes them as CSV, one row per sample.
+#
+# The trace starts with the recorder header, the timestamp information and the entry
+# table, followed by events. Each event starts with an 8 byte header: event id (12 bits)
+# and parameter count (4 bits), event count (16 bits) and timestamp (32 bits), followed
+# by the parameters. An array event has the channel handle as first parameter, the
+# element type, sample count and sample age in OS ticks as second parameter, followed
+# by the packed samples.
+
+import argparse
+import csv
+import struct
+import sys
+
+PSF_IDENTIFIER = 0x50534600
+HEADER_SIZE = 32
+
+PSF_EVENT_OBJ_NAME = 0x03
+PSF_EVENT_USER_EVENT_ARRAY = 0xFD
+
+ELEMENT_TYPES = {
+    1: ("int16", "<h"),
+    2: ("int32", "<i"),
+    3: ("float", "<f"),
+}
+
+
+def info_log(message):
+    sys.stderr.write("{}\n".format(message))
+
+
+class TraceReader:
+
+    def __init__(self, data: bytes, param_size: int):
+        self.data = data
+        self.param_size = param_size
+        self.param_format = "<I" if param_size == 4 else "<Q"
+        self.offset = 0
+        self.channels = {}
+        self.frequency = 0
+        self.os_tick_hz = 0
+
+    def _param(self, offset):
+        return struct.unpack_from(self.param_format, self.data, offset)[0]
+
+    def read_start(self):
+        """
+        Reads the header, timestamp information and entry table written when tracing starts
+        """
+        if len(self.data) < HEADER_SIZE or struct.unpack_from("<I", self.data, 0)[0] != PSF_IDENTIFIER:
+            raise ValueError("Not a little endian streamed trace")
+        self.offset = HEADER_SIZE
+
+        # type, period, frequency, wraparounds, osTickHz, latestTimestamp, osTickCount
+        self.frequency = self._param(self.offset + 8)
+        self.os_tick_hz = struct.unpack_from("<I", self.data, self.offset + 12 + self.param_size)[0]
+        self.offset += 24 + self.param_size
+
+        entry_count = self._param(self.offset)
+        symbol_size = self._param(self.offset + self.param_size)
+        state_count = self._param(self.offset + 2 * self.param_size)
+        self.offset += 3 * self.param_size
+
+        for _ in range(entry_count):
+            address = self._param(self.offset)
+            symbol_offset = self.offset + (1 + state_count) * self.param_size + 4
+            self.channels[address] = self._string(symbol_offset, symbol_size)
+            self.offset = symbol_offset + symbol_size
+
+    def _string(self, offset, size):
+        return self.data[offset:offset + size].split(b"\0")[0].decode("ascii", errors="replace")
+
+    def events(self):
+        """
+        Yields (event id, timestamp, parameter offset, parameter count) for each event
+        """
+        while self.offset + 8 <= len(self.data):
+            event_id, _, timestamp = struct.unpack_from("<HHI", self.data, self.offset)
+            param_count = (event_id >> 12) & 0xF
+            params = self.offset + 8
+            self.offset = params + param_count * self.param_size
+            if self.offset > len(self.data):
+                break
+            yield event_id & 0xFFF, timestamp, params, param_count
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Extracts xTracePrintArray() samples from a .psf file as CSV")
+    parser.add_argument("input", help="Streamed trace (.psf)")
+    parser.add_argument("--output", default=None, help="Output .csv file, stdout if not given")
+    parser.add_argument("--channel", default=None, help="Only extract samples logged to this channel")
+    parser.add_argument("--param-size", type=int, default=4, help="sizeof(TraceUnsignedBaseType_t) on the target")
+    args = parser.parse_args()
+
+    with open(args.input, "rb") as trace_file:
+        reader = TraceReader(trace_file.read(), args.param_size)
+    reader.read_start()
+
+    output = open(args.output, "w", newline="") if args.output is not None else sys.stdout
+    writer = csv.writer(output)
+    writer.writerow(["timestamp", "time_s", "age_ticks", "channel", "type", "index", "value"])
+
+    # Timestamps are 32 bits, count wraparounds to keep the time increasing
+    wraparounds = 0
+    last_timestamp = 0
+    event_count = 0
+    sample_count = 0
+
+    for event_id, timestamp, params, param_count in reader.events():
+        if timestamp < last_timestamp:
+            wraparounds += 1
+        last_timestamp = timestamp
+
+        if event_id == PSF_EVENT_OBJ_NAME and param_count > 1:
+            reader.channels[reader._param(params)] = reader._string(params + reader.param_size, (param_count - 1) * reader.param_size)
+            continue
+
+        if event_id != PSF_EVENT_USER_EVENT_ARRAY or param_count < 2:
+            continue
+
+        channel = reader.channels.get(reader._param(params), "0x{:X}".format(reader._param(params)))
+        info = reader._param(params + reader.param_size)
+        element_type, count, age = info & 0xFF, (info >> 8) & 0xFF, (info >> 16) & 0xFFFF
+        if element_type not in ELEMENT_TYPES or (args.channel is not None and channel != args.channel):
+            continue
+
+        type_name, sample_format = ELEMENT_TYPES[element_type]
+        sample_size = struct.calcsize(sample_format)
+        samples = params + 2 * reader.param_size
+        count = min(count, ((param_count - 2) * reader.param_size) // sample_size)
+
+        full_timestamp = (wraparounds << 32) + timestamp
+        time_s = "{:.6f}".format(full_timestamp / reader.frequency) if reader.frequency != 0 else ""
+        for index in range(count):
+            value = struct.unpack_from(sample_format, reader.data, samples + index * sample_size)[0]
+            writer.writerow([full_timestamp, time_s, age, channel, type_name, index, value])
+
+        event_count += 1
+        sample_count += count
+
+    if output is not sys.stdout:
+        output.close()
+
+    info_log("Extracted {} samples from {} array events".format(sample_count, event_count))
+
+
+if __name__ == "__main__":
+    main()
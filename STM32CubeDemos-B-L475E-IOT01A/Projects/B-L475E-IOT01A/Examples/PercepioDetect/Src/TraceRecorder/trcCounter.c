@@ -14,6 +14,23 @@
 
 static TraceCounterData_t *pxCounterData TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
+#if (TRC_CFG_COUNTER_FILTER_SLOTS > 0)
+
+#if (TRC_CFG_COUNTER_FILTER_SLOTS > 255)
+#error "TRC_CFG_COUNTER_FILTER_SLOTS can't be larger than 255"
+#endif
+
+#define TRC_COUNTER_FILTER_STORE_VALUE 1u
+#define TRC_COUNTER_FILTER_STORE_SUMMARY 2u
+
+static TraceCounterFilter_t axCounterFilter[TRC_CFG_COUNTER_FILTER_SLOTS];
+static TraceUnsignedBaseType_t uxCounterFilterCount = 0u;
+
+static void prvTraceCounterFilter(TraceCounterFilter_t* pxFilter, TraceCounterHandle_t xCounterHandle, TraceBaseType_t xValue);
+static void prvTraceCounterFilterSummary(const TraceCounterFilter_t* pxSummary);
+
+#endif
+
 traceResult xTraceCounterInitialize(TraceCounterData_t *pxBuffer)
 {
 	TRC_ASSERT(pxBuffer != (void*)0);
@@ -68,8 +85,12 @@ traceResult xTraceCounterCreate(const char *szName, TraceBaseType_t xInitialValu
 
 traceResult xTraceCounterSet(TraceCounterHandle_t xCounterHandle, TraceBaseType_t xValue)
 {
-	TraceBaseType_t xLowerLimit = 0;
-	TraceBaseType_t xUpperLimit = 0;
+	TraceBaseType_t xLowerLimit;
+	TraceBaseType_t xUpperLimit;
+#if (TRC_CFG_COUNTER_FILTER_SLOTS > 0)
+	uint32_t uiOptions = 0u;
+	TraceCounterFilter_t* pxFilter;
+#endif
 
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_COUNTER));
 
@@ -78,11 +99,28 @@ traceResult xTraceCounterSet(TraceCounterHandle_t xCounterHandle, TraceBaseType_
 	/* This should never fail */
 	TRC_ASSERT_ALWAYS_EVALUATE(xTraceObjectSetSpecificState((TraceEntryHandle_t)xCounterHandle, TRC_COUNTER_VALUE_INDEX, (TraceUnsignedBaseType_t)xValue) == TRC_SUCCESS);
 
-	(void)xTraceEventCreate2(PSF_EVENT_COUNTER_CHANGE, (TraceUnsignedBaseType_t)xCounterHandle, (TraceUnsignedBaseType_t)xValue); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion from pointer to integer check*/
-	
-	/* These should never fail */
-	TRC_ASSERT_ALWAYS_EVALUATE(xTraceCounterGetLowerLimit(xCounterHandle, &xLowerLimit) == TRC_SUCCESS);
-	TRC_ASSERT_ALWAYS_EVALUATE(xTraceCounterGetUpperLimit(xCounterHandle, &xUpperLimit) == TRC_SUCCESS);
+#if (TRC_CFG_COUNTER_FILTER_SLOTS > 0)
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xTraceEntryGetOptions((TraceEntryHandle_t)xCounterHandle, &uiOptions) == TRC_SUCCESS);
+
+	if ((uiOptions & TRC_COUNTER_FILTER_OPTION_MASK) != 0u)
+	{
+		pxFilter = &axCounterFilter[((uiOptions & TRC_COUNTER_FILTER_OPTION_MASK) >> TRC_COUNTER_FILTER_OPTION_SHIFT) - 1u];
+
+		prvTraceCounterFilter(pxFilter, xCounterHandle, xValue);
+
+		/* Limits were cached when the filter was set */
+		xLowerLimit = pxFilter->xLowerLimit;
+		xUpperLimit = pxFilter->xUpperLimit;
+	}
+	else
+#endif
+	{
+		(void)xTraceEventCreate2(PSF_EVENT_COUNTER_CHANGE, (TraceUnsignedBaseType_t)xCounterHandle, (TraceUnsignedBaseType_t)xValue); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion from pointer to integer check*/
+
+		xLowerLimit = (TraceBaseType_t)xTraceEntryGetStateReturn((TraceEntryHandle_t)xCounterHandle, TRC_COUNTER_LOWER_LIMIT_INDEX);
+		xUpperLimit = (TraceBaseType_t)xTraceEntryGetStateReturn((TraceEntryHandle_t)xCounterHandle, TRC_COUNTER_UPPER_LIMIT_INDEX);
+	}
 
 	if ((xValue < xLowerLimit) || (xValue > xUpperLimit))
 	{
@@ -97,4 +135,219 @@ traceResult xTraceCounterSet(TraceCounterHandle_t xCounterHandle, TraceBaseType_
 	return TRC_SUCCESS;
 }
 
+#if (TRC_CFG_COUNTER_FILTER_SLOTS > 0)
+
+traceResult xTraceCounterSetFilter(TraceCounterHandle_t xCounterHandle, TraceUnsignedBaseType_t uxDeadband, TraceUnsignedBaseType_t uxMinInterval)
+{
+	uint32_t uiOptions = 0u;
+	uint32_t uiTimestamp = 0u;
+	TraceUnsignedBaseType_t uxSlot;
+	TraceCounterFilter_t* pxFilter;
+	traceResult xGetResult, xSetResult = TRC_SUCCESS;
+#if (TRC_CFG_INCLUDE_USER_EVENTS == 1)
+	TraceStringHandle_t xChannel = 0;
+	const char* szName;
+#endif
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_COUNTER));
+
+	TRC_ASSERT(xCounterHandle != 0);
+
+#if (TRC_CFG_INCLUDE_USER_EVENTS == 1)
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xTraceEntryGetOptions((TraceEntryHandle_t)xCounterHandle, &uiOptions) == TRC_SUCCESS);
+
+	/* The counter name is registered as User Event channel for the summaries, once per counter */
+	if ((uiOptions & TRC_COUNTER_FILTER_OPTION_MASK) == 0u)
+	{
+		/* We need to check this */
+		if ((xTraceEntryGetSymbol((TraceEntryHandle_t)xCounterHandle, &szName) == TRC_FAIL) ||
+			(xTraceStringRegister(szName, &xChannel) == TRC_FAIL))
+		{
+			return TRC_FAIL;
+		}
+	}
+#endif
+
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xTraceTimestampGet(&uiTimestamp) == TRC_SUCCESS);
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	xGetResult = xTraceEntryGetOptions((TraceEntryHandle_t)xCounterHandle, &uiOptions);
+
+	uxSlot = (TraceUnsignedBaseType_t)((uiOptions & TRC_COUNTER_FILTER_OPTION_MASK) >> TRC_COUNTER_FILTER_OPTION_SHIFT);
+
+	if (uxSlot == 0u)
+	{
+		/* We need to check this */
+		if (uxCounterFilterCount >= (TraceUnsignedBaseType_t)(TRC_CFG_COUNTER_FILTER_SLOTS))
+		{
+			TRACE_EXIT_CRITICAL_SECTION();
+
+			return TRC_FAIL;
+		}
+
+		uxCounterFilterCount++;
+
+		/* Stored as index + 1 since 0 means no slot */
+		uxSlot = uxCounterFilterCount;
+
+		xSetResult = xTraceEntrySetOptions((TraceEntryHandle_t)xCounterHandle, (uint32_t)uxSlot << TRC_COUNTER_FILTER_OPTION_SHIFT);
+	}
+
+	pxFilter = &axCounterFilter[uxSlot - 1u];
+
+#if (TRC_CFG_INCLUDE_USER_EVENTS == 1)
+	if (xChannel != 0)
+	{
+		pxFilter->xChannel = xChannel;
+	}
+#endif
+
+	pxFilter->xCounterHandle = xCounterHandle;
+	pxFilter->xLowerLimit = (TraceBaseType_t)xTraceEntryGetStateReturn((TraceEntryHandle_t)xCounterHandle, TRC_COUNTER_LOWER_LIMIT_INDEX);
+	pxFilter->xUpperLimit = (TraceBaseType_t)xTraceEntryGetStateReturn((TraceEntryHandle_t)xCounterHandle, TRC_COUNTER_UPPER_LIMIT_INDEX);
+	pxFilter->uxDeadband = uxDeadband;
+	pxFilter->uxMinInterval = uxMinInterval;
+	pxFilter->uxLastTimestamp = (TraceUnsignedBaseType_t)uiTimestamp;
+	pxFilter->xLastStored = (TraceBaseType_t)xTraceEntryGetStateReturn((TraceEntryHandle_t)xCounterHandle, TRC_COUNTER_VALUE_INDEX);
+	pxFilter->uxSamples = 0u;
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xGetResult == TRC_SUCCESS);
+
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xSetResult == TRC_SUCCESS);
+
+	return TRC_SUCCESS;
+}
+
+static void prvTraceCounterFilter(TraceCounterFilter_t* pxFilter, TraceCounterHandle_t xCounterHandle, TraceBaseType_t xValue)
+{
+	uint32_t uiTimestamp = 0u;
+	uint32_t uiStore = 0u;
+	uint32_t uiExpired;
+	TraceUnsignedBaseType_t uxDelta;
+	TraceCounterFilter_t xSummary;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	(void)xTraceTimestampGet(&uiTimestamp);
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	uiExpired = ((TraceUnsignedBaseType_t)(uiTimestamp - (uint32_t)pxFilter->uxLastTimestamp) >= pxFilter->uxMinInterval) ? 1u : 0u;
+
+	if (xValue > pxFilter->xLastStored)
+	{
+		uxDelta = (TraceUnsignedBaseType_t)xValue - (TraceUnsignedBaseType_t)pxFilter->xLastStored;
+	}
+	else
+	{
+		uxDelta = (TraceUnsignedBaseType_t)pxFilter->xLastStored - (TraceUnsignedBaseType_t)xValue;
+	}
+
+	if ((uiExpired != 0u) && (uxDelta > pxFilter->uxDeadband))
+	{
+		uiStore = TRC_COUNTER_FILTER_STORE_VALUE;
+		pxFilter->xLastStored = xValue;
+	}
+	else
+	{
+		/* Suppressed, only summarized */
+		if ((pxFilter->uxSamples == 0u) || (xValue < pxFilter->xMin))
+		{
+			pxFilter->xMin = xValue;
+		}
+
+		if ((pxFilter->uxSamples == 0u) || (xValue > pxFilter->xMax))
+		{
+			pxFilter->xMax = xValue;
+		}
+
+		pxFilter->xLast = xValue;
+		pxFilter->uxSamples++;
+	}
+
+	/* Without a minimum interval the summary is only stored together with a new value */
+	if ((uiExpired != 0u) && (pxFilter->uxSamples != 0u) && ((uiStore != 0u) || (pxFilter->uxMinInterval != 0u)))
+	{
+		xSummary = *pxFilter;
+		pxFilter->uxSamples = 0u;
+		uiStore |= TRC_COUNTER_FILTER_STORE_SUMMARY;
+	}
+
+	if (uiStore != 0u)
+	{
+		pxFilter->uxLastTimestamp = (TraceUnsignedBaseType_t)uiTimestamp;
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	if ((uiStore & TRC_COUNTER_FILTER_STORE_SUMMARY) != 0u)
+	{
+		prvTraceCounterFilterSummary(&xSummary);
+	}
+
+	if ((uiStore & TRC_COUNTER_FILTER_STORE_VALUE) != 0u)
+	{
+		(void)xTraceEventCreate2(PSF_EVENT_COUNTER_CHANGE, (TraceUnsignedBaseType_t)xCounterHandle, (TraceUnsignedBaseType_t)xValue); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion from pointer to integer check*/
+	}
+}
+
+traceResult xTraceCounterFlush(void)
+{
+	uint32_t uiTimestamp = 0u;
+	uint32_t uiStore;
+	TraceUnsignedBaseType_t i;
+	TraceCounterFilter_t xSummary;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	(void)xTraceTimestampGet(&uiTimestamp);
+
+	for (i = 0u; i < uxCounterFilterCount; i++)
+	{
+		uiStore = 0u;
+
+		TRACE_ENTER_CRITICAL_SECTION();
+
+		/* Counters that are still being set store their summary themselves, this catches the ones that went quiet */
+		if ((axCounterFilter[i].uxSamples != 0u) && ((TraceUnsignedBaseType_t)(uiTimestamp - (uint32_t)axCounterFilter[i].uxLastTimestamp) >= axCounterFilter[i].uxMinInterval))
+		{
+			xSummary = axCounterFilter[i];
+			axCounterFilter[i].uxSamples = 0u;
+			axCounterFilter[i].uxLastTimestamp = (TraceUnsignedBaseType_t)uiTimestamp;
+			uiStore = 1u;
+		}
+
+		TRACE_EXIT_CRITICAL_SECTION();
+
+		if (uiStore != 0u)
+		{
+			prvTraceCounterFilterSummary(&xSummary);
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+static void prvTraceCounterFilterSummary(const TraceCounterFilter_t* pxSummary)
+{
+#if (TRC_CFG_INCLUDE_USER_EVENTS == 1)
+	static TraceStringHandle_t xFormat = 0;
+
+	if ((xFormat != 0) || (xTraceStringRegister("Samples: %u Min: %d Max: %d Last: %d", &xFormat) == TRC_SUCCESS))
+	{
+		(void)xTracePrintF4(pxSummary->xChannel, xFormat, pxSummary->uxSamples, (TraceUnsignedBaseType_t)pxSummary->xMin, (TraceUnsignedBaseType_t)pxSummary->xMax, (TraceUnsignedBaseType_t)pxSummary->xLast);
+	}
+#else
+	(void)pxSummary;
+#endif
+}
+
+#endif
+
 #endif
@@ -14,6 +14,10 @@
 
 static TraceDiagnosticsData_t *pxDiagnostics TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+TraceHealthMetrics_t *pxTraceHealthMetrics TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+#endif
+
 traceResult xTraceDiagnosticsInitialize(TraceDiagnosticsData_t *pxBuffer)
 {
 	uint32_t i;
@@ -28,6 +32,12 @@ traceResult xTraceDiagnosticsInitialize(TraceDiagnosticsData_t *pxBuffer)
 		pxDiagnostics->metrics[i] = 0;
 	}
 
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+	pxTraceHealthMetrics = pxDiagnostics->xHealthMetrics;
+
+	(void)xTraceDiagnosticsClearHealthMetrics();
+#endif
+
 	(void)xTraceSetComponentInitialized(TRC_RECORDER_COMPONENT_DIAGNOSTICS);
 
 	return TRC_SUCCESS;
@@ -152,4 +162,73 @@ traceResult xTraceDiagnosticsCheckStatus(void)
 	return TRC_SUCCESS;
 }
 
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+
+traceResult xTraceDiagnosticsGetHealthMetrics(uint32_t uiCoreId, TraceHealthMetrics_t* pxMetrics)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_DIAGNOSTICS));
+
+	/* This should never fail */
+	TRC_ASSERT(pxMetrics != (void*)0);
+
+	/* We need to check this */
+	if (uiCoreId >= (uint32_t)(TRC_CFG_CORE_COUNT))
+	{
+		return TRC_FAIL;
+	}
+
+	*pxMetrics = pxTraceHealthMetrics[uiCoreId];
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceDiagnosticsGetHealthMetricsData(void** ppvData, TraceUnsignedBaseType_t* puxSize)
+{
+	/* We need to check this */
+	if (xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_DIAGNOSTICS) == 0U)
+	{
+		return TRC_FAIL;
+	}
+
+	/* This should never fail */
+	TRC_ASSERT(ppvData != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puxSize != (void*)0);
+
+	*ppvData = (void*)pxTraceHealthMetrics;
+	*puxSize = (TraceUnsignedBaseType_t)sizeof(pxDiagnostics->xHealthMetrics);
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceDiagnosticsClearHealthMetrics(void)
+{
+	uint32_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT(pxTraceHealthMetrics != (void*)0);
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_CORE_COUNT); i++)
+	{
+		pxTraceHealthMetrics[i].uxEventsWritten = 0u;
+		pxTraceHealthMetrics[i].uxBytesWritten = 0u;
+		pxTraceHealthMetrics[i].uxEventsDropped = 0u;
+		pxTraceHealthMetrics[i].uxEventsOverwritten = 0u;
+		pxTraceHealthMetrics[i].uxMaxFill = 0u;
+		pxTraceHealthMetrics[i].uxMaxCriticalSection = 0u;
+		pxTraceHealthMetrics[i].uxStringMisses = 0u;
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return TRC_SUCCESS;
+}
+
+#endif
+
 #endif
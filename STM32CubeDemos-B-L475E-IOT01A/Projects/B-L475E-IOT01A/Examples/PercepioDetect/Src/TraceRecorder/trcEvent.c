@@ -14,6 +14,10 @@
 
 #include <string.h>
 
+#if (TRC_CFG_EVENT_DECIMATION_SLOTS > 0) && (INCLUDE_EVENT_DECIMATION_TESTS == 1)
+#include <stdio.h>
+#endif
+
 /**
  * @internal Macro helper for setting trace event parameter count.
  */
@@ -45,11 +49,81 @@
 		(void)xTraceTimestampGet(&(pxEvent)->TS) \
 	)
 
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+
+/* When the current critical section started, per core */
+static uint32_t uiHealthMetricsTimestamp[TRC_CFG_CORE_COUNT] TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+static void prvTraceEventHealthMetricsEnd(uint32_t uiSize);
+
+/**
+ * @internal Macro helper for timing the critical section.
+ */
+#define TRACE_EVENT_HEALTH_METRICS_BEGIN() (void)xTraceTimestampGet(&uiHealthMetricsTimestamp[TRC_CFG_GET_CURRENT_CORE()]);
+
+/**
+ * @internal Macro helper for updating the health metrics once the event is committed.
+ */
+#define TRACE_EVENT_HEALTH_METRICS_END(size) prvTraceEventHealthMetricsEnd((uint32_t)(size));
+
+#else
+
+#define TRACE_EVENT_HEALTH_METRICS_BEGIN()
+#define TRACE_EVENT_HEALTH_METRICS_END(size)
+
+#endif
+
+#if (TRC_CFG_EVENT_DECIMATION_SLOTS > 0)
+
+typedef struct TraceEventDecimation	/* Aligned */
+{
+	uint32_t uiOneOfN;
+	uint32_t uiMaxPerMs;
+} TraceEventDecimation_t;
+
+typedef struct TraceEventDecimationSlot	/* Aligned */
+{
+	TraceUnsignedBaseType_t uxObject;
+	uint32_t uiEvent;				/* Index in auiDecimationEvents + 1, 0 means unused */
+	uint32_t uiCount;				/* Events since the last stored one, for 1 of N */
+	uint32_t uiWindowStart;			/* Timestamp when the current millisecond started */
+	uint32_t uiWindowCount;			/* Events stored in the current millisecond */
+	uint32_t uiSkipped;				/* Events skipped since the last summary */
+	uint32_t uiActive;				/* Set by each event, cleared by xTraceEventDecimationFlush() */
+} TraceEventDecimationSlot_t;
+
+static const uint32_t auiDecimationEvents[] = TRC_KERNEL_PORT_DECIMATION_EVENTS;
+
+#define TRC_EVENT_DECIMATION_EVENT_COUNT (sizeof(auiDecimationEvents) / sizeof(auiDecimationEvents[0]))
+
+static TraceEventDecimation_t axDecimation[TRC_EVENT_DECIMATION_EVENT_COUNT];
+static TraceEventDecimationSlot_t axDecimationSlots[TRC_CFG_EVENT_DECIMATION_SLOTS];
+static uint32_t uiDecimationEnabled = 0u;	/* Number of events with decimation set, skips the lookup when 0 */
+static uint32_t uiDecimationTicksPerMs = 1u;
+static TraceStringHandle_t xDecimationChannel = 0;
+static TraceStringHandle_t xDecimationFormat = 0;
+
+static uint32_t prvTraceEventDecimationLookup(uint32_t uiEventCode);
+static traceResult prvTraceEventDecimate(uint32_t uiEventCode, TraceUnsignedBaseType_t uxObject);
+static traceResult prvTraceEventDecimationSummary(TraceEventDecimationSlot_t* pxSlot);
+
+#if (INCLUDE_EVENT_DECIMATION_TESTS == 1)
+static uint32_t uiDecimationTestReported = 0u;		/* Skipped events reported in summaries */
+static uint32_t uiDecimationTestFailSummary = 0u;	/* Simulates a full buffer for the summaries */
+#endif
+
+#endif
+
 #define TRACE_EVENT_BEGIN_OFFLINE(size) 														\
 	TRACE_ENTER_CRITICAL_SECTION();              										\
+	TRACE_EVENT_ALLOCATE(size)
+
+#define TRACE_EVENT_ALLOCATE(size) 															\
+	TRACE_EVENT_HEALTH_METRICS_BEGIN()													\
 	pxTraceEventDataTable->coreEventData[TRC_CFG_GET_CURRENT_CORE()].eventCounter++; 	\
 	if (xTraceStreamPortAllocate((uint32_t)(size), (void**)&pxEventData) == TRC_FAIL) /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress pointer checks*/ \
 	{                                            										\
+		TRC_HEALTH_METRICS_ADD(uxEventsDropped, 1u);									\
 		TRACE_EXIT_CRITICAL_SECTION();              									\
 		return TRC_FAIL; 																\
 	} 																					\
@@ -63,9 +137,35 @@
 	} 																					\
 	TRACE_EVENT_BEGIN_OFFLINE(size)
 
+#if (TRC_CFG_EVENT_DECIMATION_SLOTS > 0)
+
+/**
+ * @internal Same as TRACE_EVENT_BEGIN but returns without storing the event
+ * if it is decimated. The first parameter is the object.
+ */
+#define TRACE_EVENT_BEGIN_DECIMATED(size, uxObject) 										\
+	/* We need to check this */                  										\
+	if (!xTraceIsRecorderEnabled())              										\
+	{ 																					\
+		return TRC_FAIL;                            									\
+	} 																					\
+	TRACE_ENTER_CRITICAL_SECTION();              										\
+	if (prvTraceEventDecimate(uiEventCode, uxObject) == TRC_FAIL)						\
+	{                                            										\
+		TRACE_EXIT_CRITICAL_SECTION();              									\
+		return TRC_SUCCESS; 															\
+	} 																					\
+	TRACE_EVENT_ALLOCATE(size)
+
+#else
+
+#define TRACE_EVENT_BEGIN_DECIMATED(size, uxObject) TRACE_EVENT_BEGIN(size)
+
+#endif
 
 #define TRACE_EVENT_END(size) 															\
 	(void)xTraceStreamPortCommit(pxEventData, (uint32_t)(size), &iBytesCommitted); 		\
+	TRACE_EVENT_HEALTH_METRICS_END(size)												\
 	TRACE_EXIT_CRITICAL_SECTION(); 														\
 	/* We need to use iBytesCommitted for the above call but do not use the value */	\
 	/* Remove potential warnings */ 													\
@@ -162,7 +262,7 @@ traceResult xTraceEventCreate1(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 
 	TRACE_ALLOC_CRITICAL_SECTION();
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent1_t));
+	TRACE_EVENT_BEGIN_DECIMATED(sizeof(TraceEvent1_t), uxParam1);
 
 	TRACE_EVENT_ADD_1(uxParam1);
 
@@ -178,7 +278,7 @@ traceResult xTraceEventCreate2(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 
 	TRACE_ALLOC_CRITICAL_SECTION();
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent2_t));
+	TRACE_EVENT_BEGIN_DECIMATED(sizeof(TraceEvent2_t), uxParam1);
 
 	TRACE_EVENT_ADD_2(uxParam1, uxParam2);
 
@@ -187,6 +287,44 @@ traceResult xTraceEventCreate2(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 	return TRC_SUCCESS;
 }
 
+traceResult xTraceEventCreate2InCriticalSection(uint32_t uiEventCode, TraceUnsignedBaseType_t uxParam1, TraceUnsignedBaseType_t uxParam2)
+{
+	TraceEvent2_t* pxEventData = (void*)0;
+	int32_t iBytesCommitted = 0;
+	TraceCoreEventData_t* pxCoreEventData;
+
+	/* We need to check this */
+	if (!xTraceIsRecorderEnabled())
+	{
+		return TRC_FAIL;
+	}
+
+	TRACE_EVENT_HEALTH_METRICS_BEGIN()
+
+	pxCoreEventData = &pxTraceEventDataTable->coreEventData[TRC_CFG_GET_CURRENT_CORE()];
+	pxCoreEventData->eventCounter++;
+
+	if (xTraceStreamPortAllocate((uint32_t)sizeof(TraceEvent2_t), (void**)&pxEventData) == TRC_FAIL) /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress pointer checks*/
+	{
+		TRC_HEALTH_METRICS_ADD(uxEventsDropped, 1u);
+
+		return TRC_FAIL;
+	}
+
+	SET_BASE_EVENT_DATA(pxEventData, uiEventCode, 2u, pxCoreEventData->eventCounter); /*cstat !MISRAC2012-Rule-11.5 Suppress pointer checks*/
+
+	TRACE_EVENT_ADD_2(uxParam1, uxParam2);
+
+	(void)xTraceStreamPortCommit(pxEventData, (uint32_t)sizeof(TraceEvent2_t), &iBytesCommitted);
+
+	TRACE_EVENT_HEALTH_METRICS_END(sizeof(TraceEvent2_t))
+
+	/* We need to use iBytesCommitted for the above call but do not use the value */
+	(void)iBytesCommitted;
+
+	return TRC_SUCCESS;
+}
+
 traceResult xTraceEventCreate3(uint32_t uiEventCode, TraceUnsignedBaseType_t uxParam1, TraceUnsignedBaseType_t uxParam2, TraceUnsignedBaseType_t uxParam3)
 {
 	TraceEvent3_t* pxEventData = (void*)0;
@@ -194,7 +332,7 @@ traceResult xTraceEventCreate3(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 
 	TRACE_ALLOC_CRITICAL_SECTION();
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent3_t));
+	TRACE_EVENT_BEGIN_DECIMATED(sizeof(TraceEvent3_t), uxParam1);
 
 	TRACE_EVENT_ADD_3(uxParam1, uxParam2, uxParam3);
 
@@ -210,7 +348,7 @@ traceResult xTraceEventCreate4(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 
 	TRACE_ALLOC_CRITICAL_SECTION();
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent4_t));
+	TRACE_EVENT_BEGIN_DECIMATED(sizeof(TraceEvent4_t), uxParam1);
 
 	TRACE_EVENT_ADD_4(uxParam1, uxParam2, uxParam3, uxParam4);
 
@@ -226,7 +364,7 @@ traceResult xTraceEventCreate5(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 
 	TRACE_ALLOC_CRITICAL_SECTION();
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent5_t));
+	TRACE_EVENT_BEGIN_DECIMATED(sizeof(TraceEvent5_t), uxParam1);
 
 	TRACE_EVENT_ADD_5(uxParam1, uxParam2, uxParam3, uxParam4, uxParam5);
 
@@ -242,7 +380,7 @@ traceResult xTraceEventCreate6(uint32_t uiEventCode, TraceUnsignedBaseType_t uxP
 
 	TRACE_ALLOC_CRITICAL_SECTION();
 
-	TRACE_EVENT_BEGIN(sizeof(TraceEvent6_t));
+	TRACE_EVENT_BEGIN_DECIMATED(sizeof(TraceEvent6_t), uxParam1);
 
 	TRACE_EVENT_ADD_6(uxParam1, uxParam2, uxParam3, uxParam4, uxParam5, uxParam6);
 
@@ -503,6 +641,381 @@ traceResult xTraceEventCreateData6(
 	return TRC_SUCCESS;
 }
 
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+static void prvTraceEventHealthMetricsEnd(uint32_t uiSize)
+{
+	uint32_t uiTimestamp = 0u;
+
+	(void)xTraceTimestampGet(&uiTimestamp);
+
+	TRC_HEALTH_METRICS_ADD(uxEventsWritten, 1u);
+	TRC_HEALTH_METRICS_ADD(uxBytesWritten, uiSize);
+	TRC_HEALTH_METRICS_SET_IF_HIGHER(uxMaxCriticalSection, uiTimestamp - uiHealthMetricsTimestamp[TRC_CFG_GET_CURRENT_CORE()]);
+}
+#endif
+
+#if (TRC_CFG_EVENT_DECIMATION_SLOTS > 0)
+
+traceResult xTraceEventSetDecimation(uint32_t uiEventCode, uint32_t uiOneOfN, uint32_t uiMaxPerMs)
+{
+	uint32_t uiEvent;
+	uint32_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	uiEvent = prvTraceEventDecimationLookup(uiEventCode);
+
+	/* We need to check this */
+	if (uiEvent == 0u)
+	{
+		/* Not in TRC_KERNEL_PORT_DECIMATION_EVENTS */
+		return TRC_FAIL;
+	}
+
+	/* The summary strings are registered here, since registering creates events */
+	if (xDecimationChannel == 0)
+	{
+		if (xTraceStringRegister("Decimation", &xDecimationChannel) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+	}
+
+	if (xDecimationFormat == 0)
+	{
+		if (xTraceStringRegister("Object 0x%X event 0x%X: %u events skipped", &xDecimationFormat) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	uiDecimationTicksPerMs = (uint32_t)((TRC_HWTC_FREQ_HZ) / 1000u);
+	if (uiDecimationTicksPerMs == 0u)
+	{
+		uiDecimationTicksPerMs = 1u;
+	}
+
+	axDecimation[uiEvent - 1u].uiOneOfN = uiOneOfN;
+	axDecimation[uiEvent - 1u].uiMaxPerMs = uiMaxPerMs;
+
+	uiDecimationEnabled = 0u;
+	for (i = 0u; i < (uint32_t)TRC_EVENT_DECIMATION_EVENT_COUNT; i++)
+	{
+		if ((axDecimation[i].uiOneOfN > 1u) || (axDecimation[i].uiMaxPerMs != 0u))
+		{
+			uiDecimationEnabled++;
+		}
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return TRC_SUCCESS;
+}
+
+/* Returns the index of the event code in auiDecimationEvents + 1, or 0 if it can't be decimated */
+static uint32_t prvTraceEventDecimationLookup(uint32_t uiEventCode)
+{
+	uint32_t i;
+
+	for (i = 0u; i < (uint32_t)TRC_EVENT_DECIMATION_EVENT_COUNT; i++)
+	{
+		if (auiDecimationEvents[i] == uiEventCode)
+		{
+			return i + 1u;
+		}
+	}
+
+	return 0u;
+}
+
+/* Called within the event critical section. Returns TRC_FAIL if the event should be skipped. */
+static traceResult prvTraceEventDecimate(uint32_t uiEventCode, TraceUnsignedBaseType_t uxObject)
+{
+	uint32_t uiEvent;
+	uint32_t uiTimestamp = 0u;
+	uint32_t uiStore = 1u;
+	const TraceEventDecimation_t* pxDecimation;
+	TraceEventDecimationSlot_t* pxSlot;
+
+	if (uiDecimationEnabled == 0u)
+	{
+		return TRC_SUCCESS;
+	}
+
+	uiEvent = prvTraceEventDecimationLookup(uiEventCode);
+
+	if (uiEvent == 0u)
+	{
+		return TRC_SUCCESS;
+	}
+
+	pxDecimation = &axDecimation[uiEvent - 1u];
+
+	if ((pxDecimation->uiOneOfN <= 1u) && (pxDecimation->uiMaxPerMs == 0u))
+	{
+		return TRC_SUCCESS;
+	}
+
+	(void)xTraceTimestampGet(&uiTimestamp);
+
+	pxSlot = &axDecimationSlots[(((uint32_t)uxObject >> 2) + uiEvent) % (uint32_t)(TRC_CFG_EVENT_DECIMATION_SLOTS)];
+
+	if ((pxSlot->uxObject != uxObject) || (pxSlot->uiEvent != uiEvent))
+	{
+		/* The slot is taken over, so the previous object's skipped events are reported first */
+		if (prvTraceEventDecimationSummary(pxSlot) == TRC_FAIL)
+		{
+			/* The previous object keeps the slot and its count, this event is stored as is */
+			return TRC_SUCCESS;
+		}
+
+		pxSlot->uxObject = uxObject;
+		pxSlot->uiEvent = uiEvent;
+		pxSlot->uiCount = 0u;
+		pxSlot->uiWindowStart = uiTimestamp;
+		pxSlot->uiWindowCount = 0u;
+		pxSlot->uiSkipped = 0u;
+	}
+
+	pxSlot->uiActive = 1u;
+
+	if (pxDecimation->uiOneOfN > 1u)
+	{
+		/* The first of every N events is stored */
+		if (pxSlot->uiCount != 0u)
+		{
+			uiStore = 0u;
+		}
+
+		pxSlot->uiCount++;
+		if (pxSlot->uiCount >= pxDecimation->uiOneOfN)
+		{
+			pxSlot->uiCount = 0u;
+		}
+	}
+
+	if ((uiStore != 0u) && (pxDecimation->uiMaxPerMs != 0u))
+	{
+		if ((uiTimestamp - pxSlot->uiWindowStart) >= uiDecimationTicksPerMs)
+		{
+			pxSlot->uiWindowStart = uiTimestamp;
+			pxSlot->uiWindowCount = 0u;
+		}
+
+		if (pxSlot->uiWindowCount >= pxDecimation->uiMaxPerMs)
+		{
+			uiStore = 0u;
+		}
+		else
+		{
+			pxSlot->uiWindowCount++;
+		}
+	}
+
+	if (uiStore == 0u)
+	{
+		pxSlot->uiSkipped++;
+
+		return TRC_FAIL;
+	}
+
+	(void)prvTraceEventDecimationSummary(pxSlot);
+
+	return TRC_SUCCESS;
+}
+
+/* Called within the event critical section. Stores the number of skipped events as a User Event. Returns TRC_FAIL if they are still pending. */
+static traceResult prvTraceEventDecimationSummary(TraceEventDecimationSlot_t* pxSlot)
+{
+	TraceEvent5_t* pxEventData = (void*)0;
+	int32_t iBytesCommitted = 0;
+
+	if (pxSlot->uiSkipped == 0u)
+	{
+		return TRC_SUCCESS;
+	}
+
+#if (INCLUDE_EVENT_DECIMATION_TESTS == 1)
+	if (uiDecimationTestFailSummary != 0u)
+	{
+		return TRC_FAIL;
+	}
+#endif
+
+	pxTraceEventDataTable->coreEventData[TRC_CFG_GET_CURRENT_CORE()].eventCounter++;
+
+	if (xTraceStreamPortAllocate((uint32_t)sizeof(TraceEvent5_t), (void**)&pxEventData) == TRC_FAIL) /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress pointer checks*/
+	{
+		/* The skipped events are kept and reported with the next summary */
+		TRC_HEALTH_METRICS_ADD(uxEventsDropped, 1u);
+
+		return TRC_FAIL;
+	}
+
+	SET_BASE_EVENT_DATA(pxEventData, PSF_EVENT_USER_EVENT_FIXED + 3u, 5u, pxTraceEventDataTable->coreEventData[TRC_CFG_GET_CURRENT_CORE()].eventCounter); /*cstat !MISRAC2012-Rule-11.5 Suppress pointer checks*/
+
+	TRACE_EVENT_ADD_5((TraceUnsignedBaseType_t)xDecimationChannel, (TraceUnsignedBaseType_t)xDecimationFormat, pxSlot->uxObject, (TraceUnsignedBaseType_t)auiDecimationEvents[pxSlot->uiEvent - 1u], (TraceUnsignedBaseType_t)pxSlot->uiSkipped);
+
+	(void)xTraceStreamPortCommit(pxEventData, (uint32_t)sizeof(TraceEvent5_t), &iBytesCommitted);
+
+	/* We need to use iBytesCommitted for the above call but do not use the value */
+	(void)iBytesCommitted;
+
+#if (INCLUDE_EVENT_DECIMATION_TESTS == 1)
+	uiDecimationTestReported += pxSlot->uiSkipped;
+#endif
+
+	pxSlot->uiSkipped = 0u;
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceEventDecimationFlush(void)
+{
+	uint32_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* We need to check this */
+	if (!xTraceIsRecorderEnabled())
+	{
+		return TRC_FAIL;
+	}
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_EVENT_DECIMATION_SLOTS); i++)
+	{
+		TRACE_ENTER_CRITICAL_SECTION();
+
+		/* Active objects report with their next stored event, this catches the ones that went quiet */
+		if (axDecimationSlots[i].uiActive == 0u)
+		{
+			(void)prvTraceEventDecimationSummary(&axDecimationSlots[i]);
+		}
+
+		axDecimationSlots[i].uiActive = 0u;
+
+		TRACE_EXIT_CRITICAL_SECTION();
+	}
+
+	return TRC_SUCCESS;
+}
+
+#if (INCLUDE_EVENT_DECIMATION_TESTS == 1)
+
+static uint32_t uiDecimationTestErrors = 0u;
+
+/* Runs uiEvents events for the object through the decimation, returns how many would be stored */
+static uint32_t prvTraceEventDecimationTestRun(uint32_t uiEventCode, TraceUnsignedBaseType_t uxObject, uint32_t uiEvents)
+{
+	uint32_t uiStored = 0u;
+	uint32_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	for (i = 0u; i < uiEvents; i++)
+	{
+		TRACE_ENTER_CRITICAL_SECTION();
+
+		if (prvTraceEventDecimate(uiEventCode, uxObject) == TRC_SUCCESS)
+		{
+			uiStored++;
+		}
+
+		TRACE_EXIT_CRITICAL_SECTION();
+	}
+
+	return uiStored;
+}
+
+/* Returns the skipped events not yet reported for the object */
+static uint32_t prvTraceEventDecimationTestPending(uint32_t uiEventCode, TraceUnsignedBaseType_t uxObject)
+{
+	uint32_t i;
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_EVENT_DECIMATION_SLOTS); i++)
+	{
+		if ((axDecimationSlots[i].uxObject == uxObject) && (axDecimationSlots[i].uiEvent == prvTraceEventDecimationLookup(uiEventCode)))
+		{
+			return axDecimationSlots[i].uiSkipped;
+		}
+	}
+
+	return 0u;
+}
+
+/*cstat !MISRAC2004-6.3 !MISRAC2012-Dir-4.6_a Suppress basic char type usage*/
+static void prvTraceEventDecimationTestCheck(const char* szWhat, uint32_t uiValue, uint32_t uiExpected)
+{
+	printf("%-9s %-4u %s\n", szWhat, (unsigned int)uiValue, (uiValue == uiExpected) ? "(OK)" : "(ERROR)");
+
+	if (uiValue != uiExpected)
+	{
+		uiDecimationTestErrors++;
+	}
+}
+
+/* Runs the decimation on simulated queue send events and prints the results. Erases the decimation state. */
+traceResult xTraceEventDecimationRunTests(void)
+{
+	const uint32_t uiEventCode = PSF_EVENT_QUEUE_SEND;
+	const TraceUnsignedBaseType_t uxObjectA = 0x1000u;
+	const TraceUnsignedBaseType_t uxObjectB = 0x1000u + ((TraceUnsignedBaseType_t)(TRC_CFG_EVENT_DECIMATION_SLOTS) << 2); /* Same slot as A */
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* The summaries are stored as events */
+	if (!xTraceIsRecorderEnabled())
+	{
+		return TRC_FAIL;
+	}
+
+	if (xTraceEventSetDecimation(uiEventCode, 4u, 0u) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+	(void)memset(axDecimationSlots, 0, sizeof(axDecimationSlots));
+	uiDecimationTestReported = 0u;
+	uiDecimationTestFailSummary = 0u;
+	uiDecimationTestErrors = 0u;
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	printf("\nTest 1: 1 of 4 events is stored, the skipped ones are reported with the next stored event.\n");
+	prvTraceEventDecimationTestCheck("stored", prvTraceEventDecimationTestRun(uiEventCode, uxObjectA, 12u), 3u);
+	prvTraceEventDecimationTestCheck("reported", uiDecimationTestReported, 6u);
+	prvTraceEventDecimationTestCheck("pending", prvTraceEventDecimationTestPending(uiEventCode, uxObjectA), 3u);
+
+	printf("\nTest 2: The skipped events of a quiet object are reported by the second flush.\n");
+	(void)xTraceEventDecimationFlush();
+	prvTraceEventDecimationTestCheck("reported", uiDecimationTestReported, 6u);
+	(void)xTraceEventDecimationFlush();
+	prvTraceEventDecimationTestCheck("reported", uiDecimationTestReported, 9u);
+	prvTraceEventDecimationTestCheck("pending", prvTraceEventDecimationTestPending(uiEventCode, uxObjectA), 0u);
+
+	printf("\nTest 3: A slot is not taken over while the summary can't be stored.\n");
+	prvTraceEventDecimationTestCheck("stored", prvTraceEventDecimationTestRun(uiEventCode, uxObjectA, 2u), 1u);
+	uiDecimationTestFailSummary = 1u;
+	prvTraceEventDecimationTestCheck("stored", prvTraceEventDecimationTestRun(uiEventCode, uxObjectB, 1u), 1u);
+	prvTraceEventDecimationTestCheck("pending", prvTraceEventDecimationTestPending(uiEventCode, uxObjectA), 1u);
+	uiDecimationTestFailSummary = 0u;
+	prvTraceEventDecimationTestCheck("stored", prvTraceEventDecimationTestRun(uiEventCode, uxObjectB, 1u), 1u);
+	prvTraceEventDecimationTestCheck("reported", uiDecimationTestReported, 10u);
+	prvTraceEventDecimationTestCheck("pending", prvTraceEventDecimationTestPending(uiEventCode, uxObjectA), 0u);
+
+	printf("\nDecimation tests %s\n", (uiDecimationTestErrors == 0u) ? "passed" : "FAILED");
+
+	(void)xTraceEventSetDecimation(uiEventCode, 0u, 0u);
+
+	TRACE_ENTER_CRITICAL_SECTION();
+	(void)memset(axDecimationSlots, 0, sizeof(axDecimationSlots));
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return (uiDecimationTestErrors == 0u) ? TRC_SUCCESS : TRC_FAIL;
+}
+
+#endif /* (INCLUDE_EVENT_DECIMATION_TESTS == 1) */
+
+#endif
+
 traceResult xTraceEventGetSize(const void* const pvAddress, uint32_t* puiSize)
 {
 	/* This should never fail */
@@ -60,6 +60,8 @@ static traceResult prvTraceEventBufferPop(TraceEventBuffer_t *pxTraceEventBuffer
 	/* Update tail to point to the new last event */
 	pxTraceEventBuffer->uiTail = (pxTraceEventBuffer->uiTail + uiFreeSize) % pxTraceEventBuffer->uiSize;
 
+	TRC_HEALTH_METRICS_ADD(uxEventsOverwritten, 1u);
+
 	return TRC_SUCCESS;
 }
 
@@ -83,6 +85,8 @@ static traceResult prvTraceEventBufferAllocPop(TraceEventBuffer_t *pxTraceEventB
 
 		/* Update tail to point to the new last event */
 		pxTraceEventBuffer->uiTail = (pxTraceEventBuffer->uiTail + uiFreeSize) % pxTraceEventBuffer->uiSize;
+
+		TRC_HEALTH_METRICS_ADD(uxEventsOverwritten, 1u);
 	}
 
 	return TRC_SUCCESS;
@@ -255,6 +259,10 @@ traceResult xTraceEventBufferAlloc(TraceEventBuffer_t *pxTraceEventBuffer, uint3
 
 traceResult xTraceEventBufferAllocCommit(TraceEventBuffer_t *pxTraceEventBuffer, const void *pvData, uint32_t uiSize, int32_t *piBytesWritten)
 {
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+	uint32_t uiUsed = 0u;
+#endif
+
 	(void)pvData;
 
 	/* This should never fail */
@@ -266,6 +274,11 @@ traceResult xTraceEventBufferAllocCommit(TraceEventBuffer_t *pxTraceEventBuffer,
 	/* Update bytes written */
 	*piBytesWritten = (int32_t)uiSize;
 
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+	(void)xTraceEventBufferGetUsed(pxTraceEventBuffer, &uiUsed);
+	TRC_HEALTH_METRICS_SET_IF_HIGHER(uxMaxFill, uiUsed);
+#endif
+
 	return TRC_SUCCESS;
 }
 
@@ -275,6 +288,9 @@ traceResult xTraceEventBufferPush(TraceEventBuffer_t *pxTraceEventBuffer, void *
 	uint32_t uiHead;
 	uint32_t uiTail;
 	uint32_t uiFreeSpace;
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+	uint32_t uiUsed = 0u;
+#endif
 	
 	/* This should never fail */
 	TRC_ASSERT(pxTraceEventBuffer != (void*)0);
@@ -389,6 +405,11 @@ traceResult xTraceEventBufferPush(TraceEventBuffer_t *pxTraceEventBuffer, void *
 			return TRC_FAIL;
 	}
 
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+	(void)xTraceEventBufferGetUsed(pxTraceEventBuffer, &uiUsed);
+	TRC_HEALTH_METRICS_SET_IF_HIGHER(uxMaxFill, uiUsed);
+#endif
+
 	return TRC_SUCCESS;
 }
 
@@ -542,4 +563,31 @@ traceResult xTraceEventBufferClear(TraceEventBuffer_t* pxTraceEventBuffer)
 	return TRC_SUCCESS;
 }
 
+traceResult xTraceEventBufferGetUsed(const TraceEventBuffer_t* pxTraceEventBuffer, uint32_t* puiUsed)
+{
+	uint32_t uiHead;
+	uint32_t uiTail;
+
+	/* This should never fail */
+	TRC_ASSERT(pxTraceEventBuffer != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puiUsed != (void*)0);
+
+	uiHead = pxTraceEventBuffer->uiHead;
+	uiTail = pxTraceEventBuffer->uiTail;
+
+	if (uiHead >= uiTail)
+	{
+		*puiUsed = uiHead - uiTail;
+	}
+	else
+	{
+		/* Wrapped, the slack at the end of the buffer holds no data */
+		*puiUsed = (pxTraceEventBuffer->uiSize - pxTraceEventBuffer->uiSlack - uiTail) + uiHead;
+	}
+
+	return TRC_SUCCESS;
+}
+
 #endif
@@ -12,6 +12,14 @@
 
 #if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_USE_HEAPS == 1)
 
+#if (TRC_CFG_HEAP_AGGREGATION == 1)
+
+static TraceHeapAggregation_t xHeapAggregation;
+
+static void prvTraceHeapAggregate(TraceUnsignedBaseType_t uxSize, TraceUnsignedBaseType_t uxIsAlloc);
+
+#endif
+
 /*cstat !MISRAC2004-6.3 !MISRAC2012-Dir-4.6_a Suppress basic char type usage*/
 traceResult xTraceHeapCreate(const char *szName, TraceUnsignedBaseType_t uxCurrent, TraceUnsignedBaseType_t uxHighWaterMark, TraceUnsignedBaseType_t uxMax, TraceHeapHandle_t *pxHeapHandle)
 {
@@ -56,6 +64,16 @@ traceResult xTraceHeapAlloc(TraceHeapHandle_t xHeapHandle, void *pvAddress, Trac
 		TRC_ASSERT_ALWAYS_EVALUATE(xTraceEntrySetState(xHeapHandle, TRC_HEAP_STATE_INDEX_CURRENT, uxCurrent) == TRC_SUCCESS);
 	}
 
+#if (TRC_CFG_HEAP_AGGREGATION == 1)
+	if (pvAddress != (void*)0)
+	{
+		/* Account by the size the block will be freed with, so both end up in the same class */
+		prvTraceHeapAggregate(TRC_KERNEL_PORT_HEAP_BLOCK_SIZE(xHeapHandle, pvAddress, uxSize), 1u);
+
+		return TRC_SUCCESS;
+	}
+#endif
+
 	(void)xTraceEventCreate2((pvAddress != (void*)0) ? PSF_EVENT_MALLOC : PSF_EVENT_MALLOC_FAILED, (TraceUnsignedBaseType_t)pvAddress, uxSize);  /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 !MISRAC2012-Rule-11.6 Suppress conversion from pointer to integer check*/
 
 	return TRC_SUCCESS;
@@ -83,9 +101,187 @@ traceResult xTraceHeapFree(TraceHeapHandle_t xHeapHandle, void *pvAddress, Trace
 		TRC_ASSERT_ALWAYS_EVALUATE(xTraceEntrySetState(xHeapHandle, TRC_HEAP_STATE_INDEX_CURRENT, uxCurrent) == TRC_SUCCESS);
 	}
 
+#if (TRC_CFG_HEAP_AGGREGATION == 1)
+	if (pvAddress != (void*)0)
+	{
+		prvTraceHeapAggregate(uxSize, 0u);
+
+		return TRC_SUCCESS;
+	}
+#endif
+
 	(void)xTraceEventCreate2((pvAddress != (void*)0) ? PSF_EVENT_FREE : PSF_EVENT_FREE_FAILED, (TraceUnsignedBaseType_t)pvAddress, uxSize);  /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 !MISRAC2012-Rule-11.6 Suppress conversion from pointer to integer check*/
 
 	return TRC_SUCCESS;
 }
 
+#if (TRC_CFG_HEAP_AGGREGATION == 1)
+
+traceResult xTraceHeapReport(void)
+{
+#if (TRC_CFG_INCLUDE_USER_EVENTS == 1)
+	static TraceStringHandle_t xChannel = 0;
+	static TraceStringHandle_t xTotalsFormat = 0;
+	static TraceStringHandle_t xSizeClassFormat = 0;
+	static TraceStringHandle_t xTaskFormat = 0;
+	TraceHeapAggregation_t xCopy;
+	TraceHeapSizeClass_t* pxSizeClass;
+	TraceHeapTaskTotals_t* pxTask;
+	TraceUnsignedBaseType_t uxAllocCount = 0u, uxFreeCount = 0u, uxCurrent = 0u, uxClassSize;
+	uint32_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	if (xHeapAggregation.uxChanged == 0u)
+	{
+		return TRC_SUCCESS;
+	}
+
+	if (xChannel == 0)
+	{
+		if ((xTraceStringRegister("Heap", &xChannel) == TRC_FAIL) ||
+			(xTraceStringRegister("Allocs: %u Frees: %u Current: %u", &xTotalsFormat) == TRC_FAIL) ||
+			(xTraceStringRegister("Size <= %u: Allocs: %u Current: %u Peak: %u", &xSizeClassFormat) == TRC_FAIL) ||
+			(xTraceStringRegister("Task 0x%X: Allocs: %u Allocated: %u Freed: %u", &xTaskFormat) == TRC_FAIL))
+		{
+			xChannel = 0;
+
+			return TRC_FAIL;
+		}
+	}
+
+	/* Report a consistent copy, the counters may be updated while the events are stored */
+	TRACE_ENTER_CRITICAL_SECTION();
+	xCopy = xHeapAggregation;
+	xHeapAggregation.uxChanged = 0u;
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_HEAP_AGGREGATION_SIZE_CLASSES); i++)
+	{
+		uxAllocCount += xCopy.xSizeClasses[i].uxAllocCount;
+		uxFreeCount += xCopy.xSizeClasses[i].uxFreeCount;
+		uxCurrent += xCopy.xSizeClasses[i].uxCurrent;
+	}
+
+	(void)xTracePrintF3(xChannel, xTotalsFormat, uxAllocCount, uxFreeCount, uxCurrent);
+
+	uxClassSize = TRC_HEAP_AGGREGATION_FIRST_CLASS_SIZE;
+	for (i = 0u; i < (uint32_t)(TRC_CFG_HEAP_AGGREGATION_SIZE_CLASSES); i++)
+	{
+		pxSizeClass = &xCopy.xSizeClasses[i];
+
+		if (pxSizeClass->uxAllocCount != 0u)
+		{
+			/* The last class has no upper limit */
+			(void)xTracePrintF4(xChannel, xSizeClassFormat, (i < (uint32_t)(TRC_CFG_HEAP_AGGREGATION_SIZE_CLASSES) - 1u) ? uxClassSize : (TraceUnsignedBaseType_t)-1, pxSizeClass->uxAllocCount, pxSizeClass->uxCurrent, pxSizeClass->uxHighWaterMark);
+		}
+
+		uxClassSize <<= 1u;
+	}
+
+	for (i = 0u; i <= (uint32_t)(TRC_CFG_HEAP_AGGREGATION_TASKS); i++)
+	{
+		pxTask = (i < (uint32_t)(TRC_CFG_HEAP_AGGREGATION_TASKS)) ? &xCopy.xTasks[i] : &xCopy.xOtherTasks;
+
+		if (pxTask->uxAllocCount != 0u)
+		{
+			(void)xTracePrintF4(xChannel, xTaskFormat, (TraceUnsignedBaseType_t)pxTask->pvTask, pxTask->uxAllocCount, pxTask->uxAllocBytes, pxTask->uxFreeBytes); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 !MISRAC2012-Rule-11.6 Suppress conversion from pointer to integer check*/
+		}
+	}
+#endif
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceHeapGetAggregation(void** ppvData, TraceUnsignedBaseType_t* puxSize)
+{
+	/* This should never fail */
+	TRC_ASSERT(ppvData != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puxSize != (void*)0);
+
+	*ppvData = (void*)&xHeapAggregation;
+	*puxSize = sizeof(xHeapAggregation);
+
+	return TRC_SUCCESS;
+}
+
+static void prvTraceHeapAggregate(TraceUnsignedBaseType_t uxSize, TraceUnsignedBaseType_t uxIsAlloc)
+{
+	TraceHeapSizeClass_t* pxSizeClass;
+	TraceHeapTaskTotals_t* pxTask = (void*)0;
+	TraceUnsignedBaseType_t uxClassSize = TRC_HEAP_AGGREGATION_FIRST_CLASS_SIZE;
+	void* pvCurrentTask = (void*)0;
+	uint32_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* If called from an ISR, this is the interrupted task */
+	(void)xTraceTaskGetCurrent(&pvCurrentTask);
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_HEAP_AGGREGATION_SIZE_CLASSES) - 1u; i++)
+	{
+		if (uxSize <= uxClassSize)
+		{
+			break;
+		}
+
+		uxClassSize <<= 1u;
+	}
+
+	pxSizeClass = &xHeapAggregation.xSizeClasses[i];
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	for (i = 0u; i < (uint32_t)(TRC_CFG_HEAP_AGGREGATION_TASKS); i++)
+	{
+		if (xHeapAggregation.xTasks[i].pvTask == pvCurrentTask)
+		{
+			pxTask = &xHeapAggregation.xTasks[i];
+			break;
+		}
+
+		if (xHeapAggregation.xTasks[i].pvTask == (void*)0)
+		{
+			/* Entries are used in order, so the task has no entry yet */
+			xHeapAggregation.xTasks[i].pvTask = pvCurrentTask;
+			pxTask = &xHeapAggregation.xTasks[i];
+			break;
+		}
+	}
+
+	if ((pxTask == (void*)0) || (pvCurrentTask == (void*)0))
+	{
+		pxTask = &xHeapAggregation.xOtherTasks;
+	}
+
+	if (uxIsAlloc != 0u)
+	{
+		pxSizeClass->uxAllocCount++;
+		pxSizeClass->uxCurrent += uxSize;
+
+		if (pxSizeClass->uxCurrent > pxSizeClass->uxHighWaterMark)
+		{
+			pxSizeClass->uxHighWaterMark = pxSizeClass->uxCurrent;
+		}
+
+		pxTask->uxAllocCount++;
+		pxTask->uxAllocBytes += uxSize;
+	}
+	else
+	{
+		pxSizeClass->uxFreeCount++;
+
+		/* Blocks allocated before the recorder was started were never added */
+		pxSizeClass->uxCurrent = (pxSizeClass->uxCurrent > uxSize) ? (pxSizeClass->uxCurrent - uxSize) : 0u;
+
+		pxTask->uxFreeBytes += uxSize;
+	}
+
+	xHeapAggregation.uxChanged = 1u;
+
+	TRACE_EXIT_CRITICAL_SECTION();
+}
+
+#endif
+
 #endif
@@ -18,6 +18,19 @@
 
 static TraceMultiCoreEventBuffer_t *pxInternalEventBuffer TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+
+#define TRC_INTERNAL_BUFFER_WAKEUP_NONE 0u
+#define TRC_INTERNAL_BUFFER_WAKEUP_PENDING 1u
+#define TRC_INTERNAL_BUFFER_WAKEUP_SENT 2u
+
+/* Set when a push crosses the high water level, reset by the next transfer */
+static volatile uint32_t uiInternalEventBufferWakeup TRC_CFG_RECORDER_DATA_ATTRIBUTE;
+
+static uint32_t prvTraceInternalEventBufferIsAboveHighWater(const TraceEventBuffer_t* pxEventBuffer);
+
+#endif
+
 traceResult xTraceInternalEventBufferInitialize(uint8_t* puiBuffer, uint32_t uiSize)
 {
 	/* uiSize must be larger than sizeof(TraceMultiCoreEventBuffer_t) or there will be no room for any data */
@@ -35,6 +48,10 @@ traceResult xTraceInternalEventBufferInitialize(uint8_t* puiBuffer, uint32_t uiS
 		return TRC_FAIL;
 	}
 
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+	uiInternalEventBufferWakeup = TRC_INTERNAL_BUFFER_WAKEUP_NONE;
+#endif
+
 	(void)xTraceSetComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER);
 
 	return TRC_SUCCESS;
@@ -45,7 +62,19 @@ traceResult xTraceInternalEventBufferAlloc(uint32_t uiSize, void **ppvData)
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
 
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+	if (xTraceMultiCoreEventBufferAlloc(pxInternalEventBuffer, uiSize, ppvData) == TRC_FAIL)
+	{
+		/* No room, the event is dropped */
+		(void)xTraceDiagnosticsIncrease(TRC_DIAGNOSTICS_INTERNAL_BUFFER_DROPPED_EVENTS);
+
+		return TRC_FAIL;
+	}
+
+	return TRC_SUCCESS;
+#else
 	return xTraceMultiCoreEventBufferAlloc(pxInternalEventBuffer, uiSize, ppvData);
+#endif
 }
 
 traceResult xTraceInternalEventBufferAllocCommit(void *pvData, uint32_t uiSize, int32_t *piBytesWritten)
@@ -55,7 +84,22 @@ traceResult xTraceInternalEventBufferAllocCommit(void *pvData, uint32_t uiSize,
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
 
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+	if (xTraceMultiCoreEventBufferAllocCommit(pxInternalEventBuffer, pvData, uiSize, piBytesWritten) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	if ((uiInternalEventBufferWakeup == TRC_INTERNAL_BUFFER_WAKEUP_NONE) &&
+		(prvTraceInternalEventBufferIsAboveHighWater(pxInternalEventBuffer->xEventBuffer[TRC_CFG_GET_CURRENT_CORE()]) != 0u))
+	{
+		uiInternalEventBufferWakeup = TRC_INTERNAL_BUFFER_WAKEUP_PENDING;
+	}
+
+	return TRC_SUCCESS;
+#else
 	return xTraceMultiCoreEventBufferAllocCommit(pxInternalEventBuffer, pvData, uiSize, piBytesWritten);
+#endif
 }
 
 traceResult xTraceInternalEventBufferPush(void *pvData, uint32_t uiSize, int32_t *piBytesWritten)
@@ -63,7 +107,28 @@ traceResult xTraceInternalEventBufferPush(void *pvData, uint32_t uiSize, int32_t
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
 	
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+	if (xTraceMultiCoreEventBufferPush(pxInternalEventBuffer, pvData, uiSize, piBytesWritten) == TRC_FAIL)
+	{
+		return TRC_FAIL;
+	}
+
+	if (*piBytesWritten == 0)
+	{
+		/* No room, the event is dropped */
+		(void)xTraceDiagnosticsIncrease(TRC_DIAGNOSTICS_INTERNAL_BUFFER_DROPPED_EVENTS);
+	}
+
+	if ((uiInternalEventBufferWakeup == TRC_INTERNAL_BUFFER_WAKEUP_NONE) &&
+		(prvTraceInternalEventBufferIsAboveHighWater(pxInternalEventBuffer->xEventBuffer[TRC_CFG_GET_CURRENT_CORE()]) != 0u))
+	{
+		uiInternalEventBufferWakeup = TRC_INTERNAL_BUFFER_WAKEUP_PENDING;
+	}
+
+	return TRC_SUCCESS;
+#else
 	return xTraceMultiCoreEventBufferPush(pxInternalEventBuffer, pvData, uiSize, piBytesWritten);
+#endif
 }
 
 traceResult xTraceInternalEventBufferTransferAll(void)
@@ -73,6 +138,10 @@ traceResult xTraceInternalEventBufferTransferAll(void)
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
 
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+	uiInternalEventBufferWakeup = TRC_INTERNAL_BUFFER_WAKEUP_NONE;
+#endif
+
 	return xTraceMultiCoreEventBufferTransferAll(pxInternalEventBuffer, &iBytesWritten);
 }
 
@@ -80,10 +149,20 @@ traceResult xTraceInternalEventBufferTransferChunk(void)
 {
 	int32_t iBytesWritten = 0;
 	int32_t iCounter = 0;
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+	uint32_t uiFill = 0u;
+	uint32_t uiTransferStart = 0u;
+	uint32_t uiTransferTime = 0u;
+	uint32_t uiTimestamp = 0u;
+#endif
 
 	/* This should never fail */
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
 
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+	(void)xTraceTimestampGet(&uiTransferStart);
+#endif
+
 	do
 	{
 		if (xTraceMultiCoreEventBufferTransferChunk(pxInternalEventBuffer, TRC_INTERNAL_BUFFER_CHUNK_SIZE, &iBytesWritten) == TRC_FAIL)
@@ -92,8 +171,29 @@ traceResult xTraceInternalEventBufferTransferChunk(void)
 		}
 
 		iCounter++;
+
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+		(void)xTraceTimestampGet(&uiTimestamp);
+		uiTransferTime = uiTimestamp - uiTransferStart;
+
+		if (uiTransferTime >= (uint32_t)(TRC_CFG_CTRL_TASK_TRANSFER_BUDGET))
+		{
+			/* The rest waits for the next TzCtrl loop */
+			break;
+		}
+
+		/* Above the high water level we keep going until the budget is spent, regardless of TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT */
+		(void)xTraceInternalEventBufferGetFill(&uiFill);
+	} while (iBytesWritten >= (int32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT) &&
+		((iCounter < (int32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT)) || (uiFill >= (uint32_t)(TRC_CFG_CTRL_TASK_HIGH_WATER_PERCENT))));
+
+	uiInternalEventBufferWakeup = TRC_INTERNAL_BUFFER_WAKEUP_NONE;
+
+	(void)xTraceDiagnosticsSetIfHigher(TRC_DIAGNOSTICS_INTERNAL_BUFFER_TRANSFER_TIME_MAX, (TraceBaseType_t)uiTransferTime);
+#else
 		/* This will do another loop if TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT of data was transferred and we haven't already looped TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT number of times */
 	} while (iBytesWritten >= (int32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_SIZE_LIMIT) && iCounter < (int32_t)(TRC_INTERNAL_BUFFER_CHUNK_TRANSFER_AGAIN_COUNT_LIMIT));
+#endif
 
 	return TRC_SUCCESS;
 }
@@ -106,4 +206,72 @@ traceResult xTraceInternalEventBufferClear()
 	return xTraceMultiCoreEventBufferClear(pxInternalEventBuffer);
 }
 
+traceResult xTraceInternalEventBufferGetFill(uint32_t* puiPercent)
+{
+	uint32_t uiCoreId;
+	uint32_t uiUsed = 0u;
+	uint32_t uiPercent;
+	const TraceEventBuffer_t* pxEventBuffer;
+
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_INTERNAL_EVENT_BUFFER));
+
+	/* This should never fail */
+	TRC_ASSERT(puiPercent != (void*)0);
+
+	*puiPercent = 0u;
+
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		pxEventBuffer = pxInternalEventBuffer->xEventBuffer[uiCoreId];
+
+		(void)xTraceEventBufferGetUsed(pxEventBuffer, &uiUsed);
+
+		uiPercent = (uiUsed * 100u) / pxEventBuffer->uiSize;
+
+		if (uiPercent > *puiPercent)
+		{
+			*puiPercent = uiPercent;
+		}
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceInternalEventBufferGetWakeup(uint32_t* puiWakeup)
+{
+	/* This should never fail */
+	TRC_ASSERT(puiWakeup != (void*)0);
+
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+	if (uiInternalEventBufferWakeup == TRC_INTERNAL_BUFFER_WAKEUP_PENDING)
+	{
+		/* Only report once, the flag is reset by the transfer */
+		uiInternalEventBufferWakeup = TRC_INTERNAL_BUFFER_WAKEUP_SENT;
+		*puiWakeup = 1u;
+
+		(void)xTraceDiagnosticsIncrease(TRC_DIAGNOSTICS_INTERNAL_BUFFER_EARLY_WAKEUPS);
+
+		return TRC_SUCCESS;
+	}
+#endif
+
+	*puiWakeup = 0u;
+
+	return TRC_SUCCESS;
+}
+
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+
+static uint32_t prvTraceInternalEventBufferIsAboveHighWater(const TraceEventBuffer_t* pxEventBuffer)
+{
+	uint32_t uiUsed = 0u;
+
+	(void)xTraceEventBufferGetUsed(pxEventBuffer, &uiUsed);
+
+	return ((uiUsed * 100u) >= (pxEventBuffer->uiSize * (uint32_t)(TRC_CFG_CTRL_TASK_HIGH_WATER_PERCENT))) ? 1u : 0u;
+}
+
+#endif
+
 #endif
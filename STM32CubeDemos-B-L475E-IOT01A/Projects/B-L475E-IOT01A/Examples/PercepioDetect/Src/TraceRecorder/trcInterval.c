@@ -12,6 +12,15 @@
 
 #if (TRC_USE_TRACEALYZER_RECORDER == 1)
 
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0)
+
+static TraceIntervalAggregation_t axIntervalAggregation[TRC_CFG_INTERVAL_AGGREGATION_SLOTS];
+static TraceUnsignedBaseType_t uxIntervalAggregationCount = 0u;
+
+static void prvTraceIntervalAggregate(TraceIntervalAggregation_t* pxAggregation, TraceIntervalInstanceHandle_t xIntervalInstanceHandle);
+
+#endif
+
 /*cstat !MISRAC2004-6.3 !MISRAC2012-Dir-4.6_a Suppress basic char type usage*/
 traceResult xTraceIntervalChannelSetCreate(const char* szName, TraceIntervalChannelSetHandle_t* pxIntervalChannelSetHandle)
 {
@@ -38,6 +47,10 @@ traceResult xTraceIntervalChannelSetCreate(const char* szName, TraceIntervalChan
 traceResult xTraceIntervalChannelCreate(const char *szName, TraceIntervalChannelSetHandle_t xIntervalChannelSetHandle, TraceIntervalChannelHandle_t *pxIntervalChannelHandle)
 {
 	TraceObjectHandle_t xObjectHandle;
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0)
+	traceResult xResult = TRC_SUCCESS;
+	TRACE_ALLOC_CRITICAL_SECTION();
+#endif
 
 	/* This should never fail */
 	TRC_ASSERT(pxIntervalChannelHandle != (void*)0);
@@ -54,6 +67,25 @@ traceResult xTraceIntervalChannelCreate(const char *szName, TraceIntervalChannel
 	/* This should never fail */
 	TRC_ASSERT_ALWAYS_EVALUATE(xTraceEntrySetOptions((TraceEntryHandle_t)xObjectHandle, TRC_ENTRY_OPTION_INTERVAL_CHANNEL) == TRC_SUCCESS);
 
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0)
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	/* Channels that don't get a slot store all events */
+	if (uxIntervalAggregationCount < (TraceUnsignedBaseType_t)(TRC_CFG_INTERVAL_AGGREGATION_SLOTS))
+	{
+		axIntervalAggregation[uxIntervalAggregationCount].xIntervalChannelHandle = (TraceIntervalChannelHandle_t)xObjectHandle;
+		uxIntervalAggregationCount++;
+
+		/* Stored as index + 1 since 0 means no slot */
+		xResult = xTraceEntrySetState((TraceEntryHandle_t)xObjectHandle, TRC_INTERVAL_AGGREGATION_INDEX, uxIntervalAggregationCount);
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xResult == TRC_SUCCESS);
+#endif
+
 	*pxIntervalChannelHandle = (TraceIntervalChannelHandle_t)xObjectHandle;
 	
 	return TRC_SUCCESS;
@@ -70,6 +102,15 @@ traceResult xTraceIntervalStart(TraceIntervalChannelHandle_t xIntervalChannelHan
 
 	TRC_ASSERT_ALWAYS_EVALUATE(xTraceTimestampGet((uint32_t*)pxIntervalInstanceHandle) == TRC_SUCCESS); /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress conversion between pointer types checks*/
 
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0)
+	if ((xTraceEntryGetStateReturn((TraceEntryHandle_t)xIntervalChannelHandle, TRC_INTERVAL_AGGREGATION_INDEX) != 0u) &&
+		(xTraceEntryGetStateReturn((TraceEntryHandle_t)xIntervalChannelHandle, TRC_INTERVAL_RAW_EVENTS_INDEX) == 0u))
+	{
+		/* Only aggregated, the duration is added when the interval stops */
+		return TRC_SUCCESS;
+	}
+#endif
+
 	(void)xTraceEventCreate3(PSF_EVENT_INTERVAL_START, (TraceUnsignedBaseType_t)xIntervalChannelHandle, (TraceUnsignedBaseType_t)*pxIntervalInstanceHandle, uxValue); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion from pointer to integer check*/
 	
 	return TRC_SUCCESS;
@@ -77,11 +118,124 @@ traceResult xTraceIntervalStart(TraceIntervalChannelHandle_t xIntervalChannelHan
 
 traceResult xTraceIntervalStop(TraceIntervalChannelHandle_t xIntervalChannelHandle, TraceIntervalInstanceHandle_t xIntervalInstanceHandle)
 {
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0)
+	TraceUnsignedBaseType_t uxSlot;
+#endif
+
 	TRC_ASSERT(xIntervalChannelHandle != 0);
 
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0)
+	uxSlot = xTraceEntryGetStateReturn((TraceEntryHandle_t)xIntervalChannelHandle, TRC_INTERVAL_AGGREGATION_INDEX);
+
+	if (uxSlot != 0u)
+	{
+		prvTraceIntervalAggregate(&axIntervalAggregation[uxSlot - 1u], xIntervalInstanceHandle);
+
+		if (xTraceEntryGetStateReturn((TraceEntryHandle_t)xIntervalChannelHandle, TRC_INTERVAL_RAW_EVENTS_INDEX) == 0u)
+		{
+			return TRC_SUCCESS;
+		}
+	}
+#endif
+
 	(void)xTraceEventCreate2(PSF_EVENT_INTERVAL_STOP, (TraceUnsignedBaseType_t)xIntervalChannelHandle, (TraceUnsignedBaseType_t)xIntervalInstanceHandle); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion from pointer to integer check*/
 
 	return TRC_SUCCESS;
 }
 
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0)
+
+traceResult xTraceIntervalReport(void)
+{
+#if (TRC_CFG_INCLUDE_USER_EVENTS == 1)
+	static TraceStringHandle_t xFormat = 0;
+	static TraceStringHandle_t axChannels[TRC_CFG_INTERVAL_AGGREGATION_SLOTS] = { 0 };
+	const char* szName;
+	TraceIntervalAggregation_t xAggregation;
+	TraceUnsignedBaseType_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	if (xFormat == 0)
+	{
+		if (xTraceStringRegister("Intervals: %u Total: %u Min: %u Max: %u", &xFormat) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+	}
+
+	for (i = 0u; i < uxIntervalAggregationCount; i++)
+	{
+		/* The channel name is registered once as User Event channel */
+		if (axChannels[i] == 0)
+		{
+			if ((xTraceEntryGetSymbol((TraceEntryHandle_t)axIntervalAggregation[i].xIntervalChannelHandle, &szName) == TRC_FAIL) ||
+				(xTraceStringRegister(szName, &axChannels[i]) == TRC_FAIL))
+			{
+				return TRC_FAIL;
+			}
+		}
+
+		TRACE_ENTER_CRITICAL_SECTION();
+		xAggregation = axIntervalAggregation[i];
+		axIntervalAggregation[i].uxCount = 0u;
+		axIntervalAggregation[i].uxTotal = 0u;
+		axIntervalAggregation[i].uxMin = 0u;
+		axIntervalAggregation[i].uxMax = 0u;
+		TRACE_EXIT_CRITICAL_SECTION();
+
+		if (xAggregation.uxCount != 0u)
+		{
+			(void)xTracePrintF4(axChannels[i], xFormat, xAggregation.uxCount, xAggregation.uxTotal, xAggregation.uxMin, xAggregation.uxMax);
+		}
+	}
+#endif
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceIntervalGetAggregation(void** ppvData, TraceUnsignedBaseType_t* puxSize)
+{
+	/* This should never fail */
+	TRC_ASSERT(ppvData != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puxSize != (void*)0);
+
+	*ppvData = (void*)axIntervalAggregation;
+	*puxSize = sizeof(axIntervalAggregation);
+
+	return TRC_SUCCESS;
+}
+
+static void prvTraceIntervalAggregate(TraceIntervalAggregation_t* pxAggregation, TraceIntervalInstanceHandle_t xIntervalInstanceHandle)
+{
+	uint32_t uiTimestamp = 0u;
+	TraceUnsignedBaseType_t uxDuration;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	(void)xTraceTimestampGet(&uiTimestamp);
+
+	/* The instance handle holds the start timestamp */
+	uxDuration = (TraceUnsignedBaseType_t)(uiTimestamp - (uint32_t)xIntervalInstanceHandle);
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	if ((pxAggregation->uxCount == 0u) || (uxDuration < pxAggregation->uxMin))
+	{
+		pxAggregation->uxMin = uxDuration;
+	}
+
+	if (uxDuration > pxAggregation->uxMax)
+	{
+		pxAggregation->uxMax = uxDuration;
+	}
+
+	pxAggregation->uxCount++;
+	pxAggregation->uxTotal += uxDuration;
+
+	TRACE_EXIT_CRITICAL_SECTION();
+}
+
+#endif
+
 #endif
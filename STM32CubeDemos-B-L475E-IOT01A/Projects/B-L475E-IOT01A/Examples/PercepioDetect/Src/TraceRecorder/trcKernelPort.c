@@ -134,6 +134,26 @@ traceResult xTraceKernelPortGetUnusedStack(void* pvTask, TraceUnsignedBaseType_t
 	return TRC_SUCCESS;
 }
 
+traceResult xTraceKernelPortGetStackBase(void* pvTask, void** ppvStackBase)
+{
+#if (portSTACK_GROWTH < 0) && (configUSE_TRACE_FACILITY == 1)
+	TaskStatus_t xTaskStatus;
+
+	/* Passing a state avoids the (slower) state lookup, we only need the stack base */
+	vTaskGetInfo((TaskHandle_t)pvTask, &xTaskStatus, pdFALSE, eRunning);
+
+	*ppvStackBase = (void*)xTaskStatus.pxStackBase;
+
+	return TRC_SUCCESS;
+#else
+	(void)pvTask;
+
+	*ppvStackBase = 0;
+
+	return TRC_FAIL;
+#endif
+}
+
 #endif
 
 traceResult xTraceKernelPortDelay(uint32_t uiTicks)
@@ -232,15 +252,62 @@ traceResult xTraceKernelPortEnable(void)
 
 static portTASK_FUNCTION(TzCtrl, pvParameters)
 {
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+	TickType_t xDelay = (TickType_t)(TRC_CFG_CTRL_TASK_DELAY);
+	uint32_t uiFill = 0u;
+#endif
+
 	(void)pvParameters;
 
 	while (1)
 	{
 		xTraceTzCtrl();
 
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+		/* Back off while there is nothing to transfer, return to the normal delay as soon as there is */
+		(void)xTraceInternalEventBufferGetFill(&uiFill);
+		if (uiFill == 0u)
+		{
+			xDelay *= 2u;
+			if (xDelay > (TickType_t)(TRC_CFG_CTRL_TASK_DELAY_MAX))
+			{
+				xDelay = (TickType_t)(TRC_CFG_CTRL_TASK_DELAY_MAX);
+			}
+		}
+		else
+		{
+			xDelay = (TickType_t)(TRC_CFG_CTRL_TASK_DELAY);
+		}
+
+		/* Woken up early by xTraceKernelPortWakeTzCtrl() if the internal buffer crosses the high water level */
+		(void)ulTaskNotifyTake(pdTRUE, xDelay);
+#else
 		vTaskDelay(TRC_CFG_CTRL_TASK_DELAY);
+#endif
+	}
+}
+
+#if ((TRC_CFG_CTRL_TASK_TRANSFER_BUDGET) > 0)
+traceResult xTraceKernelPortWakeTzCtrl(void)
+{
+	uint32_t uiWakeup = 0u;
+
+	if ((pxKernelPortData == (void*)0) || (pxKernelPortData->xTzCtrlHandle == 0))
+	{
+		return TRC_FAIL;
 	}
+
+	(void)xTraceInternalEventBufferGetWakeup(&uiWakeup);
+
+	if (uiWakeup == 1u)
+	{
+		/* Called from the tick, TzCtrl has low priority so there is no need to request a context switch */
+		vTaskNotifyGiveFromISR((TaskHandle_t)pxKernelPortData->xTzCtrlHandle, (BaseType_t*)0);
+	}
+
+	return TRC_SUCCESS;
 }
+#endif
 
 traceResult xTraceKernelPortSetTaskMonitorData(void* pvTask, void* pvData)
 {
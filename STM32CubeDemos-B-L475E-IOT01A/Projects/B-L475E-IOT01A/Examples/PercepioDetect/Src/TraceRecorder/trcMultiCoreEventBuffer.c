@@ -12,6 +12,18 @@
 
 #if (TRC_USE_TRACEALYZER_RECORDER == 1)
 
+#include <string.h>
+
+/* Read position in a per-core event buffer while merging */
+typedef struct TraceMergeCursor
+{
+	uint32_t uiPosition;
+	uint32_t uiEnd;
+	uint32_t uiWrap;	/* Where the slack area starts, if the buffer has wrapped */
+} TraceMergeCursor_t;
+
+static uint32_t prvTraceMultiCoreEventBufferMergePass(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint8_t* puiDestination, uint32_t uiSkipBytes, uint32_t* puiEventsSkipped);
+
 traceResult xTraceMultiCoreEventBufferInitialize(TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint32_t uiOptions,
 	uint8_t* puiBuffer, uint32_t uiSize)
 {
@@ -157,4 +169,121 @@ traceResult xTraceMultiCoreEventBufferClear(const TraceMultiCoreEventBuffer_t* c
 	return TRC_SUCCESS;
 }
 
+/*cstat !MISRAC2012-Rule-5.1 Yes, these are long names*/
+traceResult xTraceMultiCoreEventBufferMerge(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint8_t* puiDestination, uint32_t uiDestinationSize, uint32_t* puiBytesWritten, uint32_t* puiEventsLeftOut)
+{
+	uint32_t uiTotal;
+	uint32_t uiSkipBytes = 0u;
+	uint32_t uiEventsSkipped = 0u;
+
+	/* This should never fail */
+	TRC_ASSERT(pxTraceMultiCoreEventBuffer != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puiDestination != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puiBytesWritten != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puiEventsLeftOut != (void*)0);
+
+	/* The first pass only counts, so we know how many of the oldest events to leave out */
+	uiTotal = prvTraceMultiCoreEventBufferMergePass(pxTraceMultiCoreEventBuffer, (void*)0, 0u, &uiEventsSkipped);
+
+	if (uiTotal > uiDestinationSize)
+	{
+		uiSkipBytes = uiTotal - uiDestinationSize;
+	}
+
+	*puiEventsLeftOut = 0u;
+	*puiBytesWritten = prvTraceMultiCoreEventBufferMergePass(pxTraceMultiCoreEventBuffer, puiDestination, uiSkipBytes, puiEventsLeftOut);
+
+	return TRC_SUCCESS;
+}
+
+/* Merges the per-core buffers oldest event first. Events are only copied if puiDestination is set, and
+ * events are left out from the start until at least uiSkipBytes have been skipped. Returns the number of
+ * bytes copied, or all bytes if puiDestination isn't set. */
+static uint32_t prvTraceMultiCoreEventBufferMergePass(const TraceMultiCoreEventBuffer_t* const pxTraceMultiCoreEventBuffer, uint8_t* puiDestination, uint32_t uiSkipBytes, uint32_t* puiEventsSkipped)
+{
+	TraceMergeCursor_t axCursors[TRC_CFG_CORE_COUNT];
+	const TraceEventBuffer_t* pxEventBuffer;
+	const TraceEvent0_t* pxEvent;
+	const TraceEvent0_t* pxOldest;
+	uint32_t uiOldestCore;
+	uint32_t uiCoreId;
+	uint32_t uiEventSize = 0u;
+	uint32_t uiSkipped = 0u;
+	uint32_t uiWritten = 0u;
+
+	for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+	{
+		pxEventBuffer = pxTraceMultiCoreEventBuffer->xEventBuffer[uiCoreId];
+
+		axCursors[uiCoreId].uiPosition = pxEventBuffer->uiTail;
+		axCursors[uiCoreId].uiEnd = pxEventBuffer->uiHead;
+		axCursors[uiCoreId].uiWrap = (pxEventBuffer->uiTail > pxEventBuffer->uiHead) ? (pxEventBuffer->uiSize - pxEventBuffer->uiSlack) : pxEventBuffer->uiSize;
+	}
+
+	for (;;)
+	{
+		pxOldest = (void*)0;
+		uiOldestCore = 0u;
+
+		for (uiCoreId = 0u; uiCoreId < (uint32_t)(TRC_CFG_CORE_COUNT); uiCoreId++)
+		{
+			pxEventBuffer = pxTraceMultiCoreEventBuffer->xEventBuffer[uiCoreId];
+
+			if ((axCursors[uiCoreId].uiPosition != axCursors[uiCoreId].uiEnd) && (axCursors[uiCoreId].uiPosition >= axCursors[uiCoreId].uiWrap))
+			{
+				/* Reached the slack area, continue from the start */
+				axCursors[uiCoreId].uiPosition = 0u;
+				axCursors[uiCoreId].uiWrap = pxEventBuffer->uiSize;
+			}
+
+			if (axCursors[uiCoreId].uiPosition == axCursors[uiCoreId].uiEnd)
+			{
+				continue;
+			}
+
+			pxEvent = (const TraceEvent0_t*)&pxEventBuffer->puiBuffer[axCursors[uiCoreId].uiPosition]; /*cstat !MISRAC2004-11.4 !MISRAC2012-Rule-11.3 Suppress conversion between pointer types checks*/ /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+
+			/* Compared as a difference since the timestamp may wrap */
+			if ((pxOldest == (void*)0) || ((int32_t)(pxEvent->TS - pxOldest->TS) < 0))
+			{
+				pxOldest = pxEvent;
+				uiOldestCore = uiCoreId;
+			}
+		}
+
+		if (pxOldest == (void*)0)
+		{
+			break;
+		}
+
+		(void)xTraceEventGetSize(pxOldest, &uiEventSize);
+
+		if (uiSkipped < uiSkipBytes)
+		{
+			uiSkipped += uiEventSize;
+			(*puiEventsSkipped)++;
+		}
+		else
+		{
+			if (puiDestination != (void*)0)
+			{
+				(void)memcpy(&puiDestination[uiWritten], (const void*)pxOldest, uiEventSize); /*cstat !MISRAC2004-17.4_b We need to access a specific part of the buffer*/
+			}
+
+			uiWritten += uiEventSize;
+		}
+
+		pxEventBuffer = pxTraceMultiCoreEventBuffer->xEventBuffer[uiOldestCore];
+		axCursors[uiOldestCore].uiPosition = (axCursors[uiOldestCore].uiPosition + uiEventSize) % pxEventBuffer->uiSize;
+	}
+
+	return uiWritten;
+}
+
 #endif
@@ -13,11 +13,17 @@
 #if (TRC_USE_TRACEALYZER_RECORDER == 1) && (TRC_CFG_INCLUDE_USER_EVENTS == 1)
 
 #include <stdarg.h>
+#include <string.h>
 
 static traceResult prvTraceVPrintF(const TraceStringHandle_t xChannel, const char* szFormat, uint32_t uiLength, uint32_t uiArgs, va_list* pxVariableList);
+static traceResult prvTracePrintArrayStore(TraceStringHandle_t xChannel, uint32_t uiElementType, const void* pvData, uint32_t uiCount, uint32_t uiAge);
+static traceResult prvTracePrintArrayBufferFlush(TracePrintArrayBuffer_t* pxBuffer);
 
 static TracePrintData_t *pxPrintData TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
+/* All initialized print array buffers, so TzCtrl can flush them */
+static TracePrintArrayBuffer_t* pxPrintArrayBuffers = (void*)0;
+
 traceResult xTracePrintInitialize(TracePrintData_t *pxBuffer)
 {
 	/* This should never fail */
@@ -225,6 +231,216 @@ traceResult xTraceVPrintF(TraceStringHandle_t xChannel, const char* szFormat, va
 	return prvTraceVPrintF(xChannel, szFormat, uiLength, uiArgs, pxVariableList);
 }
 
+traceResult xTracePrintArray(TraceStringHandle_t xChannel, uint32_t uiElementType, const void* pvData, uint32_t uiCount)
+{
+	TraceUnsignedBaseType_t uxData[TRC_PRINT_ARRAY_MAX_SIZE / sizeof(TraceUnsignedBaseType_t)];
+	uint32_t uiElementSize = TRC_PRINT_ARRAY_ELEMENT_SIZE(uiElementType);
+
+	/* We need to check this */
+	if (xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_PRINT) == 0U)
+	{
+		return TRC_FAIL;
+	}
+
+	if ((uiElementSize == 0U) || (pvData == (void*)0))
+	{
+		return TRC_FAIL;
+	}
+
+	if (uiCount > (TRC_PRINT_ARRAY_MAX_SIZE / uiElementSize))
+	{
+		uiCount = TRC_PRINT_ARRAY_MAX_SIZE / uiElementSize; /*cstat !MISRAC2012-Rule-17.8 Suppress modified function parameter check*/
+	}
+
+	/* The event payload is padded to a whole number of parameters, copy the samples so that the padding isn't read past the end of the caller's array */
+	if (((uiCount * uiElementSize) % sizeof(TraceUnsignedBaseType_t)) != 0U)
+	{
+		uxData[(uiCount * uiElementSize) / sizeof(TraceUnsignedBaseType_t)] = 0U;
+		memcpy(uxData, pvData, uiCount * uiElementSize);
+		pvData = uxData; /*cstat !MISRAC2012-Rule-17.8 Suppress modified function parameter check*/
+	}
+
+	return prvTracePrintArrayStore(xChannel, uiElementType, pvData, uiCount, 0U);
+}
+
+traceResult xTracePrintArrayBufferInitialize(TracePrintArrayBuffer_t* pxBuffer, TraceStringHandle_t xChannel, uint32_t uiElementType)
+{
+	const TracePrintArrayBuffer_t* pxListed;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT(pxBuffer != (void*)0);
+
+	if (TRC_PRINT_ARRAY_ELEMENT_SIZE(uiElementType) == 0U)
+	{
+		return TRC_FAIL;
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	pxBuffer->xChannel = xChannel;
+	pxBuffer->uiElementType = uiElementType;
+	pxBuffer->uiCount = 0U;
+	pxBuffer->uiFirstTick = 0U;
+
+	for (pxListed = pxPrintArrayBuffers; (pxListed != (void*)0) && (pxListed != pxBuffer); pxListed = pxListed->pxNext) {}
+
+	/* A buffer that is initialized again is already listed */
+	if (pxListed == (void*)0)
+	{
+		pxBuffer->pxNext = pxPrintArrayBuffers;
+		pxPrintArrayBuffers = pxBuffer;
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTracePrintArrayBufferAdd(TracePrintArrayBuffer_t* pxBuffer, const void* pvData, uint32_t uiCount)
+{
+	traceResult xResult = TRC_SUCCESS;
+	uint32_t uiElementSize;
+	uint32_t uiTick = 0U;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT(pxBuffer != (void*)0);
+
+	uiElementSize = TRC_PRINT_ARRAY_ELEMENT_SIZE(pxBuffer->uiElementType);
+
+	/* This should never fail */
+	TRC_ASSERT(uiElementSize != 0U);
+
+	if ((pvData == (void*)0) || (uiCount == 0U) || (uiCount > (TRC_PRINT_ARRAY_MAX_SIZE / uiElementSize)))
+	{
+		return TRC_FAIL;
+	}
+
+	(void)xTraceTimestampGetOsTickCount(&uiTick);
+
+	/* TzCtrl may flush the buffer at any time */
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	if ((pxBuffer->uiCount > 0U) &&
+		((((pxBuffer->uiCount + uiCount) * uiElementSize) > TRC_PRINT_ARRAY_MAX_SIZE) ||
+		((TRC_CFG_PRINT_ARRAY_FLUSH_TICKS > 0) && ((uiTick - pxBuffer->uiFirstTick) >= (uint32_t)(TRC_CFG_PRINT_ARRAY_FLUSH_TICKS)))))
+	{
+		xResult = prvTracePrintArrayBufferFlush(pxBuffer);
+	}
+
+	if (pxBuffer->uiCount == 0U)
+	{
+		pxBuffer->uiFirstTick = uiTick;
+	}
+
+	memcpy(&((uint8_t*)pxBuffer->uxData)[pxBuffer->uiCount * uiElementSize], pvData, uiCount * uiElementSize);
+	pxBuffer->uiCount += uiCount;
+
+	/* Flush now if the next add of the same size wouldn't fit, so that the samples aren't held until then */
+	if (((pxBuffer->uiCount + uiCount) * uiElementSize) > TRC_PRINT_ARRAY_MAX_SIZE)
+	{
+		if (prvTracePrintArrayBufferFlush(pxBuffer) == TRC_FAIL)
+		{
+			xResult = TRC_FAIL;
+		}
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return xResult;
+}
+
+traceResult xTracePrintArrayBufferFlush(TracePrintArrayBuffer_t* pxBuffer)
+{
+	traceResult xResult;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT(pxBuffer != (void*)0);
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	xResult = prvTracePrintArrayBufferFlush(pxBuffer);
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	return xResult;
+}
+
+traceResult xTracePrintArrayBufferFlushExpired(void)
+{
+#if (TRC_CFG_PRINT_ARRAY_FLUSH_TICKS > 0)
+	TracePrintArrayBuffer_t* pxBuffer;
+	uint32_t uiTick = 0U;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	(void)xTraceTimestampGetOsTickCount(&uiTick);
+
+	/* Buffers are only added at the head, so the list can be walked one buffer at a time */
+	for (pxBuffer = pxPrintArrayBuffers; pxBuffer != (void*)0; pxBuffer = pxBuffer->pxNext)
+	{
+		TRACE_ENTER_CRITICAL_SECTION();
+
+		if ((pxBuffer->uiCount > 0U) && ((uiTick - pxBuffer->uiFirstTick) >= (uint32_t)(TRC_CFG_PRINT_ARRAY_FLUSH_TICKS)))
+		{
+			(void)prvTracePrintArrayBufferFlush(pxBuffer);
+		}
+
+		TRACE_EXIT_CRITICAL_SECTION();
+	}
+#endif
+
+	return TRC_SUCCESS;
+}
+
+/* Called within a critical section */
+static traceResult prvTracePrintArrayBufferFlush(TracePrintArrayBuffer_t* pxBuffer)
+{
+	traceResult xResult;
+	uint32_t uiTick = 0U;
+
+	if (pxBuffer->uiCount == 0U)
+	{
+		return TRC_SUCCESS;
+	}
+
+	/* We need to check this */
+	if (xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_PRINT) == 0U)
+	{
+		xResult = TRC_FAIL;
+	}
+	else
+	{
+		(void)xTraceTimestampGetOsTickCount(&uiTick);
+
+		/* The samples are stored in a whole buffer, so the padding is always within it */
+		xResult = prvTracePrintArrayStore(pxBuffer->xChannel, pxBuffer->uiElementType, pxBuffer->uxData, pxBuffer->uiCount, uiTick - pxBuffer->uiFirstTick);
+	}
+
+	/* The samples are dropped if they couldn't be stored, to not hold up newer samples */
+	pxBuffer->uiCount = 0U;
+
+	return xResult;
+}
+
+/* Parameter 2 holds the element type in bits 0-7, the sample count in bits 8-15 and the number of OS ticks since the first sample was added in bits 16-31 */
+static traceResult prvTracePrintArrayStore(TraceStringHandle_t xChannel, uint32_t uiElementType, const void* pvData, uint32_t uiCount, uint32_t uiAge)
+{
+	if (uiAge > 0xFFFFU)
+	{
+		uiAge = 0xFFFFU; /*cstat !MISRAC2012-Rule-17.8 Suppress modified function parameter check*/
+	}
+
+	return xTraceEventCreateData2(
+		PSF_EVENT_USER_EVENT_ARRAY,
+		(TraceUnsignedBaseType_t)xChannel, /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion of pointer to integer check*/
+		(TraceUnsignedBaseType_t)(uiElementType | (uiCount << 8) | (uiAge << 16)),
+		(const TraceUnsignedBaseType_t*)pvData, /*cstat !MISRAC2012-Rule-11.5 Suppress pointer conversion check, the data is copied bytewise*/
+		uiCount * TRC_PRINT_ARRAY_ELEMENT_SIZE(uiElementType)
+	);
+}
+
 /*cstat !MISRAC2004-6.3 !MISRAC2012-Dir-4.6_a Suppress basic char type usage*/ /*cstat !MISRAC2012-Rule-17.1 Suppress stdarg usage check*/
 static traceResult prvTraceVPrintF(TraceStringHandle_t xChannel, const char* szFormat, uint32_t uiLength, uint32_t uiArgs, va_list* pxVariableList)
 {
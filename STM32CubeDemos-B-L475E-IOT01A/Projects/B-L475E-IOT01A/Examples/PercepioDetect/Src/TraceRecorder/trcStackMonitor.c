@@ -16,8 +16,47 @@
 #define TRC_CFG_ALLOW_TASK_DELETE 1
 #endif
 
+#ifndef TRC_CFG_STACK_MONITOR_SCAN_WORDS
+#define TRC_CFG_STACK_MONITOR_SCAN_WORDS 0
+#endif
+
 static TraceStackMonitorData_t* pxStackMonitor TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
+#if ((TRC_CFG_STACK_MONITOR_SCAN_WORDS) > 0)
+/* Scans the entry from its cursor, using at most *puxBudget words. Returns TRC_SUCCESS
+ * when the pass is complete and *puxLowWaterMark is valid, TRC_FAIL if out of budget. */
+static traceResult prvTraceStackMonitorScan(TraceStackMonitorEntry_t *pxEntry, TraceUnsignedBaseType_t *puxBudget, TraceUnsignedBaseType_t *puxLowWaterMark)
+{
+	const uint32_t *puiStack = (const uint32_t*)pxEntry->pvStackBase;
+	TraceUnsignedBaseType_t uxOffset = pxEntry->uxScanOffset;
+
+	/* The stack can only have grown into the area below the previous low water mark */
+	while (uxOffset < pxEntry->uxPreviousLowWaterMark)
+	{
+		if (puiStack[uxOffset] != (uint32_t)(TRC_KERNEL_PORT_STACK_FILL_WORD))
+		{
+			break;
+		}
+
+		if (*puxBudget == 0)
+		{
+			/* Resume here on the next call */
+			pxEntry->uxScanOffset = uxOffset;
+
+			return TRC_FAIL;
+		}
+
+		uxOffset++;
+		(*puxBudget)--;
+	}
+
+	pxEntry->uxScanOffset = 0;
+	*puxLowWaterMark = uxOffset;
+
+	return TRC_SUCCESS;
+}
+#endif
+
 traceResult xTraceStackMonitorInitialize(TraceStackMonitorData_t *pxBuffer)
 {
 	uint32_t i;
@@ -69,6 +108,13 @@ traceResult xTraceStackMonitorAdd(void *pvTask)
 	{
 		pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount].pvTask = pvTask;
 		pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount].uxPreviousLowWaterMark = uxLowMark;
+		pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount].uxScanOffset = 0;
+
+		if (xTraceKernelPortGetStackBase(pvTask, &pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount].pvStackBase) != TRC_SUCCESS)
+		{
+			/* Fall back to full scans for this task */
+			pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount].pvStackBase = 0;
+		}
 
 		pxStackMonitor->uxEntryCount++;
 	}
@@ -102,8 +148,7 @@ traceResult xTraceStackMonitorRemove(void* pvTask)
 			if (pxStackMonitor->uxEntryCount > 1 && i != (pxStackMonitor->uxEntryCount - 1))
 			{
 				/* There are more entries and this is NOT the last entry. Move last entry to this slot. */
-				pxStackMonitor->xEntries[i].pvTask = pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount - 1].pvTask;
-				pxStackMonitor->xEntries[i].uxPreviousLowWaterMark = pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount - 1].uxPreviousLowWaterMark;
+				pxStackMonitor->xEntries[i] = pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount - 1];
 
 				/* Clear old entry that was moved */
 				pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount - 1].pvTask = 0;
@@ -156,6 +201,9 @@ traceResult xTraceStackMonitorReport(void)
 	TraceUnsignedBaseType_t uxToReport;
 	TraceUnsignedBaseType_t i;
 	static uint32_t uiCurrentIndex = 0;
+#if ((TRC_CFG_STACK_MONITOR_SCAN_WORDS) > 0)
+	TraceUnsignedBaseType_t uxBudget = (TRC_CFG_STACK_MONITOR_SCAN_WORDS);
+#endif
 
 #if (TRC_CFG_ALLOW_TASK_DELETE == 1)
 	TRACE_ALLOC_CRITICAL_SECTION();
@@ -178,6 +226,17 @@ traceResult xTraceStackMonitorReport(void)
 		
 		pxStackMonitorEntry = &pxStackMonitor->xEntries[uiCurrentIndex];
 
+#if ((TRC_CFG_STACK_MONITOR_SCAN_WORDS) > 0)
+		if (pxStackMonitorEntry->pvStackBase != 0)
+		{
+			if (prvTraceStackMonitorScan(pxStackMonitorEntry, &uxBudget, &uxLowWaterMark) != TRC_SUCCESS)
+			{
+				/* Out of budget, continue with this entry on the next call */
+				break;
+			}
+		}
+		else
+#endif
 		if (xTraceKernelPortGetUnusedStack(pxStackMonitorEntry->pvTask, &uxLowWaterMark) != TRC_SUCCESS)
 		{
 			uiCurrentIndex++;
@@ -14,6 +14,15 @@
 
 #define TRC_STATE_MACHINE_STATE_INDEX 0u
 #define TRC_STATE_MACHINE_INDEX 0u
+#define TRC_STATE_MACHINE_TIMESTAMP_INDEX 1u
+#define TRC_STATE_MACHINE_AGGREGATION_INDEX 1u
+
+#if (TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS > 0)
+
+static TraceStateMachineAggregation_t axStateMachineAggregation[TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS];
+static TraceUnsignedBaseType_t uxStateMachineAggregationCount = 0u;
+
+#endif
 
 /*cstat !MISRAC2004-6.3 !MISRAC2012-Dir-4.6_a Suppress basic char type usage*/
 traceResult xTraceStateMachineCreate(const char *szName, TraceStateMachineHandle_t *pxStateMachineHandle)
@@ -41,6 +50,10 @@ traceResult xTraceStateMachineCreate(const char *szName, TraceStateMachineHandle
 traceResult xTraceStateMachineStateCreate(TraceStateMachineHandle_t xStateMachineHandle, const char* szName, TraceStateMachineStateHandle_t* pxStateHandle)
 {
 	TraceObjectHandle_t xObjectHandle;
+#if (TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS > 0)
+	traceResult xResult = TRC_SUCCESS;
+	TRACE_ALLOC_CRITICAL_SECTION();
+#endif
 
 	/* This should never fail */
 	TRC_ASSERT(xStateMachineHandle != 0);
@@ -57,6 +70,25 @@ traceResult xTraceStateMachineStateCreate(TraceStateMachineHandle_t xStateMachin
 	/* This should never fail */
 	TRC_ASSERT_ALWAYS_EVALUATE(xTraceEntrySetOptions((TraceEntryHandle_t)xObjectHandle, (uint32_t)TRC_ENTRY_OPTION_STATE_MACHINE_STATE) == TRC_SUCCESS);
 
+#if (TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS > 0)
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	/* Changes to states that don't get a slot are stored as events */
+	if (uxStateMachineAggregationCount < (TraceUnsignedBaseType_t)(TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS))
+	{
+		axStateMachineAggregation[uxStateMachineAggregationCount].xStateHandle = (TraceStateMachineStateHandle_t)xObjectHandle;
+		uxStateMachineAggregationCount++;
+
+		/* Stored as index + 1 since 0 means no slot */
+		xResult = xTraceEntrySetState((TraceEntryHandle_t)xObjectHandle, TRC_STATE_MACHINE_AGGREGATION_INDEX, uxStateMachineAggregationCount);
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xResult == TRC_SUCCESS);
+#endif
+
 	*pxStateHandle = (TraceStateMachineHandle_t)xObjectHandle;
 
 	return TRC_SUCCESS;
@@ -64,6 +96,13 @@ traceResult xTraceStateMachineStateCreate(TraceStateMachineHandle_t xStateMachin
 
 traceResult xTraceStateMachineSetState(TraceStateMachineHandle_t xStateMachineHandle, TraceStateMachineStateHandle_t xStateHandle)
 {
+#if (TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS > 0)
+	TraceUnsignedBaseType_t uxPreviousState, uxSlot;
+	uint32_t uiTimestamp = 0u;
+	traceResult xTimestampResult, xStateResult;
+	TRACE_ALLOC_CRITICAL_SECTION();
+#endif
+
 	/* This should never fail */
 	TRC_ASSERT(xStateMachineHandle != 0);
 
@@ -74,12 +113,112 @@ traceResult xTraceStateMachineSetState(TraceStateMachineHandle_t xStateMachineHa
 	/* This should never fail */
 	TRC_ASSERT(xStateMachineHandle == (TraceStateMachineHandle_t)xTraceEntryGetStateReturn((TraceEntryHandle_t)xStateHandle, TRC_STATE_MACHINE_INDEX));
 
+#if (TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS > 0)
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xTraceTimestampGet(&uiTimestamp) == TRC_SUCCESS);
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	/* Add the time spent in the previous state */
+	uxPreviousState = xTraceEntryGetStateReturn((TraceEntryHandle_t)xStateMachineHandle, TRC_STATE_MACHINE_STATE_INDEX);
+	if (uxPreviousState != 0u)
+	{
+		uxSlot = xTraceEntryGetStateReturn((TraceEntryHandle_t)uxPreviousState, TRC_STATE_MACHINE_AGGREGATION_INDEX); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion from integer to pointer check*/
+		if (uxSlot != 0u)
+		{
+			axStateMachineAggregation[uxSlot - 1u].uxCount++;
+			axStateMachineAggregation[uxSlot - 1u].uxTotal += (TraceUnsignedBaseType_t)(uiTimestamp - (uint32_t)xTraceEntryGetStateReturn((TraceEntryHandle_t)xStateMachineHandle, TRC_STATE_MACHINE_TIMESTAMP_INDEX));
+		}
+	}
+
+	xTimestampResult = xTraceEntrySetState((TraceEntryHandle_t)xStateMachineHandle, TRC_STATE_MACHINE_TIMESTAMP_INDEX, (TraceUnsignedBaseType_t)uiTimestamp);
+	xStateResult = xTraceEntrySetState((TraceEntryHandle_t)xStateMachineHandle, TRC_STATE_MACHINE_STATE_INDEX, (TraceUnsignedBaseType_t)xStateHandle); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion from pointer to integer check*/
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xTimestampResult == TRC_SUCCESS);
+
+	/* This should never fail */
+	TRC_ASSERT_ALWAYS_EVALUATE(xStateResult == TRC_SUCCESS);
+
+	if ((xTraceEntryGetStateReturn((TraceEntryHandle_t)xStateHandle, TRC_STATE_MACHINE_AGGREGATION_INDEX) != 0u) &&
+		(xTraceEntryGetStateReturn((TraceEntryHandle_t)xStateMachineHandle, TRC_STATE_MACHINE_RAW_EVENTS_INDEX) == 0u))
+	{
+		return TRC_SUCCESS;
+	}
+#else
 	/* This should never fail */
 	TRC_ASSERT_ALWAYS_EVALUATE(xTraceEntrySetState((TraceEntryHandle_t)xStateMachineHandle, TRC_STATE_MACHINE_STATE_INDEX, (TraceUnsignedBaseType_t)xStateHandle) == TRC_SUCCESS); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion from pointer to integer check*/
+#endif
 
 	(void)xTraceEventCreate2(PSF_EVENT_STATEMACHINE_STATECHANGE, (TraceUnsignedBaseType_t)xStateMachineHandle, (TraceUnsignedBaseType_t)xStateHandle); /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 Suppress conversion from pointer to integer check*/
 
 	return TRC_SUCCESS;
 }
 
+#if (TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS > 0)
+
+traceResult xTraceStateMachineReport(void)
+{
+#if (TRC_CFG_INCLUDE_USER_EVENTS == 1)
+	static TraceStringHandle_t xFormat = 0;
+	static TraceStringHandle_t axChannels[TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS] = { 0 };
+	const char* szName;
+	TraceStateMachineAggregation_t xAggregation;
+	TraceUnsignedBaseType_t i;
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	if (xFormat == 0)
+	{
+		if (xTraceStringRegister("Visits: %u Total: %u", &xFormat) == TRC_FAIL)
+		{
+			return TRC_FAIL;
+		}
+	}
+
+	for (i = 0u; i < uxStateMachineAggregationCount; i++)
+	{
+		/* The state name is registered once as User Event channel */
+		if (axChannels[i] == 0)
+		{
+			if ((xTraceEntryGetSymbol((TraceEntryHandle_t)axStateMachineAggregation[i].xStateHandle, &szName) == TRC_FAIL) ||
+				(xTraceStringRegister(szName, &axChannels[i]) == TRC_FAIL))
+			{
+				return TRC_FAIL;
+			}
+		}
+
+		TRACE_ENTER_CRITICAL_SECTION();
+		xAggregation = axStateMachineAggregation[i];
+		axStateMachineAggregation[i].uxCount = 0u;
+		axStateMachineAggregation[i].uxTotal = 0u;
+		TRACE_EXIT_CRITICAL_SECTION();
+
+		if (xAggregation.uxCount != 0u)
+		{
+			(void)xTracePrintF2(axChannels[i], xFormat, xAggregation.uxCount, xAggregation.uxTotal);
+		}
+	}
+#endif
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStateMachineGetAggregation(void** ppvData, TraceUnsignedBaseType_t* puxSize)
+{
+	/* This should never fail */
+	TRC_ASSERT(ppvData != (void*)0);
+
+	/* This should never fail */
+	TRC_ASSERT(puxSize != (void*)0);
+
+	*ppvData = (void*)axStateMachineAggregation;
+	*puxSize = sizeof(axStateMachineAggregation);
+
+	return TRC_SUCCESS;
+}
+
+#endif
+
 #endif
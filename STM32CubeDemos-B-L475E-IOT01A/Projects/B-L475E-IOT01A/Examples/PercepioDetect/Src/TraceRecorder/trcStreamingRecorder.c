@@ -16,6 +16,10 @@
 #define TRC_KERNEL_PORT_HEAP_INIT(__size) 
 #endif
 
+#ifndef TRC_CFG_AGGREGATION_REPORT_PERIOD
+#define TRC_CFG_AGGREGATION_REPORT_PERIOD 1
+#endif
+
 /* Entry symbol length maximum check */
 #if ((TRC_CFG_ENTRY_SYMBOL_MAX_LENGTH) > 28UL)
 #error Maximum entry symbol length is 28!
@@ -452,6 +456,9 @@ traceResult xTraceTzCtrl(void)
 {
 	TraceCommand_t xCommand = { 0 };
 	int32_t iRxBytes;
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0) || (TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS > 0)
+	static TraceUnsignedBaseType_t uxAggregationReportCounter = 0u;
+#endif
 	
 	do
 	{
@@ -487,6 +494,20 @@ traceResult xTraceTzCtrl(void)
 	{
 		(void)xTraceDiagnosticsCheckStatus();
 		(void)xTraceStackMonitorReport();
+		(void)xTraceHeapReport();
+		(void)xTraceCounterFlush();
+		(void)xTraceEventDecimationFlush();
+		(void)xTracePrintArrayBufferFlushExpired();
+
+#if (TRC_CFG_INTERVAL_AGGREGATION_SLOTS > 0) || (TRC_CFG_STATE_MACHINE_AGGREGATION_SLOTS > 0)
+		uxAggregationReportCounter++;
+		if (uxAggregationReportCounter >= (TraceUnsignedBaseType_t)(TRC_CFG_AGGREGATION_REPORT_PERIOD))
+		{
+			uxAggregationReportCounter = 0u;
+			(void)xTraceIntervalReport();
+			(void)xTraceStateMachineReport();
+		}
+#endif
 	}
 
 	return TRC_SUCCESS;
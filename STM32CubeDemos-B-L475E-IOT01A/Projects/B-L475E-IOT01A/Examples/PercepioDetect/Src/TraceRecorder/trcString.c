@@ -18,6 +18,9 @@ traceResult xTraceStringRegister(const char* szString, TraceStringHandle_t *pStr
 	TraceEntryHandle_t xEntryHandle;
 	int32_t i;
 	uint32_t uiLength = 0u;
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+	TRACE_ALLOC_CRITICAL_SECTION();
+#endif
 
 	/* This should never fail */
 	TRC_ASSERT(szString != (void*)0);
@@ -28,6 +31,12 @@ traceResult xTraceStringRegister(const char* szString, TraceStringHandle_t *pStr
 	/* We need to check this */
 	if (xTraceEntryCreate(&xEntryHandle) == TRC_FAIL)
 	{
+#if (TRC_CFG_ENABLE_HEALTH_METRICS == 1)
+		TRACE_ENTER_CRITICAL_SECTION();
+		TRC_HEALTH_METRICS_ADD(uxStringMisses, 1u);
+		TRACE_EXIT_CRITICAL_SECTION();
+#endif
+
 		return TRC_FAIL;
 	}
 
@@ -79,41 +79,42 @@ traceResult xTraceTaskSetPriorityWithoutHandle(void* pvTask, TraceUnsignedBaseTy
 traceResult xTraceTaskSwitch(void *pvTask, TraceUnsignedBaseType_t uxPriority)
 {
 	traceResult xResult = TRC_FAIL;
-#if (TRC_KERNEL_PORT_KERNEL_CAN_SWITCH_TO_SAME_TASK == 1)
-	void* pvCurrent = (void*)0;
-#endif
+	void** ppvCurrentTask;
 
 	TRACE_ALLOC_CRITICAL_SECTION();
-	
-	(void)pvTask;
-	(void)uxPriority;
 
 	if (!xTraceIsRecorderInitialized())
 	{
 		return xResult;
 	}
 
+	/* The core can't change during the task switch, so it is only looked up once */
+	ppvCurrentTask = &pxTraceTaskData->coreTasks[TRC_CFG_GET_CURRENT_CORE()];
+
 	if (!xTraceIsRecorderEnabled())
 	{
 		/* Make sure we store the current task, even while recorder isn't enabled */
-		(void)xTraceTaskSetCurrent(pvTask);
+		*ppvCurrentTask = pvTask;
+
+		return xResult;
+	}
 
+#if (TRC_KERNEL_PORT_KERNEL_CAN_SWITCH_TO_SAME_TASK == 1)
+	/* Only this core writes its current task, so no critical section is needed to check it */
+	if (*ppvCurrentTask == pvTask)
+	{
 		return xResult;
 	}
+#endif
 
 	(void)xTraceStateSet(TRC_STATE_IN_TASKSWITCH);
 
 	TRACE_ENTER_CRITICAL_SECTION();
 
-#if (TRC_KERNEL_PORT_KERNEL_CAN_SWITCH_TO_SAME_TASK == 1)
-	(void)xTraceTaskGetCurrent(&pvCurrent);
-	if (pvCurrent != pvTask)
-#endif
-	{
-		(void)xTraceTaskSetCurrent(pvTask);
+	*ppvCurrentTask = pvTask;
 
-		xResult = xTraceEventCreate2(PSF_EVENT_TASK_ACTIVATE, (TraceUnsignedBaseType_t)pvTask, uxPriority);  /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 !MISRAC2012-Rule-11.6 Suppress conversion from pointer to integer check*/
-	}
+	/* Written directly, we are already in a critical section */
+	xResult = xTraceEventCreate2InCriticalSection(PSF_EVENT_TASK_ACTIVATE, (TraceUnsignedBaseType_t)pvTask, uxPriority);  /*cstat !MISRAC2004-11.3 !MISRAC2012-Rule-11.4 !MISRAC2012-Rule-11.6 Suppress conversion from pointer to integer check*/
 
 	(void)xTraceStateSet(TRC_STATE_IN_APPLICATION);
 
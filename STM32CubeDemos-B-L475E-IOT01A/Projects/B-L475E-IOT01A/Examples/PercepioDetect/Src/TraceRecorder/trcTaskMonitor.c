@@ -19,6 +19,13 @@
 
 TraceTaskMonitorData_t* pxTraceTaskMonitorData TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
+static void prvTraceTaskMonitorCheck(TraceTaskMonitorTaskData_t* pxData, TraceUnsignedBaseType_t uxCPULoad);
+
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+static void prvTraceTaskMonitorSetWindowTicks(void);
+static void prvTraceTaskMonitorWindowUpdate(TraceTaskMonitorTaskData_t* pxData, uint32_t uiTimestamp);
+#endif
+
 traceResult xTraceTaskMonitorInitialize(TraceTaskMonitorData_t *pxBuffer)
 {
 	TraceUnsignedBaseType_t i;
@@ -38,6 +45,12 @@ traceResult xTraceTaskMonitorInitialize(TraceTaskMonitorData_t *pxBuffer)
 
 	pxTraceTaskMonitorData->xCallback = (void*)0;
 
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+	/* Set on register since the timestamp frequency might not be known yet */
+	pxTraceTaskMonitorData->uiWindowTicks = 0;
+	pxTraceTaskMonitorData->reserved = 0;
+#endif
+
 	for (i = 0; i < TRC_CFG_TASK_MONITOR_MAX_TASKS; i++)
 	{
 		pxTraceTaskMonitorData->xMonitoredTasks[i].xTaskHandle = 0;
@@ -46,6 +59,10 @@ traceResult xTraceTaskMonitorInitialize(TraceTaskMonitorData_t *pxBuffer)
 		pxTraceTaskMonitorData->xMonitoredTasks[i].uxHigh = 0;
                 pxTraceTaskMonitorData->xMonitoredTasks[i].uxWatermarkHigh = 0;
                 pxTraceTaskMonitorData->xMonitoredTasks[i].uxWatermarkLow = 100;
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+		pxTraceTaskMonitorData->xMonitoredTasks[i].uiWindowStart = 0;
+		pxTraceTaskMonitorData->xMonitoredTasks[i].uiWindowReported = 0;
+#endif
 	}
 
 	for (i = 0; i < TRC_CFG_TASK_MONITOR_MAX_TASKS; i++)
@@ -81,6 +98,9 @@ traceResult xTraceTaskMonitorRegister(void* pvTask, TraceUnsignedBaseType_t uxLo
 {
 	TraceTaskMonitorTaskData_t* pxData;
 	TraceEntryHandle_t xEntryHandle;
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+	uint32_t uiTimestamp = 0;
+#endif
 	TRACE_ALLOC_CRITICAL_SECTION();
 
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_TASK_MONITOR));
@@ -95,6 +115,13 @@ traceResult xTraceTaskMonitorRegister(void* pvTask, TraceUnsignedBaseType_t uxLo
 		}
 	}
 
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+	prvTraceTaskMonitorSetWindowTicks();
+
+	/* This shouldn't fail */
+	(void)xTraceTimestampGet(&uiTimestamp);
+#endif
+
 	TRACE_ENTER_CRITICAL_SECTION();
 
 	if (xTraceTaskMonitorGetEmptySlot(&pxData) == TRC_FAIL)
@@ -120,6 +147,11 @@ traceResult xTraceTaskMonitorRegister(void* pvTask, TraceUnsignedBaseType_t uxLo
 	pxData->xTaskHandle = (TraceTaskHandle_t)xEntryHandle;
         pxData->uxWatermarkHigh = 0;
         pxData->uxWatermarkLow = 100;
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+	pxData->uxTotal = 0;
+	pxData->uiWindowStart = uiTimestamp;
+	pxData->uiWindowReported = 0;
+#endif
 	
 	TRACE_EXIT_CRITICAL_SECTION();
 
@@ -245,18 +277,119 @@ traceResult xTraceTaskMonitorSwitchOut(void* pvTask)
 	/* An actively monitored task */
 	pxData->uxTotal += uiTimestampDiff;
 
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+	/* A failure is only latched in xCallbackData here, nothing may be called from
+	 * the task switch. xTraceTaskMonitorPoll() calls the callback with it. */
+	prvTraceTaskMonitorWindowUpdate(pxData, uiLastTimestamp);
+#endif
+
 	return TRC_SUCCESS;
 }
 
+/* Checks a task's load against its limits. Only the first failing task is stored for the callback. */
+static void prvTraceTaskMonitorCheck(TraceTaskMonitorTaskData_t* pxData, TraceUnsignedBaseType_t uxCPULoad)
+{
+	TraceUnsignedBaseType_t j;
+	const char* szName;
+
+	if ((uxCPULoad < pxData->uxLow) || (uxCPULoad > pxData->uxHigh))
+	{
+		/* This task is outside the expected range... Also check the watermark range (if worse cases has already been reported) */
+		if ((uxCPULoad < pxData->uxWatermarkLow) || (uxCPULoad > pxData->uxWatermarkHigh))
+		{
+			/* This task is outside the expected range and also outside the watermark range, so report it! */
+
+			/* Only report the first failure (other tasks might also be outside the expected range, but avoid spamming the callback) */
+			if (pxTraceTaskMonitorData->xCallbackData.uxNumberOfFailedTasks == 0)
+			{
+				/* Store the failed task's callback data. This data will be used after critical section has ended to call the callback. */
+				pxTraceTaskMonitorData->xCallbackData.uxCPULoad = uxCPULoad;
+				(void)xTraceTaskGetAddress(pxData->xTaskHandle, &pxTraceTaskMonitorData->xCallbackData.pvTaskAddress);
+				(void)xTraceTaskGetName(pxData->xTaskHandle, &szName);
+				for (j = 0; j < TRC_ENTRY_TABLE_SLOT_SYMBOL_SIZE; j++)
+				{
+					pxTraceTaskMonitorData->xCallbackData.acName[j] = szName[j];
+					if (szName[j] == 0) break;
+				}
+				pxTraceTaskMonitorData->xCallbackData.uxLowLimit = pxData->uxLow;
+				pxTraceTaskMonitorData->xCallbackData.uxHighLimit = pxData->uxHigh;
+			}
+
+			pxTraceTaskMonitorData->xCallbackData.uxNumberOfFailedTasks++;
+		}
+	}
+
+	if (uxCPULoad > pxData->uxWatermarkHigh)
+	{
+		/* Always keep track of high watermark, even if within the expected range. */
+		pxData->uxWatermarkHigh = uxCPULoad;
+	}
+
+	if (uxCPULoad < pxData->uxWatermarkLow)
+	{
+		/* Always keep track of low watermark, even if within the expected range. */
+		pxData->uxWatermarkLow = uxCPULoad;
+	}
+}
+
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+
+static void prvTraceTaskMonitorSetWindowTicks(void)
+{
+	TraceUnsignedBaseType_t uxFrequency = 0;
+
+	(void)xTraceTimestampGetFrequency(&uxFrequency);
+
+	pxTraceTaskMonitorData->uiWindowTicks = (uint32_t)(uxFrequency / 1000UL) * (uint32_t)(TRC_CFG_TASK_MONITOR_WINDOW_MS);
+}
+
+/* Ends the task's window if it has lasted at least TRC_CFG_TASK_MONITOR_WINDOW_MS and checks
+ * its load over the window. Before that, the task is reported as soon as its runtime in the
+ * window exceeds the high limit of a whole window, since no later switch can lower that. */
+static void prvTraceTaskMonitorWindowUpdate(TraceTaskMonitorTaskData_t* pxData, uint32_t uiTimestamp)
+{
+	uint32_t uiElapsed = uiTimestamp - pxData->uiWindowStart;
+	uint32_t uiTicksPerPercent = pxTraceTaskMonitorData->uiWindowTicks / 100UL;
+
+	if (uiTicksPerPercent == 0u)
+	{
+		/* Timestamp frequency not known yet */
+		return;
+	}
+
+	if (uiElapsed >= pxTraceTaskMonitorData->uiWindowTicks)
+	{
+		if (pxData->uiWindowReported == 0u)
+		{
+			prvTraceTaskMonitorCheck(pxData, pxData->uxTotal / (uiElapsed / 100UL));
+		}
+
+		pxData->uxTotal = 0;
+		pxData->uiWindowStart = uiTimestamp;
+		pxData->uiWindowReported = 0;
+	}
+	else if ((pxData->uiWindowReported == 0u) && (pxData->uxTotal > (uiTicksPerPercent * pxData->uxHigh)))
+	{
+		pxData->uiWindowReported = 1;
+
+		prvTraceTaskMonitorCheck(pxData, pxData->uxTotal / uiTicksPerPercent);
+	}
+}
+
+#endif
+
 volatile int was_alert = 0;
 
 traceResult xTraceTaskMonitorPoll(void)
 {
 	TraceUnsignedBaseType_t i, j;
-	TraceUnsignedBaseType_t uxCPULoad;
 	uint32_t uiLastTimestamp;
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS == 0)
+	TraceUnsignedBaseType_t uxCPULoad;
 	uint32_t uiElapsedTime;
-	const char* szName;
+#else
+	TraceTaskMonitorCallbackData_t xLatchedData;
+#endif
 	TRACE_ALLOC_CRITICAL_SECTION();
 
 	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_TASK_MONITOR));
@@ -271,10 +404,12 @@ traceResult xTraceTaskMonitorPoll(void)
 
 	(void)xTraceTimestampGet(&uiLastTimestamp);
 
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS == 0)
 	uiElapsedTime = uiLastTimestamp - pxTraceTaskMonitorData->uiPollTimestamp;
 
 	pxTraceTaskMonitorData->xCallbackData.uxNumberOfFailedTasks = 0;
 	pxTraceTaskMonitorData->xCallbackData.pvTaskAddress = (void*)0;
+#endif
 
 	TRACE_ENTER_CRITICAL_SECTION();
 	for (i = 0; i < TRC_CFG_TASK_MONITOR_MAX_TASKS; i++)
@@ -299,49 +434,15 @@ traceResult xTraceTaskMonitorPoll(void)
 			}
 		}
 
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+		/* The load is checked on switch out, this only catches tasks that haven't been switched out during a whole window */
+		prvTraceTaskMonitorWindowUpdate(&pxTraceTaskMonitorData->xMonitoredTasks[i], uiLastTimestamp);
+#else
 		uxCPULoad = (pxTraceTaskMonitorData->xMonitoredTasks[i].uxTotal * 100UL) / uiElapsedTime;
 		pxTraceTaskMonitorData->xMonitoredTasks[i].uxTotal = 0;
-                                
-		if ((uxCPULoad < pxTraceTaskMonitorData->xMonitoredTasks[i].uxLow) || (uxCPULoad > pxTraceTaskMonitorData->xMonitoredTasks[i].uxHigh))
-		{
-			/* This task is outside the expected range... Also check the watermark range (if worse cases has already been reported) */
-                
-                        if ((uxCPULoad < pxTraceTaskMonitorData->xMonitoredTasks[i].uxWatermarkLow) || (uxCPULoad > pxTraceTaskMonitorData->xMonitoredTasks[i].uxWatermarkHigh))
-                        {
-                                /* This task is outside the expected range and also outside the watermark range, so report it! */
-                  
-                                /* Only report the first failure (other tasks might also be outside the expected range, but avoid spamming the callback) */
-                                if (pxTraceTaskMonitorData->xCallbackData.uxNumberOfFailedTasks == 0)
-                                {                                       
-                                      /* Store the failed task's callback data. This data will be used after critical section has ended to call the callback. */
-                                      pxTraceTaskMonitorData->xCallbackData.uxCPULoad = uxCPULoad;
-                                      (void)xTraceTaskGetAddress(pxTraceTaskMonitorData->xMonitoredTasks[i].xTaskHandle, &pxTraceTaskMonitorData->xCallbackData.pvTaskAddress);
-                                      (void)xTraceTaskGetName(pxTraceTaskMonitorData->xMonitoredTasks[i].xTaskHandle, &szName);
-                                      for (j = 0; j < TRC_ENTRY_TABLE_SLOT_SYMBOL_SIZE; j++)
-                                      {
-                                              pxTraceTaskMonitorData->xCallbackData.acName[j] = szName[j];
-                                              if (szName[j] == 0) break;
-                                      }
-                                      pxTraceTaskMonitorData->xCallbackData.uxLowLimit = pxTraceTaskMonitorData->xMonitoredTasks[i].uxLow;
-                                      pxTraceTaskMonitorData->xCallbackData.uxHighLimit = pxTraceTaskMonitorData->xMonitoredTasks[i].uxHigh;
-                                }
-                                
-                                pxTraceTaskMonitorData->xCallbackData.uxNumberOfFailedTasks++;
-
-                        }
-                }
-                
-                if (uxCPULoad > pxTraceTaskMonitorData->xMonitoredTasks[i].uxWatermarkHigh)
-                {
-                        /* Always keep track of high watermark, even if within the expected range. */
-                        pxTraceTaskMonitorData->xMonitoredTasks[i].uxWatermarkHigh = uxCPULoad;
-                }
-                
-                if (uxCPULoad < pxTraceTaskMonitorData->xMonitoredTasks[i].uxWatermarkLow)
-                {
-                        /* Always keep track of low watermark, even if within the expected range. */
-                        pxTraceTaskMonitorData->xMonitoredTasks[i].uxWatermarkLow = uxCPULoad;
-                }
+
+		prvTraceTaskMonitorCheck(&pxTraceTaskMonitorData->xMonitoredTasks[i], uxCPULoad);
+#endif
 	}
 
         for (j = 0; j < TRC_CFG_CORE_COUNT; j++)
@@ -349,13 +450,25 @@ traceResult xTraceTaskMonitorPoll(void)
                 pxTraceTaskMonitorData->uiLastTimestamp[j] = uiLastTimestamp;
         }
         pxTraceTaskMonitorData->uiPollTimestamp = uiLastTimestamp;
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+	/* Take the failure latched since the last poll, task switches may latch a new one during the callback */
+	xLatchedData = pxTraceTaskMonitorData->xCallbackData;
+	pxTraceTaskMonitorData->xCallbackData.uxNumberOfFailedTasks = 0;
+#endif
         TRACE_EXIT_CRITICAL_SECTION();
         
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+	if (xLatchedData.uxNumberOfFailedTasks > 0)
+	{
+		pxTraceTaskMonitorData->xCallback(&xLatchedData);
+	}
+#else
 	/* Check if callback should be performed */
 	if (pxTraceTaskMonitorData->xCallbackData.uxNumberOfFailedTasks > 0)
 	{           
            pxTraceTaskMonitorData->xCallback(&pxTraceTaskMonitorData->xCallbackData);
 	}
+#endif
         
 
 	return TRC_SUCCESS;
@@ -372,11 +485,19 @@ traceResult xTraceTaskMonitorPollReset(void)
 	/* This shouldn't fail */
 	(void)xTraceTimestampGet(&uiLastTimestamp);
 
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+	prvTraceTaskMonitorSetWindowTicks();
+#endif
+
 	TRACE_ENTER_CRITICAL_SECTION();
 	
 	for (i = 0; i < TRC_CFG_TASK_MONITOR_MAX_TASKS; i++)
 	{
 		pxTraceTaskMonitorData->xMonitoredTasks[i].uxTotal = 0;
+#if (TRC_CFG_TASK_MONITOR_WINDOW_MS > 0)
+		pxTraceTaskMonitorData->xMonitoredTasks[i].uiWindowStart = uiLastTimestamp;
+		pxTraceTaskMonitorData->xMonitoredTasks[i].uiWindowReported = 0;
+#endif
 	}
 
 	for (i = 0; i < TRC_CFG_CORE_COUNT; i++)
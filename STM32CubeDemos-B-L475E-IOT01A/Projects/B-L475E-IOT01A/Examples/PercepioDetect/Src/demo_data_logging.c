@@ -28,7 +28,8 @@
 void vTaskAccelerometer(void *pvParameters)
 {
     (void) pvParameters;
-    TraceStringHandle_t AccZ_chn, log_chn, counter_chn, format_string;
+    TraceStringHandle_t AccZ_chn, AccXYZ_chn, log_chn, counter_chn, format_string;
+    static TracePrintArrayBuffer_t AccXYZ_buffer;
     int counter = 1;
     
     int16_t pDataXYZ[3] = {0};
@@ -40,12 +41,16 @@ void vTaskAccelerometer(void *pvParameters)
        logging calls. Here we register the channel names and get the handles
        in return, used in the later logging calls. */
     xTraceStringRegister("AccZ channel", &AccZ_chn);
+    xTraceStringRegister("AccXYZ channel", &AccXYZ_chn);
     xTraceStringRegister("Log channel", &log_chn);
     xTraceStringRegister("Counter channel", &counter_chn);
     
     /* Registers the format string for xTracePrintF1 (see below). */ 
     xTraceStringRegister("%d", &format_string);
     
+    /* Collects the XYZ samples for xTracePrintArray (see below). */
+    xTracePrintArrayBufferInitialize(&AccXYZ_buffer, AccXYZ_chn, TRC_PRINT_ARRAY_TYPE_INT16);
+    
     for (;;)
     {
         /* Reads accelerometer data */
@@ -54,8 +59,19 @@ void vTaskAccelerometer(void *pvParameters)
         /* xTracePrintF allows for storing multiple data arguments with
         a printf-like interface, supporting integers and strings.
         This is a lot faster than printf calls, since not doing string
-        formatting in runtime and not limited by slow UART baud rates. */
-        xTracePrintF(AccZ_chn, "%d", pDataXYZ[2]);
+        formatting in runtime and not limited by slow UART baud rates.
+        xTracePrintFCached is the same thing for high rate logging. The number
+        of arguments is known at compile time and the format string is only
+        registered on the first call, so nothing is parsed in runtime. */
+        xTracePrintFCached(AccZ_chn, "%d", pDataXYZ[2]);
+        
+        /* xTracePrintArray stores many samples in a single event, which saves
+           most of the per-event overhead when logging all three axes at high
+           rates. The buffer collects samples and stores them when full, or
+           after TRC_CFG_PRINT_ARRAY_FLUSH_TICKS. These events are not shown
+           by Tracealyzer, extract them with
+           TraceRecorder/tools/print_array_decoder.py. */
+        xTracePrintArrayBufferAdd(&AccXYZ_buffer, pDataXYZ, 3);
         
         if (counter % 3 == 0)
         {
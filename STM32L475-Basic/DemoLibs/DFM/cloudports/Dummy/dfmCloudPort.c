@@ -34,4 +34,12 @@ DfmResult_t xDfmCloudPortSendPayloadChunk(DfmEntryHandle_t xEntryHandle)
 	return DFM_FAIL;
 }
 
+DfmResult_t xDfmCloudPortSendBatch(void* pvData, uint32_t ulSize)
+{
+	(void)pvData;
+	(void)ulSize;
+
+	return DFM_FAIL;
+}
+
 #endif
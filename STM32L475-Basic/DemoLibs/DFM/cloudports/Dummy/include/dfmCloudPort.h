@@ -69,6 +69,20 @@ DfmResult_t xDfmCloudPortSendAlert(DfmEntryHandle_t xEntryHandle);
  */
 DfmResult_t xDfmCloudPortSendPayloadChunk(DfmEntryHandle_t xEntryHandle);
 
+/* This port can send batches, see DFM_CFG_CLOUD_BATCH_SIZE */
+#define DFM_CLOUD_PORT_SEND_BATCH
+
+/**
+ * @brief Send a batch of Entries as one transfer, only used if DFM_CFG_CLOUD_BATCH_SIZE is set
+ *
+ * @param[in] pvData Batch data.
+ * @param[in] ulSize Batch size.
+ *
+ * @retval DFM_FAIL Failure
+ * @retval DFM_SUCCESS Success
+ */
+DfmResult_t xDfmCloudPortSendBatch(void* pvData, uint32_t ulSize);
+
 /** @} */
 
 #ifdef __cplusplus
@@ -26,6 +26,7 @@ extern void vMainUARTPrintString( char * pcString );
 static DfmCloudPortData_t *pxCloudPortData = (void*)0;
 
 static uint32_t prvPrintDataAsHex(uint8_t* data, int size);
+static DfmResult_t prvSerialPortUploadData(uint8_t* pucData, uint32_t datalen);
 static DfmResult_t prvSerialPortUploadEntry(DfmEntryHandle_t xEntryHandle);
 
 static uint32_t prvPrintDataAsHex(uint8_t* data, int size)
@@ -68,9 +69,6 @@ static DfmResult_t prvSerialPortUploadEntry(DfmEntryHandle_t xEntryHandle)
 {
 	uint32_t datalen;
 
-	if (pxCloudPortData == (void*)0)
-		return DFM_FAIL;
-
 	if (xEntryHandle == 0)
 		return DFM_FAIL;
 
@@ -80,11 +78,21 @@ static DfmResult_t prvSerialPortUploadEntry(DfmEntryHandle_t xEntryHandle)
 	if (datalen > 0xFFFF)
 		return DFM_FAIL;
 
+	return prvSerialPortUploadData((uint8_t*)xEntryHandle, datalen);
+}
+
+/* Prints a block of data between the Begins and Ended markers, the receiver script
+ * tells an entry from a batch of entries by the start markers in the data */
+static DfmResult_t prvSerialPortUploadData(uint8_t* pucData, uint32_t datalen)
+{
+	if (pxCloudPortData == (void*)0)
+		return DFM_FAIL;
+
 	DFM_CFG_LOCK_SERIAL();
 	DFM_PRINT_SERIAL_DATA("\n[[ DevAlert Data Begins ]]\n");
 	DFM_CFG_UNLOCK_SERIAL();
 
-	(void) prvPrintDataAsHex((uint8_t*)xEntryHandle, datalen);
+	(void) prvPrintDataAsHex(pucData, datalen);
 
     // Checksum not provided (0) since not updated for the new Receiver script (uses a different checksum algorithm). If 0, checksum is ignore.
 	snprintf(pxCloudPortData->buf, sizeof(pxCloudPortData->buf), "[[ DevAlert Data Ended. Checksum: %d ]]\n", (unsigned int)0);
@@ -113,4 +121,12 @@ DfmResult_t xDfmCloudPortSendPayloadChunk(DfmEntryHandle_t xEntryHandle)
 	return prvSerialPortUploadEntry(xEntryHandle);
 }
 
+DfmResult_t xDfmCloudPortSendBatch(void* pvData, uint32_t ulSize)
+{
+	if (pvData == (void*)0)
+		return DFM_FAIL;
+
+	return prvSerialPortUploadData((uint8_t*)pvData, ulSize);
+}
+
 #endif
@@ -95,6 +95,16 @@ extern void vMainUARTPrintString( char * pcString );
  */
 #define DFM_CFG_DELAY_BETWEEN_SEND (0)
 
+/**
+ * @brief The size of the batch buffer, 0 disables batching. The alert and payload entries of an
+ * alert that fit are collected in the batch and sent as one transfer at the end of xDfmAlertEnd(),
+ * e.g. one block of serial data. Set this to the largest transfer (MTU) of the cloud port. Larger
+ * entries are sent on their own. If the batch can't be sent it is dropped and the alert is stored
+ * instead. Only used with cloud ports that define DFM_CLOUD_PORT_SEND_BATCH, others (e.g. AWS MQTT,
+ * whose backend doesn't decode batches) send the entries one by one.
+ */
+#define DFM_CFG_CLOUD_BATCH_SIZE (1024)
+
 /**
  * @brief Enables the Retained Memory feature. Requires a RetainedMemoryPort to be implemented for the kernel/hardware.
  */
@@ -532,12 +532,20 @@ DfmResult_t xDfmAlertEndCustom(DfmAlertHandle_t xAlertHandle, uint32_t ulEndType
 
 	if ((ulEndType & DFM_ALERT_END_TYPE_SEND) > 0)
 	{
-		/* Try to send */
+		/* Try to send. Batched entries are only sent once the batch is, otherwise the whole alert is stored. */
+		(void)xDfmCloudBatchBegin();
 		if (prvDfmProcessAlert(prvSendAlert, prvSendPayloadChunk) == DFM_SUCCESS)
 		{
-			prvDfmAlertReset(pxAlert);
+			if (xDfmCloudBatchEnd() == DFM_SUCCESS)
+			{
+				prvDfmAlertReset(pxAlert);
 
-			return DFM_SUCCESS;
+				return DFM_SUCCESS;
+			}
+		}
+		else
+		{
+			vDfmCloudBatchDiscard();
 		}
 	}
 
@@ -10,11 +10,18 @@
 
 #include <dfm.h>
 #include <stdio.h> /*cstat !MISRAC2012-Rule-21.6 We require snprintf() in order for the helper function to construct an MQTT topic*/
+#include <string.h>
 
 #if ((DFM_CFG_ENABLED) >= 1)
 
 static DfmCloudData_t* pxCloudData = (void*)0;
 
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+static void prvDfmCloudBatchReset(void);
+static DfmResult_t prvDfmCloudBatchSend(void);
+static DfmResult_t prvDfmCloudBatchAdd(DfmEntryHandle_t xEntryHandle, uint32_t* pulBatched);
+#endif
+
 DfmResult_t xDfmCloudInitialize(DfmCloudData_t* pxBuffer)
 {
 	if (pxBuffer == (void*)0)
@@ -29,6 +36,11 @@ DfmResult_t xDfmCloudInitialize(DfmCloudData_t* pxBuffer)
 
 	pxCloudData = pxBuffer;
 
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+	pxCloudData->ulBatching = 0;
+	prvDfmCloudBatchReset();
+#endif
+
 	pxCloudData->ulInitialized = 1;
 
 	return DFM_SUCCESS;
@@ -37,6 +49,9 @@ DfmResult_t xDfmCloudInitialize(DfmCloudData_t* pxBuffer)
 DfmResult_t xDfmCloudSendAlert(DfmEntryHandle_t xEntryHandle)
 {
 	DfmCloudStrategy_t xCloudStrategy = DFM_CLOUD_STRATEGY_OFFLINE;
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+	uint32_t ulBatched = 0;
+#endif
 
 	if (pxCloudData == (void*)0)
 	{
@@ -68,12 +83,28 @@ DfmResult_t xDfmCloudSendAlert(DfmEntryHandle_t xEntryHandle)
 		return DFM_FAIL;
 	}
 
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+	if (prvDfmCloudBatchAdd(xEntryHandle, &ulBatched) == DFM_FAIL)
+	{
+		/* The batch could not be sent and was dropped, the caller stores the whole alert instead */
+		return DFM_FAIL;
+	}
+
+	if (ulBatched == (uint32_t)1)
+	{
+		return DFM_SUCCESS;
+	}
+#endif
+
 	return xDfmCloudPortSendAlert(xEntryHandle);
 }
 
 DfmResult_t xDfmCloudSendPayloadChunk(DfmEntryHandle_t xEntryHandle)
 {
 	DfmCloudStrategy_t xCloudStrategy = DFM_CLOUD_STRATEGY_OFFLINE;
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+	uint32_t ulBatched = 0;
+#endif
 
 	if (pxCloudData == (void*)0)
 	{
@@ -105,9 +136,80 @@ DfmResult_t xDfmCloudSendPayloadChunk(DfmEntryHandle_t xEntryHandle)
 		return DFM_FAIL;
 	}
 
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+	if (prvDfmCloudBatchAdd(xEntryHandle, &ulBatched) == DFM_FAIL)
+	{
+		/* The batch could not be sent and was dropped, the caller stores the whole alert instead */
+		return DFM_FAIL;
+	}
+
+	if (ulBatched == (uint32_t)1)
+	{
+		return DFM_SUCCESS;
+	}
+#endif
+
 	return xDfmCloudPortSendPayloadChunk(xEntryHandle);
 }
 
+DfmResult_t xDfmCloudBatchBegin(void)
+{
+	if (pxCloudData == (void*)0)
+	{
+		return DFM_FAIL;
+	}
+
+	if (pxCloudData->ulInitialized == (uint32_t)0)
+	{
+		return DFM_FAIL;
+	}
+
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+	prvDfmCloudBatchReset();
+	pxCloudData->ulBatching = 1;
+#endif
+
+	return DFM_SUCCESS;
+}
+
+DfmResult_t xDfmCloudBatchEnd(void)
+{
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+	DfmResult_t xResult;
+
+	if (pxCloudData == (void*)0)
+	{
+		return DFM_FAIL;
+	}
+
+	if (pxCloudData->ulInitialized == (uint32_t)0)
+	{
+		return DFM_FAIL;
+	}
+
+	xResult = prvDfmCloudBatchSend();
+
+	pxCloudData->ulBatching = 0;
+
+	return xResult;
+#else
+	return DFM_SUCCESS;
+#endif
+}
+
+void vDfmCloudBatchDiscard(void)
+{
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+	if ((pxCloudData == (void*)0) || (pxCloudData->ulInitialized == (uint32_t)0))
+	{
+		return;
+	}
+
+	prvDfmCloudBatchReset();
+	pxCloudData->ulBatching = 0;
+#endif
+}
+
 DfmResult_t xDfmCloudGenerateMQTTTopic(char* cTopicBuffer, uint32_t ulBufferSize, const char* szMQTTPrefix, DfmEntryHandle_t xEntryHandle)
 {
 	const char* szSessionId = (void*)0;
@@ -211,4 +313,88 @@ DfmResult_t xDfmCloudGenerateMQTTTopic(char* cTopicBuffer, uint32_t ulBufferSize
 	return DFM_SUCCESS;
 }
 
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+static void prvDfmCloudBatchReset(void)
+{
+	uint16_t usEndianness = 0x0FF0;
+	uint16_t usEntryCount = 0;
+
+	pxCloudData->ucBatchBuffer[0] = DFM_CLOUD_BATCH_START_MARKER_0;
+	pxCloudData->ucBatchBuffer[1] = DFM_CLOUD_BATCH_START_MARKER_1;
+	pxCloudData->ucBatchBuffer[2] = DFM_CLOUD_BATCH_START_MARKER_2;
+	pxCloudData->ucBatchBuffer[3] = DFM_CLOUD_BATCH_START_MARKER_3;
+	(void)memcpy(&pxCloudData->ucBatchBuffer[4], &usEndianness, sizeof(usEndianness));
+	(void)memcpy(&pxCloudData->ucBatchBuffer[6], &usEntryCount, sizeof(usEntryCount));
+
+	pxCloudData->ulBatchSize = DFM_CLOUD_BATCH_HEADER_SIZE;
+}
+
+/* Sends the batch, which is then empty also if the transfer failed */
+static DfmResult_t prvDfmCloudBatchSend(void)
+{
+	DfmResult_t xResult = DFM_SUCCESS;
+
+	if (pxCloudData->ulBatchSize > (uint32_t)DFM_CLOUD_BATCH_HEADER_SIZE)
+	{
+		xResult = xDfmCloudPortSendBatch(pxCloudData->ucBatchBuffer, pxCloudData->ulBatchSize);
+	}
+
+	prvDfmCloudBatchReset();
+
+	return xResult;
+}
+
+/* Adds the entry to the batch if it fits, otherwise sends the batch first. Entries that would not fit in an
+ * empty batch are not added and are sent on their own by the caller, after the batch to keep the order. Fails
+ * if the batch had to be sent and could not be, the batch is then dropped and the entry is not added. */
+static DfmResult_t prvDfmCloudBatchAdd(DfmEntryHandle_t xEntryHandle, uint32_t* pulBatched)
+{
+	uint32_t ulEntrySize = 0;
+	uint16_t usEntrySize;
+	uint16_t usEntryCount;
+
+	*pulBatched = 0;
+
+	if (pxCloudData->ulBatching == (uint32_t)0)
+	{
+		return DFM_SUCCESS;
+	}
+
+	if (xDfmEntryGetSize(xEntryHandle, &ulEntrySize) == DFM_FAIL)
+	{
+		return DFM_FAIL;
+	}
+
+	if ((ulEntrySize > (uint32_t)0xFFFF) ||
+		(ulEntrySize > (uint32_t)(DFM_CFG_CLOUD_BATCH_SIZE) - (uint32_t)DFM_CLOUD_BATCH_HEADER_SIZE - (uint32_t)DFM_CLOUD_BATCH_ENTRY_HEADER_SIZE))
+	{
+		/* Would not fit in an empty batch, send what is batched first to keep the order */
+		return prvDfmCloudBatchSend();
+	}
+
+	if (pxCloudData->ulBatchSize + (uint32_t)DFM_CLOUD_BATCH_ENTRY_HEADER_SIZE + ulEntrySize > (uint32_t)(DFM_CFG_CLOUD_BATCH_SIZE))
+	{
+		if (prvDfmCloudBatchSend() == DFM_FAIL)
+		{
+			return DFM_FAIL;
+		}
+	}
+
+	usEntrySize = (uint16_t)ulEntrySize;
+	(void)memcpy(&pxCloudData->ucBatchBuffer[pxCloudData->ulBatchSize], &usEntrySize, sizeof(usEntrySize));
+	pxCloudData->ulBatchSize += (uint32_t)DFM_CLOUD_BATCH_ENTRY_HEADER_SIZE;
+
+	(void)memcpy(&pxCloudData->ucBatchBuffer[pxCloudData->ulBatchSize], (void*)xEntryHandle, ulEntrySize);
+	pxCloudData->ulBatchSize += ulEntrySize;
+
+	(void)memcpy(&usEntryCount, &pxCloudData->ucBatchBuffer[6], sizeof(usEntryCount));
+	usEntryCount++;
+	(void)memcpy(&pxCloudData->ucBatchBuffer[6], &usEntryCount, sizeof(usEntryCount));
+
+	*pulBatched = 1;
+
+	return DFM_SUCCESS;
+}
+#endif
+
 #endif
@@ -23,6 +23,21 @@ extern "C" {
 
 #if ((DFM_CFG_ENABLED) >= 1)
 
+/* Batching is disabled unless configured, and for cloud ports that can't send batches */
+#if !defined(DFM_CFG_CLOUD_BATCH_SIZE) || !defined(DFM_CLOUD_PORT_SEND_BATCH)
+#undef DFM_CFG_CLOUD_BATCH_SIZE
+#define DFM_CFG_CLOUD_BATCH_SIZE 0
+#endif
+
+/* A batch starts with the markers, the endianness and the entry count, each entry is
+ * preceded by its size (uint16_t) */
+#define DFM_CLOUD_BATCH_START_MARKER_0 0xB1
+#define DFM_CLOUD_BATCH_START_MARKER_1 0xB2
+#define DFM_CLOUD_BATCH_START_MARKER_2 0xB3
+#define DFM_CLOUD_BATCH_START_MARKER_3 0xB4
+#define DFM_CLOUD_BATCH_HEADER_SIZE 8
+#define DFM_CLOUD_BATCH_ENTRY_HEADER_SIZE 2
+
 /**
  * @defgroup dfm_cloud_apis DFM Cloud API
  * @ingroup dfm_apis
@@ -36,6 +51,11 @@ typedef struct DfmCloudData
 {
 	uint32_t ulInitialized;
 	DfmCloudPortData_t xCloudPortData;
+#if ((DFM_CFG_CLOUD_BATCH_SIZE) > 0)
+	uint32_t ulBatching;	/* 1 between xDfmCloudBatchBegin() and xDfmCloudBatchEnd() */
+	uint32_t ulBatchSize;
+	uint8_t ucBatchBuffer[DFM_CFG_CLOUD_BATCH_SIZE];
+#endif
 } DfmCloudData_t;
 
 /**
@@ -49,7 +69,8 @@ typedef struct DfmCloudData
 DfmResult_t xDfmCloudInitialize(DfmCloudData_t* pxBuffer);
 
 /**
- * @brief Send an Alert
+ * @brief Send an Alert. Between xDfmCloudBatchBegin() and xDfmCloudBatchEnd(), the entry is added
+ * to the batch when it fits, and has only been sent once xDfmCloudBatchEnd() succeeds.
  *
  * @param[in] xEntryHandle Entry handle.
  *
@@ -59,7 +80,7 @@ DfmResult_t xDfmCloudInitialize(DfmCloudData_t* pxBuffer);
 DfmResult_t xDfmCloudSendAlert(DfmEntryHandle_t xEntryHandle);
 
 /**
- * @brief Send a Payload chunk
+ * @brief Send a Payload chunk. Batched the same way as alerts.
  *
  * @param[in] xEntryHandle Entry handle.
  *
@@ -68,6 +89,34 @@ DfmResult_t xDfmCloudSendAlert(DfmEntryHandle_t xEntryHandle);
  */
 DfmResult_t xDfmCloudSendPayloadChunk(DfmEntryHandle_t xEntryHandle);
 
+/**
+ * @brief Start collecting the entries of one Alert in a batch, if DFM_CFG_CLOUD_BATCH_SIZE
+ * is used. Entries sent until xDfmCloudBatchEnd() or xDfmCloudBatchDiscard() are sent
+ * together. Entries that don't fit in the batch are sent on their own, after the entries
+ * batched before them. If sending a full batch fails, the batch is dropped and the entry
+ * fails to send.
+ *
+ * @retval DFM_FAIL Failure
+ * @retval DFM_SUCCESS Success
+ */
+DfmResult_t xDfmCloudBatchBegin(void);
+
+/**
+ * @brief Send the entries collected since xDfmCloudBatchBegin() as one transfer and stop
+ * batching. The batch is dropped if the transfer fails, so the Alert has to be sent again
+ * or stored as a whole.
+ *
+ * @retval DFM_FAIL Failure, the batched entries were not sent
+ * @retval DFM_SUCCESS Success, or nothing was batched
+ */
+DfmResult_t xDfmCloudBatchEnd(void);
+
+/**
+ * @brief Drop the entries collected since xDfmCloudBatchBegin() and stop batching. Used
+ * when the Alert could not be sent in full.
+ */
+void vDfmCloudBatchDiscard(void);
+
 /**
  * @brief Helper function used by MQTT Cloud ports that generates a Topic from an Entry handle
  *
@@ -88,6 +137,9 @@ DfmResult_t xDfmCloudGenerateMQTTTopic(char* cTopicBuffer, uint32_t ulBufferSize
 /* Dummy defines */
 #define xDfmCloudSendAlert(xEntryHandle) (DFM_FAIL)
 #define xDfmCloudSendPayloadChunk(xEntryHandle) (DFM_FAIL)
+#define xDfmCloudBatchBegin() (DFM_FAIL)
+#define xDfmCloudBatchEnd() (DFM_FAIL)
+#define vDfmCloudBatchDiscard()
 #define xDfmCloudGenerateMQTTTopic(cTopicBuffer, ulBufferSize, xEntryHandle) (DFM_FAIL)
 
 #endif
@@ -23,6 +23,7 @@
 /* Alert Types */
 /* The following Alert Types are published and will not change. */
 
+#define DFM_TYPE_STACK_OVERFLOW (10) /* Stack overflow, or stack margin below the monitor threshold (9 is STACK_CHK_FAILED in other demos) */
 #define DFM_TYPE_STOPWATCH (8) /* Stopwatch exceeded the expected duration */
 #define DFM_TYPE_HEARTBEAT (7) /* Heartbeat failure */
 #define DFM_TYPE_BAD_MESSAGE (6) /* Invalid/bad message received */
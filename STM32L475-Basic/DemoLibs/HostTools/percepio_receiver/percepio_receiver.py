@@ -3,6 +3,7 @@
 import argparse
 import os
 import re
+import struct
 import sys
 import time
 from binascii import unhexlify
@@ -11,6 +12,10 @@ from typing import Tuple
 from DevAlertCommon import DfmEntryParser, DfmEntryParserException
 from pathlib import Path
 
+BATCH_START_MARKERS = bytes([0xB1, 0xB2, 0xB3, 0xB4])
+BATCH_HEADER_SIZE = 8
+
+
 class ChunkResultType(enum.Enum):
     Start = enum.auto()
     Data = enum.auto()
@@ -110,6 +115,80 @@ class LineParser:
                     self.parsing = False
                 return False
 
+
+def split_batch(payload: bytes) -> list:
+    """
+    Returns the entries in a batch sent by the DFM cloud batching, or the payload itself if it is a single entry.
+    A batch starts with 0xB1 0xB2 0xB3 0xB4, the endianness (uint16) and the entry count (uint16),
+    followed by the entries, each preceded by its size (uint16).
+    """
+    if len(payload) < BATCH_HEADER_SIZE or payload[0:4] != BATCH_START_MARKERS:
+        return [payload]
+
+    endian_char = "<" if (payload[4] | payload[5] << 8) == 0x0FF0 else ">"
+    entry_count, = struct.unpack_from("{}H".format(endian_char), payload, 6)
+    entries = []
+    offset = BATCH_HEADER_SIZE
+    for _ in range(entry_count):
+        if offset + 2 > len(payload):
+            info_log("Got truncated batch, {} of {} entries".format(len(entries), entry_count))
+            break
+        entry_size, = struct.unpack_from("{}H".format(endian_char), payload, offset)
+        offset += 2
+        if offset + entry_size > len(payload):
+            info_log("Got truncated batch, {} of {} entries".format(len(entries), entry_count))
+            break
+        entries.append(payload[offset:offset + entry_size])
+        offset += entry_size
+
+    return entries
+
+
+def process_entry(entry: bytes, args, binary_name_s3: str):
+    """
+    Stores or uploads one DFM entry
+    """
+    if args.upload == "file":
+
+        # This is for generating raw alert files, intended for the local server.
+        # Note: Not compatible with the DevAlert upload tools.
+
+        parsed_payload: bytes
+        try:
+            parsed_payload = DfmEntryParser.get_entry_data(entry)
+        except DfmEntryParserException as e:
+            info_log("Got DfmParserException: {}".format(e))
+            return
+
+        topic = DfmEntryParser.get_topic(entry)
+        file_path = args.folder + "/" + topic
+
+        folder = str(Path(file_path).parent.resolve())
+
+        Path(folder).mkdir(parents=True, exist_ok=True)
+
+        info_log("Generating " + file_path)
+
+        with open(file_path, 'wb') as dump_fh:
+            dump_fh.write(parsed_payload)
+
+    else:
+        # Try to parse the payload to generate a proper devalerts3/devalerthttps payload
+        parsed_payload: bytes
+        try:
+            parsed_payload = DfmEntryParser.parse(entry)
+        except DfmEntryParserException as e:
+            info_log("Got DfmParserException: {}".format(e))
+            return
+
+        if args.upload == "s3":
+            with open('{}/dumpfile.bin'.format(args.folder), 'wb') as dump_fh:
+                dump_fh.write(parsed_payload)
+            os.system('./{} store-trace --file {}/dumpfile.bin'.format(binary_name_s3, args.folder))
+        else:
+            os.write(sys.stdout.fileno(), parsed_payload)
+
+
 from argparse import RawTextHelpFormatter
 
 if __name__ == "__main__":
@@ -187,45 +266,8 @@ if __name__ == "__main__":
                                continue
 
                         
-                        if args.upload == "file":      
-
-                            # This is for generating raw alert files, intended for the local server. 
-                            # Note: Not compatible with the DevAlert upload tools.
-
-                            parsed_payload: bytes
-                            try:
-                                parsed_payload = DfmEntryParser.get_entry_data(accumulated_payload)
-                            except DfmEntryParserException as e:
-                                info_log("Got DfmParserException: {}".format(e))
-                                continue
-						                        
-                            topic = DfmEntryParser.get_topic(accumulated_payload)
-                            file_path = args.folder + "/" + topic;
-                            
-                            folder = str(Path(file_path).parent.resolve())
-                            
-                            Path(folder).mkdir(parents=True, exist_ok=True)
-
-                            info_log("Generating " + file_path)
-                                                    
-                            with open(file_path, 'wb') as dump_fh:
-                               dump_fh.write(parsed_payload)
-
-                        else:
-                            # Try to parse the payload to generate a proper devalerts3/devalerthttps payload
-                            parsed_payload: bytes
-                            try:
-                                parsed_payload = DfmEntryParser.parse(accumulated_payload)
-                            except DfmEntryParserException as e:
-                                info_log("Got DfmParserException: {}".format(e))
-                                continue
-						    
-                            if args.upload == "s3":
-                                with open('{}/dumpfile.bin'.format(args.folder), 'wb') as dump_fh:
-                                    dump_fh.write(parsed_payload)
-                                os.system('./{} store-trace --file {}/dumpfile.bin'.format(binary_name_s3, args.folder))
-                            else:
-                                os.write(sys.stdout.fileno(), parsed_payload)
+                        for entry in split_batch(accumulated_payload):
+                            process_entry(entry, args, binary_name_s3)
 
                 elif parse_result == ChunkResultType.Start:
                     info_log("Got a start while parsing, resetting payload")
@@ -146,7 +146,7 @@ extern "C" {
  * In snapshot mode, the TzCtrl task is only used for stack monitoring and is
  * not created unless this is enabled.
  */
-#define TRC_CFG_ENABLE_STACK_MONITOR 0
+#define TRC_CFG_ENABLE_STACK_MONITOR 1
 
 /**
  * @def TRC_CFG_STACK_MONITOR_MAX_TASKS
@@ -179,6 +179,36 @@ extern "C" {
  */
 #define TRC_CFG_STACK_MONITOR_MAX_REPORTS 1
 
+/**
+ * @def TRC_CFG_STACK_MONITOR_SCAN_WORDS
+ * @brief Macro which should be defined as an integer value.
+ *
+ * If non-zero, the stack analysis is done incrementally by
+ * xTraceStackMonitorScan(), which checks at most this many stack words per
+ * call and resumes where it left off. Each pass only covers the area below the
+ * previous low water mark of a task, so the cost of a call is bounded
+ * regardless of the stack sizes. xTraceStackMonitorScan() is intended to be
+ * called from the tick hook, and the TzCtrl task then only reports the results.
+ *
+ * If 0, TzCtrl analyzes the full stack of TRC_CFG_STACK_MONITOR_MAX_REPORTS
+ * tasks each time it runs.
+ *
+ * Default value is 0. This demo scans 8 words per tick.
+ */
+#define TRC_CFG_STACK_MONITOR_SCAN_WORDS 8
+
+/**
+ * @def TRC_CFG_STACK_MONITOR_ALERT_THRESHOLD
+ * @brief Macro which should be defined as an integer value.
+ *
+ * When the unused stack (in words) of a monitored task drops below this value,
+ * the callback set by xTraceStackMonitorSetCallback() is called. This happens
+ * once per task, when the threshold is crossed. Set to 0 to disable.
+ *
+ * Default value is 0. This demo alerts below 16 words.
+ */
+#define TRC_CFG_STACK_MONITOR_ALERT_THRESHOLD 16
+
 /**
  * @def TRC_CFG_CTRL_TASK_PRIORITY
  * @brief The scheduling priority of the Tracealyzer Control (TzCtrl) task. 
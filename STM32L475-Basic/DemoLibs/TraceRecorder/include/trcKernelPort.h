@@ -281,6 +281,24 @@ void vTraceSetMessageBufferName(void* pvMessageBuffer, const char* szName);
   */
 traceResult xTraceKernelPortGetUnusedStack(void* pvTask, TraceUnsignedBaseType_t *puxUnusedStack);
 
+ /**
+  * @internal Retrieves the lowest address of the stack area for a task.
+  *
+  * The unused part of a descending stack starts here and is filled with
+  * TRC_KERNEL_PORT_STACK_FILL_WORD, which allows the stack monitor to scan
+  * it incrementally.
+  *
+  * @param[in] pvTask Task pointer
+  * @param[out] ppvStackBase The stack base
+  *
+  * @retval TRC_FAIL Failure, e.g. if the stack grows upwards
+  * @retval TRC_SUCCESS Success
+  */
+traceResult xTraceKernelPortGetStackBase(void* pvTask, void** ppvStackBase);
+
+/* The word pattern FreeRTOS fills unused task stacks with (tskSTACK_FILL_BYTE) */
+#define TRC_KERNEL_PORT_STACK_FILL_WORD 0xA5A5A5A5UL
+
 #endif
 
 #else
@@ -320,6 +338,11 @@ traceResult xTraceKernelPortGetUnusedStack(void* pvTask, TraceUnsignedBaseType_t
  */
 #define xTraceKernelPortGetUnusedStack(pvTask, puxUnusedStack) ((void)(pvTask), (void)(puxUnusedStack))
 
+/**
+ * @brief Disabled by TRC_CFG_SCHEDULING_ONLY
+ */
+#define xTraceKernelPortGetStackBase(pvTask, ppvStackBase) ((void)(pvTask), (void)(ppvStackBase))
+
 #endif
 
 #if (((TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_SNAPSHOT) && (TRC_CFG_INCLUDE_ISR_TRACING == 1)) || (TRC_CFG_RECORDER_MODE == TRC_RECORDER_MODE_STREAMING))
@@ -34,10 +34,22 @@ extern "C" {
 
 #if (((TRC_CFG_ENABLE_STACK_MONITOR) == 1) && ((TRC_CFG_SCHEDULING_ONLY) == 0))
 
+/**
+ * @brief Stack monitor callback, called when the unused stack of a task drops
+ * below TRC_CFG_STACK_MONITOR_ALERT_THRESHOLD.
+ *
+ * @param[in] pvTask Task/Thread.
+ * @param[in] uxLowWaterMark The new low water mark.
+ * @param[in] pvStackBase Lowest address of the task stack, or 0 if unknown.
+ */
+typedef void (*TraceStackMonitorCallback_t)(void* pvTask, TraceUnsignedBaseType_t uxLowWaterMark, void* pvStackBase);
+
 typedef struct TraceStackMonitorEntry	/* Aligned */
 {
 	void *pvTask;
 	TraceUnsignedBaseType_t uxPreviousLowWaterMark;
+	void *pvStackBase;
+	TraceUnsignedBaseType_t uxScanOffset;
 } TraceStackMonitorEntry_t;
 
 typedef struct TraceStackMonitorData	/* Aligned */
@@ -45,6 +57,8 @@ typedef struct TraceStackMonitorData	/* Aligned */
 	TraceStackMonitorEntry_t xEntries[TRC_CFG_STACK_MONITOR_MAX_TASKS];
 
 	TraceUnsignedBaseType_t uxEntryCount;
+	TraceUnsignedBaseType_t uxScanIndex;
+	TraceStackMonitorCallback_t xCallbackFunction;
 } TraceStackMonitorData_t;
 
 /**
@@ -95,13 +109,44 @@ traceResult xTraceStackMonitorGetAtIndex(uint32_t uiIndex, void** ppvTask, Trace
  * 
  * This routine performs a trace stack monitor check and report
  * for TRC_CFG_STACK_MONITOR_MAX_REPORTS number of registered
- * tasks/threads.
+ * tasks/threads. If TRC_CFG_STACK_MONITOR_SCAN_WORDS is non-zero, the
+ * low water marks found by xTraceStackMonitorScan() are reported and
+ * no stacks are scanned here.
  * 
  * @retval TRC_FAIL Failure
  * @retval TRC_SUCCESS Success
  */
 traceResult xTraceStackMonitorReport(void);
 
+/**
+ * @brief Performs one step of the incremental stack scan.
+ * 
+ * Checks at most TRC_CFG_STACK_MONITOR_SCAN_WORDS words of the unused
+ * stack area of the monitored tasks, resuming where the previous call
+ * stopped. Each pass over a task only covers the area below its previous
+ * low water mark, since that area is the only place it can move to.
+ * Intended to be called periodically, e.g. from the tick hook.
+ * 
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStackMonitorScan(void);
+
+/**
+ * @brief Sets the callback invoked when the unused stack of a task drops
+ * below TRC_CFG_STACK_MONITOR_ALERT_THRESHOLD.
+ * 
+ * The callback is called from the context of xTraceStackMonitorScan()
+ * or xTraceStackMonitorReport(), which may be an ISR, and should
+ * therefore defer any lengthy processing.
+ * 
+ * @param[in] xCallback Callback
+ * 
+ * @retval TRC_FAIL Failure
+ * @retval TRC_SUCCESS Success
+ */
+traceResult xTraceStackMonitorSetCallback(TraceStackMonitorCallback_t xCallback);
+
 #else
 
 typedef struct TraceStackMonitorData
@@ -123,6 +168,10 @@ typedef struct TraceStackMonitorData
 
 #define xTraceStackMonitorReport() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
 
+#define xTraceStackMonitorScan() TRC_COMMA_EXPR_TO_STATEMENT_EXPR_1(TRC_SUCCESS)
+
+#define xTraceStackMonitorSetCallback(xCallback) TRC_COMMA_EXPR_TO_STATEMENT_EXPR_2((void)(xCallback), TRC_SUCCESS)
+
 #endif
 
 /** @} */
@@ -138,6 +138,26 @@ traceResult xTraceKernelPortGetUnusedStack(void* pvTask, TraceUnsignedBaseType_t
 	return TRC_SUCCESS;
 }
 
+traceResult xTraceKernelPortGetStackBase(void* pvTask, void** ppvStackBase)
+{
+#if (portSTACK_GROWTH < 0) && (configUSE_TRACE_FACILITY == 1)
+	TaskStatus_t xTaskStatus;
+
+	/* Passing a state avoids the (slower) state lookup, we only need the stack base */
+	vTaskGetInfo((TaskHandle_t)pvTask, &xTaskStatus, pdFALSE, eRunning);
+
+	*ppvStackBase = (void*)xTaskStatus.pxStackBase;
+
+	return TRC_SUCCESS;
+#else
+	(void)pvTask;
+
+	*ppvStackBase = 0;
+
+	return TRC_FAIL;
+#endif
+}
+
 #endif
 
 traceResult xTraceKernelPortDelay(uint32_t uiTicks)
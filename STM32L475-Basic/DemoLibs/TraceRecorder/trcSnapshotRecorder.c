@@ -212,7 +212,7 @@ uint32_t RecorderInitialized TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 /*************** Private Functions *******************************************/
 static void prvStrncpy(char* dst, const char* src, uint32_t maxLength);
 static uint8_t prvTraceGetObjectState(uint8_t objectclass, traceHandle id); 
-static void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint8_t* plength); 
+static void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint32_t* phash, uint8_t* plength); 
 static void* prvTraceNextFreeEventBufferSlot(void); 
 static uint16_t prvTraceGetDTS(uint16_t param_maxDTS);
 static TraceStringHandle_t prvTraceOpenSymbol(const char* name, TraceStringHandle_t userEventChannel);
@@ -226,14 +226,50 @@ static void prvCheckDataToBeOverwrittenForMultiEntryEvents(uint8_t nEntries);
 
 static TraceStringHandle_t prvTraceCreateSymbolTableEntry(const char* name,
 										uint8_t crc6,
+										uint32_t hash,
 										uint8_t len,
 										TraceStringHandle_t channel);
 
 static TraceStringHandle_t prvTraceLookupSymbolTableEntry(const char* name,
 										uint8_t crc6,
+										uint32_t hash,
 										uint8_t len,
 										TraceStringHandle_t channel);
 
+static int prvTraceSymbolTableEntryEquals(uint16_t index,
+										const char* name,
+										uint8_t len,
+										TraceStringHandle_t channel);
+
+/* Size of the symbol lookup index, a power of two scaled with the symbol table.
+ * The index only lives in RAM, the crc6 chains in the symbol table are still
+ * maintained so the trace format is unchanged. */
+#ifndef TRC_CFG_SYMBOL_INDEX_SLOTS
+#if ((TRC_CFG_SYMBOL_TABLE_SIZE) <= 512)
+#define TRC_CFG_SYMBOL_INDEX_SLOTS 64
+#elif ((TRC_CFG_SYMBOL_TABLE_SIZE) <= 1024)
+#define TRC_CFG_SYMBOL_INDEX_SLOTS 128
+#elif ((TRC_CFG_SYMBOL_TABLE_SIZE) <= 2048)
+#define TRC_CFG_SYMBOL_INDEX_SLOTS 256
+#elif ((TRC_CFG_SYMBOL_TABLE_SIZE) <= 4096)
+#define TRC_CFG_SYMBOL_INDEX_SLOTS 512
+#elif ((TRC_CFG_SYMBOL_TABLE_SIZE) <= 8192)
+#define TRC_CFG_SYMBOL_INDEX_SLOTS 1024
+#else
+#define TRC_CFG_SYMBOL_INDEX_SLOTS 4096
+#endif
+#endif
+
+#if (((TRC_CFG_SYMBOL_INDEX_SLOTS) & ((TRC_CFG_SYMBOL_INDEX_SLOTS) - 1)) != 0)
+#error "TRC_CFG_SYMBOL_INDEX_SLOTS must be a power of two!"
+#endif
+
+/* Open addressing on the FNV-1a hash of the symbol, holds symbol table indexes (0 = free) */
+static uint16_t symbolIndex[TRC_CFG_SYMBOL_INDEX_SLOTS];
+
+/* Set if a symbol could not be indexed, lookups then use the crc6 chains */
+static uint8_t symbolIndexFull = 0;
+
 
 #if (TRC_CFG_INCLUDE_ISR_TRACING == 0)
 /* ISR tracing is turned off */
@@ -1699,6 +1735,8 @@ traceResult xTraceInitialize(void)
 	RecorderDataPtr->debugMarker1 = (int32_t)0xF1F1F1F1;
 	RecorderDataPtr->SymbolTable.symTableSize = (TRC_CFG_SYMBOL_TABLE_SIZE);
 	RecorderDataPtr->SymbolTable.nextFreeSymbolIndex = 1;
+	(void)memset(symbolIndex, 0, sizeof(symbolIndex));
+	symbolIndexFull = 0;
 #if (TRC_CFG_INCLUDE_FLOAT_SUPPORT == 1)
 	RecorderDataPtr->exampleFloatEncoding = 1.0f; /* otherwise already zero */
 #endif
@@ -2559,20 +2597,22 @@ TraceStringHandle_t prvTraceOpenSymbol(const char* name, TraceStringHandle_t use
 	uint16_t result;
 	uint8_t len;
 	uint8_t crc;
+	uint32_t hash;
 	TRACE_ALLOC_CRITICAL_SECTION();
 	
 	len = 0;
 	crc = 0;
+	hash = 0;
 	
 	TRACE_ASSERT(name != (void*)0, "prvTraceOpenSymbol: name == NULL", (TraceStringHandle_t)0);
 
-	prvTraceGetChecksum(name, &crc, &len);
+	prvTraceGetChecksum(name, &crc, &hash, &len);
 
 	trcCRITICAL_SECTION_BEGIN();
-	result = prvTraceLookupSymbolTableEntry(name, crc, len, userEventChannel);
+	result = prvTraceLookupSymbolTableEntry(name, crc, hash, len, userEventChannel);
 	if (!result)
 	{
-		result = prvTraceCreateSymbolTableEntry(name, crc, len, userEventChannel);
+		result = prvTraceCreateSymbolTableEntry(name, crc, hash, len, userEventChannel);
 	}
 	trcCRITICAL_SECTION_END();
 
@@ -2846,6 +2886,32 @@ uint16_t prvTraceGetDTS(uint16_t param_maxDTS)
 	return (uint16_t)dts & param_maxDTS;
 }
 
+/*******************************************************************************
+ * prvTraceSymbolTableEntryEquals
+ *
+ * Returns 1 if the symbol table entry at index has the given name and channel.
+ ******************************************************************************/
+int prvTraceSymbolTableEntryEquals(uint16_t index,
+										 const char* name,
+										 uint8_t len,
+										 TraceStringHandle_t chn)
+{
+	if (RecorderDataPtr->SymbolTable.symbytes[index + 2] == (chn & 0x00FF))
+	{
+		if (RecorderDataPtr->SymbolTable.symbytes[index + 3] == (chn / 0x100))
+		{
+			if (RecorderDataPtr->SymbolTable.symbytes[index + 4 + len] == '\0')
+			{
+				if (strncmp((char*)(& RecorderDataPtr->SymbolTable.symbytes[index + 4]), name, len) == 0)
+				{
+					return 1;
+				}
+			}
+		}
+	}
+	return 0;
+}
+
 /*******************************************************************************
  * prvTraceLookupSymbolTableEntry
  *
@@ -2858,31 +2924,44 @@ uint16_t prvTraceGetDTS(uint16_t param_maxDTS)
  * format strings only (the handle of the destination channel).
  * byte 4..(4 + length): the string (object name or user event label), with
  * zero-termination
+ *
+ * The entry is normally found through symbolIndex, using the FNV-1a hash.
+ * The crc6 chains are only followed if the index has overflowed.
  ******************************************************************************/
 TraceStringHandle_t prvTraceLookupSymbolTableEntry(const char* name,
 										 uint8_t crc6,
+										 uint32_t hash,
 										 uint8_t len,
 										 TraceStringHandle_t chn)
 {
-	uint16_t i = RecorderDataPtr->SymbolTable.latestEntryOfChecksum[ crc6 ];
+	uint16_t i;
+	uint32_t slot;
+	uint32_t probes;
 
 	TRACE_ASSERT(name != (void*)0, "prvTraceLookupSymbolTableEntry: name == NULL", (TraceStringHandle_t)0);
 	TRACE_ASSERT(len != 0, "prvTraceLookupSymbolTableEntry: len == 0", (TraceStringHandle_t)0);
 
-	while (i != 0)
+	if (!symbolIndexFull)
 	{
-		if (RecorderDataPtr->SymbolTable.symbytes[i + 2] == (chn & 0x00FF))
+		slot = hash & ((TRC_CFG_SYMBOL_INDEX_SLOTS) - 1);
+		for (probes = 0; probes < (TRC_CFG_SYMBOL_INDEX_SLOTS); probes++)
 		{
-			if (RecorderDataPtr->SymbolTable.symbytes[i + 3] == (chn / 0x100))
+			i = symbolIndex[slot];
+			if (i == 0 || prvTraceSymbolTableEntryEquals(i, name, len, chn))
 			{
-				if (RecorderDataPtr->SymbolTable.symbytes[i + 4 + len] == '\0')
-				{
-					if (strncmp((char*)(& RecorderDataPtr->SymbolTable.symbytes[i + 4]), name, len) == 0)
-					{
-						break; /* found */
-					}
-				}
+				return i;
 			}
+			slot = (slot + 1) & ((TRC_CFG_SYMBOL_INDEX_SLOTS) - 1);
+		}
+		return 0;
+	}
+
+	i = RecorderDataPtr->SymbolTable.latestEntryOfChecksum[ crc6 ];
+	while (i != 0)
+	{
+		if (prvTraceSymbolTableEntryEquals(i, name, len, chn))
+		{
+			break; /* found */
 		}
 		i = (uint16_t)(RecorderDataPtr->SymbolTable.symbytes[i] + (RecorderDataPtr->SymbolTable.symbytes[i + 1] * 0x100));
 	}
@@ -2904,10 +2983,13 @@ TraceStringHandle_t prvTraceLookupSymbolTableEntry(const char* name,
  ******************************************************************************/
 TraceStringHandle_t prvTraceCreateSymbolTableEntry(const char* name,
 										uint8_t crc6,
+										uint32_t hash,
 										uint8_t len,
 										TraceStringHandle_t channel)
 {
 	TraceStringHandle_t ret = 0;
+	uint32_t slot;
+	uint32_t probes;
 
 	TRACE_ASSERT(name != (void*)0, "prvTraceCreateSymbolTableEntry: name == NULL", 0);
 	TRACE_ASSERT(len != 0, "prvTraceCreateSymbolTableEntry: len == 0", 0);
@@ -2951,6 +3033,25 @@ TraceStringHandle_t prvTraceCreateSymbolTableEntry(const char* name,
 		RecorderDataPtr->SymbolTable.nextFreeSymbolIndex += (uint32_t) (len + 5);
 
 		ret = (uint16_t)(RecorderDataPtr->SymbolTable.nextFreeSymbolIndex - (uint8_t)(len + 5));
+
+		if (!symbolIndexFull)
+		{
+			slot = hash & ((TRC_CFG_SYMBOL_INDEX_SLOTS) - 1);
+			for (probes = 0; probes < (TRC_CFG_SYMBOL_INDEX_SLOTS); probes++)
+			{
+				if (symbolIndex[slot] == 0)
+				{
+					symbolIndex[slot] = (uint16_t)ret;
+					break;
+				}
+				slot = (slot + 1) & ((TRC_CFG_SYMBOL_INDEX_SLOTS) - 1);
+			}
+
+			if (probes == (TRC_CFG_SYMBOL_INDEX_SLOTS))
+			{
+				symbolIndexFull = 1;
+			}
+		}
 	}
 
 	return ret;
@@ -2960,17 +3061,20 @@ TraceStringHandle_t prvTraceCreateSymbolTableEntry(const char* name,
 /*******************************************************************************
  * prvTraceGetChecksum
  *
- * Calculates a simple 6-bit checksum from a string, used to index the string
- * for fast symbol table lookup.
+ * Calculates a simple 6-bit checksum from a string, stored in the symbol table
+ * chains, and a 32-bit FNV-1a hash used to index the string for fast symbol
+ * table lookup.
  ******************************************************************************/
-void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint8_t* plength)
+void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint32_t* phash, uint8_t* plength)
 {
 	unsigned char c;
 	int length = 1;		/* Should be 1 to account for '\0' */
 	int crc = 0;
+	uint32_t hash = 2166136261UL;	/* FNV-1a offset basis */
 
 	TRACE_ASSERT(pname != (void*)0, "prvTraceGetChecksum: pname == NULL", TRC_UNUSED);
 	TRACE_ASSERT(pcrc != (void*)0, "prvTraceGetChecksum: pcrc == NULL", TRC_UNUSED);
+	TRACE_ASSERT(phash != (void*)0, "prvTraceGetChecksum: phash == NULL", TRC_UNUSED);
 	TRACE_ASSERT(plength != (void*)0, "prvTraceGetChecksum: plength == NULL", TRC_UNUSED);
 
 	if (pname != (const char *) 0)
@@ -2978,10 +3082,12 @@ void prvTraceGetChecksum(const char *pname, uint8_t* pcrc, uint8_t* plength)
 		for (; (c = (unsigned char) *pname++) != '\0';)
 		{
 			crc += c;
+			hash = (hash ^ c) * 16777619UL;	/* FNV-1a prime */
 			length++;
 		}
 	}
 	*pcrc = (uint8_t)(crc & 0x3F);
+	*phash = hash;
 	*plength = (uint8_t)length;
 }
 
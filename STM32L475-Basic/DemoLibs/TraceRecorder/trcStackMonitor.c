@@ -20,8 +20,36 @@
 #define TRC_CFG_ALLOW_TASK_DELETE 1
 #endif
 
+#ifndef TRC_CFG_STACK_MONITOR_SCAN_WORDS
+#define TRC_CFG_STACK_MONITOR_SCAN_WORDS 0
+#endif
+
+#ifndef TRC_CFG_STACK_MONITOR_ALERT_THRESHOLD
+#define TRC_CFG_STACK_MONITOR_ALERT_THRESHOLD 0
+#endif
+
 static TraceStackMonitorData_t* pxStackMonitor TRC_CFG_RECORDER_DATA_ATTRIBUTE;
 
+/* Returns the entry if its low water mark just dropped below the alert threshold, otherwise 0 */
+static TraceStackMonitorEntry_t* prvTraceStackMonitorUpdate(TraceStackMonitorEntry_t* pxEntry, TraceUnsignedBaseType_t uxLowWaterMark)
+{
+	TraceUnsignedBaseType_t uxPrevious = pxEntry->uxPreviousLowWaterMark;
+
+	if (uxLowWaterMark >= uxPrevious)
+	{
+		return 0;
+	}
+
+	pxEntry->uxPreviousLowWaterMark = uxLowWaterMark;
+
+	if ((uxPrevious >= (TRC_CFG_STACK_MONITOR_ALERT_THRESHOLD)) && (uxLowWaterMark < (TRC_CFG_STACK_MONITOR_ALERT_THRESHOLD)))
+	{
+		return pxEntry;
+	}
+
+	return 0;
+}
+
 traceResult xTraceStackMonitorInitialize(TraceStackMonitorData_t *pxBuffer)
 {
 	uint32_t i;
@@ -32,6 +60,8 @@ traceResult xTraceStackMonitorInitialize(TraceStackMonitorData_t *pxBuffer)
 	pxStackMonitor = pxBuffer;
 
 	pxStackMonitor->uxEntryCount = 0;
+	pxStackMonitor->uxScanIndex = 0;
+	pxStackMonitor->xCallbackFunction = 0;
 
 	for (i = 0; i < (TRC_CFG_STACK_MONITOR_MAX_TASKS); i++)
 	{
@@ -43,9 +73,20 @@ traceResult xTraceStackMonitorInitialize(TraceStackMonitorData_t *pxBuffer)
 	return TRC_SUCCESS;
 }
 
+traceResult xTraceStackMonitorSetCallback(TraceStackMonitorCallback_t xCallback)
+{
+	/* This should never fail */
+	TRC_ASSERT(xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_STACK_MONITOR));
+
+	pxStackMonitor->xCallbackFunction = xCallback;
+
+	return TRC_SUCCESS;
+}
+
 traceResult xTraceStackMonitorAdd(void *pvTask)
 {
 	TraceUnsignedBaseType_t uxLowMark = 0;
+	void *pvStackBase = 0;
 	
 	TRACE_ALLOC_CRITICAL_SECTION();
 	
@@ -71,8 +112,16 @@ traceResult xTraceStackMonitorAdd(void *pvTask)
 
 	if (xTraceKernelPortGetUnusedStack(pvTask, &uxLowMark) == TRC_SUCCESS)
 	{
+		if (xTraceKernelPortGetStackBase(pvTask, &pvStackBase) != TRC_SUCCESS)
+		{
+			/* The incremental scan skips this task until the stack base can be read */
+			pvStackBase = 0;
+		}
+
 		pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount].pvTask = pvTask;
 		pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount].uxPreviousLowWaterMark = uxLowMark;
+		pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount].pvStackBase = pvStackBase;
+		pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount].uxScanOffset = 0;
 
 		pxStackMonitor->uxEntryCount++;
 	}
@@ -106,8 +155,7 @@ traceResult xTraceStackMonitorRemove(void* pvTask)
 			if (pxStackMonitor->uxEntryCount > 1 && i != (pxStackMonitor->uxEntryCount - 1))
 			{
 				/* There are more entries and this is NOT the last entry. Move last entry to this slot. */
-				pxStackMonitor->xEntries[i].pvTask = pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount - 1].pvTask;
-				pxStackMonitor->xEntries[i].uxPreviousLowWaterMark = pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount - 1].uxPreviousLowWaterMark;
+				pxStackMonitor->xEntries[i] = pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount - 1];
 
 				/* Clear old entry that was moved */
 				pxStackMonitor->xEntries[pxStackMonitor->uxEntryCount - 1].pvTask = 0;
@@ -157,9 +205,13 @@ traceResult xTraceStackMonitorReport(void)
 {
 	TraceUnsignedBaseType_t uxLowWaterMark = 0;
 	TraceStackMonitorEntry_t *pxStackMonitorEntry;
+	TraceStackMonitorEntry_t *pxAlertEntry = 0;
 	TraceUnsignedBaseType_t uxToReport;
 	TraceUnsignedBaseType_t i;
+	TraceUnsignedBaseType_t uxAlertLowWaterMark = 0;
 	static uint32_t uiCurrentIndex = 0;
+	void *pvAlertTask = 0;
+	void *pvAlertStackBase = 0;
 
 #if (TRC_CFG_ALLOW_TASK_DELETE == 1)
 	TRACE_ALLOC_CRITICAL_SECTION();
@@ -182,16 +234,24 @@ traceResult xTraceStackMonitorReport(void)
 		
 		pxStackMonitorEntry = &pxStackMonitor->xEntries[uiCurrentIndex];
 
+#if ((TRC_CFG_STACK_MONITOR_SCAN_WORDS) == 0)
 		if (xTraceKernelPortGetUnusedStack(pxStackMonitorEntry->pvTask, &uxLowWaterMark) != TRC_SUCCESS)
 		{
 			uiCurrentIndex++;
 			continue;
 		}
 
-		if (uxLowWaterMark < pxStackMonitorEntry->uxPreviousLowWaterMark)
+		if (prvTraceStackMonitorUpdate(pxStackMonitorEntry, uxLowWaterMark) != 0)
 		{
-			pxStackMonitorEntry->uxPreviousLowWaterMark = uxLowWaterMark;
+			pxAlertEntry = pxStackMonitorEntry;
+			pvAlertTask = pxStackMonitorEntry->pvTask;
+			pvAlertStackBase = pxStackMonitorEntry->pvStackBase;
+			uxAlertLowWaterMark = uxLowWaterMark;
 		}
+#else
+		/* The low water mark is kept up to date by xTraceStackMonitorScan() */
+		(void)uxLowWaterMark;
+#endif
 
 		xTraceEventCreate2(PSF_EVENT_UNUSED_STACK, (TraceUnsignedBaseType_t)pxStackMonitorEntry->pvTask, pxStackMonitorEntry->uxPreviousLowWaterMark);
 
@@ -202,6 +262,100 @@ traceResult xTraceStackMonitorReport(void)
 	TRACE_EXIT_CRITICAL_SECTION();
 #endif
 
+	if ((pxAlertEntry != 0) && (pxStackMonitor->xCallbackFunction != 0))
+	{
+		pxStackMonitor->xCallbackFunction(pvAlertTask, uxAlertLowWaterMark, pvAlertStackBase);
+	}
+
+	return TRC_SUCCESS;
+}
+
+traceResult xTraceStackMonitorScan(void)
+{
+#if ((TRC_CFG_STACK_MONITOR_SCAN_WORDS) > 0)
+	TraceStackMonitorEntry_t *pxEntry;
+	TraceStackMonitorEntry_t *pxAlertEntry = 0;
+	TraceUnsignedBaseType_t uxBudget = (TRC_CFG_STACK_MONITOR_SCAN_WORDS);
+	TraceUnsignedBaseType_t uxVisited = 0;
+	TraceUnsignedBaseType_t uxOffset;
+	TraceUnsignedBaseType_t uxAlertLowWaterMark = 0;
+	const uint32_t *puiStack;
+	void *pvAlertTask = 0;
+	void *pvAlertStackBase = 0;
+
+	TRACE_ALLOC_CRITICAL_SECTION();
+
+	/* May be called from the tick hook before the recorder is initialized */
+	if (xTraceIsComponentInitialized(TRC_RECORDER_COMPONENT_STACK_MONITOR) == 0)
+	{
+		return TRC_FAIL;
+	}
+
+	TRACE_ENTER_CRITICAL_SECTION();
+
+	/* Visit each entry at most once per call, entries with nothing to scan cost no words */
+	while ((uxBudget > 0) && (uxVisited < pxStackMonitor->uxEntryCount))
+	{
+		if (pxStackMonitor->uxScanIndex >= pxStackMonitor->uxEntryCount)
+		{
+			pxStackMonitor->uxScanIndex = 0;
+		}
+
+		pxEntry = &pxStackMonitor->xEntries[pxStackMonitor->uxScanIndex];
+
+		if (pxEntry->pvStackBase == 0)
+		{
+			/* The stack base was not available when the task was added, try again */
+			if (xTraceKernelPortGetStackBase(pxEntry->pvTask, &pxEntry->pvStackBase) != TRC_SUCCESS)
+			{
+				pxEntry->pvStackBase = 0;
+			}
+		}
+
+		puiStack = (const uint32_t*)pxEntry->pvStackBase;
+		uxOffset = pxEntry->uxScanOffset;
+
+		/* The stack can only have grown into the area below the previous low water mark */
+		while ((puiStack != 0) && (uxBudget > 0) && (uxOffset < pxEntry->uxPreviousLowWaterMark))
+		{
+			if (puiStack[uxOffset] != (uint32_t)(TRC_KERNEL_PORT_STACK_FILL_WORD))
+			{
+				break;
+			}
+
+			uxOffset++;
+			uxBudget--;
+		}
+
+		if ((puiStack != 0) && (uxOffset < pxEntry->uxPreviousLowWaterMark) && (uxBudget == 0))
+		{
+			/* Out of budget, resume here on the next call */
+			pxEntry->uxScanOffset = uxOffset;
+			break;
+		}
+
+		/* Pass complete, either at a used word or at the previous low water mark */
+		if ((puiStack != 0) && (prvTraceStackMonitorUpdate(pxEntry, uxOffset) != 0))
+		{
+			pxAlertEntry = pxEntry;
+			pvAlertTask = pxEntry->pvTask;
+			pvAlertStackBase = pxEntry->pvStackBase;
+			uxAlertLowWaterMark = uxOffset;
+		}
+
+		pxEntry->uxScanOffset = 0;
+		pxStackMonitor->uxScanIndex++;
+		uxVisited++;
+	}
+
+	TRACE_EXIT_CRITICAL_SECTION();
+
+	if ((pxAlertEntry != 0) && (pxStackMonitor->xCallbackFunction != 0))
+	{
+		pxStackMonitor->xCallbackFunction(pvAlertTask, uxAlertLowWaterMark, pvAlertStackBase);
+	}
+#endif
+
 	return TRC_SUCCESS;
 }
 #endif /* (((TRC_CFG_ENABLE_STACK_MONITOR) == 1) && ((TRC_CFG_SCHEDULING_ONLY) == 0)) */
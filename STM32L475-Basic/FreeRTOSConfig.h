@@ -49,7 +49,7 @@
 
 #define configUSE_PREEMPTION                         1
 #define configUSE_IDLE_HOOK                          0
-#define configUSE_TICK_HOOK                          0
+#define configUSE_TICK_HOOK                          1
 #define configUSE_TICKLESS_IDLE                      0
 #define configUSE_DAEMON_TASK_STARTUP_HOOK           0
 #define configCPU_CLOCK_HZ                           ( SystemCoreClock )
@@ -65,7 +65,10 @@
 #define configIDLE_SHOULD_YIELD                      1
 #define configUSE_MUTEXES                            1
 #define configQUEUE_REGISTRY_SIZE                    8
-#define configCHECK_FOR_STACK_OVERFLOW               0
+/* Method 1 only compares the saved stack pointer with the stack limit on each
+ * context switch. Early warnings are given by the incremental scan in the
+ * TraceRecorder stack monitor instead of the 16-byte pattern check of method 2. */
+#define configCHECK_FOR_STACK_OVERFLOW               1
 #define configUSE_RECURSIVE_MUTEXES                  1
 #define configUSE_MALLOC_FAILED_HOOK                 1
 #define configUSE_APPLICATION_TASK_TAG               1
@@ -878,6 +878,18 @@
     #error configTASK_NOTIFICATION_ARRAY_ENTRIES must be at least 1
 #endif
 
+#ifndef configUSE_QUEUE_EVENT_MASKS
+    #define configUSE_QUEUE_EVENT_MASKS    0
+#endif
+
+#ifndef configQUEUE_EVENT_MASK_NOTIFICATION_INDEX
+    #define configQUEUE_EVENT_MASK_NOTIFICATION_INDEX    ( configTASK_NOTIFICATION_ARRAY_ENTRIES - 1 )
+#endif
+
+#if ( ( configUSE_QUEUE_EVENT_MASKS == 1 ) && ( configUSE_TASK_NOTIFICATIONS != 1 ) )
+    #error configUSE_QUEUE_EVENT_MASKS requires configUSE_TASK_NOTIFICATIONS
+#endif
+
 #ifndef configUSE_POSIX_ERRNO
     #define configUSE_POSIX_ERRNO    0
 #endif
@@ -1247,6 +1259,11 @@ typedef struct xSTATIC_QUEUE
         void * pvDummy7;
     #endif
 
+    #if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+        void * pvDummy10;
+        uint32_t ulDummy11;
+    #endif
+
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxDummy8;
         uint8_t ucDummy9;
@@ -1695,6 +1695,97 @@ QueueSetMemberHandle_t xQueueSelectFromSet( QueueSetHandle_t xQueueSet,
  */
 QueueSetMemberHandle_t xQueueSelectFromSetFromISR( QueueSetHandle_t xQueueSet ) PRIVILEGED_FUNCTION;
 
+/*
+ * Event masks allow a task to block on multiple queues or semaphores without
+ * the second queue operation of a queue set.  configUSE_QUEUE_EVENT_MASKS must
+ * be set to 1 in FreeRTOSConfig.h for these functions to be available.
+ *
+ * Each member queue or semaphore is given one or more bits.  When an item is
+ * posted to a member, its bits are set in the notification value at index
+ * configQUEUE_EVENT_MASK_NOTIFICATION_INDEX of the waiting task, which is
+ * unblocked if it is waiting in ulQueueWaitEventMask().  Only the send to the
+ * member is traced.
+ *
+ * Note 1:  The notification index used for the event mask cannot be used for
+ * other direct to task notifications.  It defaults to the last index, so set
+ * configTASK_NOTIFICATION_ARRAY_ENTRIES to 2 or more if the task also uses
+ * xTaskNotify()/xTaskNotifyWait().
+ *
+ * Note 2:  A queue or semaphore can be a member of one event mask, and cannot
+ * be a member of both an event mask and a queue set.  Remove the members
+ * before deleting the task.
+ *
+ * Note 3:  The bit of a member is set once per posted item, but cleared when
+ * ulQueueWaitEventMask() returns.  The task should therefore read all items
+ * from a member with a block time of 0 when its bit is set.
+ *
+ * Example usage:
+ * @code{c}
+ * xQueueAddToEventMask( xQueue1, xTaskGetCurrentTaskHandle(), 0x01 );
+ * xQueueAddToEventMask( xQueue2, xTaskGetCurrentTaskHandle(), 0x02 );
+ *
+ * for( ;; )
+ * {
+ *     uint32_t ulEvents = ulQueueWaitEventMask( portMAX_DELAY );
+ *
+ *     if( ( ulEvents & 0x01 ) != 0 )
+ *     {
+ *         while( xQueueReceive( xQueue1, &xMessage, 0 ) == pdPASS )
+ *         {
+ *             // Process xMessage.
+ *         }
+ *     }
+ *
+ *     if( ( ulEvents & 0x02 ) != 0 )
+ *     {
+ *         while( xQueueReceive( xQueue2, &xMessage, 0 ) == pdPASS )
+ *         {
+ *             // Process xMessage.
+ *         }
+ *     }
+ * }
+ * @endcode
+ */
+
+/*
+ * Adds a queue or semaphore to the event mask of a task.
+ *
+ * @param xQueueOrSemaphore The handle of the queue or semaphore being added
+ * (cast to an QueueSetMemberHandle_t type).
+ *
+ * @param xTaskToNotify The task that will wait for the queue or semaphore.
+ *
+ * @param ulEventBits The bits set in the event mask of xTaskToNotify when an
+ * item is posted to the queue or semaphore.  Must not be 0.
+ *
+ * @return pdPASS if the queue or semaphore was added, or pdFAIL if it already
+ * is a member of an event mask or a queue set.  If the queue or semaphore is
+ * not empty, the bits are set immediately.
+ */
+BaseType_t xQueueAddToEventMask( QueueSetMemberHandle_t xQueueOrSemaphore,
+                                 TaskHandle_t xTaskToNotify,
+                                 uint32_t ulEventBits ) PRIVILEGED_FUNCTION;
+
+/*
+ * Removes a queue or semaphore from the event mask it was added to.
+ *
+ * @return pdPASS if the queue or semaphore was removed, or pdFAIL if it was
+ * not a member of an event mask.
+ */
+BaseType_t xQueueRemoveFromEventMask( QueueSetMemberHandle_t xQueueOrSemaphore ) PRIVILEGED_FUNCTION;
+
+/*
+ * Waits until items are posted to one or more of the queues or semaphores in
+ * the event mask of the calling task.
+ *
+ * @param xTicksToWait The maximum time, in ticks, that the calling task will
+ * remain in the Blocked state to wait for an item.
+ *
+ * @return The bits of the members that items were posted to since the last
+ * call, or 0 if the block time expired.  The returned bits are cleared.
+ */
+uint32_t ulQueueWaitEventMask( TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
 /* Not public API functions. */
 void vQueueWaitForMessageRestricted( QueueHandle_t xQueue,
                                      TickType_t xTicksToWait,
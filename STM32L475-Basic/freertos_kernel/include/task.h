@@ -2965,6 +2965,23 @@ TaskHandle_t xTaskGetCurrentTaskHandle( void ) PRIVILEGED_FUNCTION;
  */
 void vTaskMissedYield( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * THIS FUNCTION MUST NOT BE USED FROM APPLICATION CODE.  IT IS USED BY THE
+ * QUEUE IMPLEMENTATION WHEN configUSE_QUEUE_EVENT_MASKS IS 1.
+ *
+ * Sets ulEventBits in the notification value at index
+ * configQUEUE_EVENT_MASK_NOTIFICATION_INDEX of xTaskToNotify and unblocks the
+ * task if it was waiting in ulQueueWaitEventMask().  Unlike xTaskNotify() no
+ * trace event is generated, the queue operation that caused the notification
+ * is already traced.  Must be called from a critical section or with
+ * interrupts masked.
+ *
+ * @return pdTRUE if the unblocked task has a priority higher than the calling
+ * task, otherwise pdFALSE.
+ */
+BaseType_t xTaskNotifyQueueEventMask( TaskHandle_t xTaskToNotify,
+                                      uint32_t ulEventBits ) PRIVILEGED_FUNCTION;
+
 /*
  * Returns the scheduler state as taskSCHEDULER_RUNNING,
  * taskSCHEDULER_NOT_STARTED or taskSCHEDULER_SUSPENDED.
@@ -124,6 +124,11 @@ typedef struct QueueDefinition /* The old naming convention is used to prevent b
         struct QueueDefinition * pxQueueSetContainer;
     #endif
 
+    #if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+        TaskHandle_t xEventMaskTask; /*< The task notified when an item is posted to the queue, NULL if the queue is not in an event mask. */
+        uint32_t ulEventMaskBits;    /*< The bits set in the notification value of xEventMaskTask. */
+    #endif
+
     #if ( configUSE_TRACE_FACILITY == 1 )
         UBaseType_t uxQueueNumber;
         uint8_t ucQueueType;
@@ -210,6 +215,16 @@ static void prvCopyDataFromQueue( Queue_t * const pxQueue,
     static BaseType_t prvNotifyQueueSetContainer( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
 #endif
 
+#if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+
+/*
+ * Checks to see if a queue is a member of an event mask, and if so, sets the
+ * bit of the queue in the notification value of the waiting task.  Returns
+ * pdTRUE if the task was unblocked and has a higher priority.
+ */
+    static BaseType_t prvNotifyQueueEventMask( const Queue_t * const pxQueue ) PRIVILEGED_FUNCTION;
+#endif
+
 /*
  * Called after a Queue_t structure has been allocated either statically or
  * dynamically to fill in the structure's members.
@@ -483,6 +498,13 @@ static void prvInitialiseNewQueue( const UBaseType_t uxQueueLength,
         }
     #endif /* configUSE_QUEUE_SETS */
 
+    #if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+        {
+            pxNewQueue->xEventMaskTask = NULL;
+            pxNewQueue->ulEventMaskBits = 0;
+        }
+    #endif /* configUSE_QUEUE_EVENT_MASKS */
+
     traceQUEUE_CREATE( pxNewQueue );
 }
 /*-----------------------------------------------------------*/
@@ -897,6 +919,21 @@ BaseType_t xQueueGenericSend( QueueHandle_t xQueue,
                     }
                 #endif /* configUSE_QUEUE_SETS */
 
+                #if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+                    {
+                        if( prvNotifyQueueEventMask( pxQueue ) != pdFALSE )
+                        {
+                            /* The queue is a member of an event mask and the
+                             * waiting task has a higher priority. */
+                            queueYIELD_IF_USING_PREEMPTION();
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                #endif /* configUSE_QUEUE_EVENT_MASKS */
+
                 taskEXIT_CRITICAL();
                 return pdPASS;
             }
@@ -1030,6 +1067,28 @@ BaseType_t xQueueGenericSendFromISR( QueueHandle_t xQueue,
              *  the scheduler is suspended before accessing the ready lists. */
             ( void ) prvCopyDataToQueue( pxQueue, pvItemToQueue, xCopyPosition );
 
+            #if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+                {
+                    /* The notification does not use the event lists, so it is
+                     * not deferred when the queue is locked. */
+                    if( prvNotifyQueueEventMask( pxQueue ) != pdFALSE )
+                    {
+                        if( pxHigherPriorityTaskWoken != NULL )
+                        {
+                            *pxHigherPriorityTaskWoken = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            #endif /* configUSE_QUEUE_EVENT_MASKS */
+
             /* The event list is not altered if the queue is locked.  This will
              * be done when the queue is unlocked later. */
             if( cTxLock == queueUNLOCKED )
@@ -1208,6 +1267,28 @@ BaseType_t xQueueGiveFromISR( QueueHandle_t xQueue,
              * messages (semaphores) available. */
             pxQueue->uxMessagesWaiting = uxMessagesWaiting + ( UBaseType_t ) 1;
 
+            #if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+                {
+                    /* The notification does not use the event lists, so it is
+                     * not deferred when the queue is locked. */
+                    if( prvNotifyQueueEventMask( pxQueue ) != pdFALSE )
+                    {
+                        if( pxHigherPriorityTaskWoken != NULL )
+                        {
+                            *pxHigherPriorityTaskWoken = pdTRUE;
+                        }
+                        else
+                        {
+                            mtCOVERAGE_TEST_MARKER();
+                        }
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+            #endif /* configUSE_QUEUE_EVENT_MASKS */
+
             /* The event list is not altered if the queue is locked.  This will
              * be done when the queue is unlocked later. */
             if( cTxLock == queueUNLOCKED )
@@ -2880,6 +2961,15 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
                  * items in the queue/semaphore. */
                 xReturn = pdFAIL;
             }
+
+            #if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+                else if( ( ( Queue_t * ) xQueueOrSemaphore )->xEventMaskTask != NULL )
+                {
+                    /* Cannot add a queue/semaphore to both a queue set and an
+                     * event mask. */
+                    xReturn = pdFAIL;
+                }
+            #endif /* configUSE_QUEUE_EVENT_MASKS */
             else
             {
                 ( ( Queue_t * ) xQueueOrSemaphore )->pxQueueSetContainer = xQueueSet;
@@ -3014,3 +3104,138 @@ BaseType_t xQueueIsQueueFullFromISR( const QueueHandle_t xQueue )
     }
 
 #endif /* configUSE_QUEUE_SETS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+
+    BaseType_t xQueueAddToEventMask( QueueSetMemberHandle_t xQueueOrSemaphore,
+                                     TaskHandle_t xTaskToNotify,
+                                     uint32_t ulEventBits )
+    {
+        BaseType_t xReturn;
+        Queue_t * const pxQueueOrSemaphore = ( Queue_t * ) xQueueOrSemaphore;
+
+        configASSERT( pxQueueOrSemaphore );
+        configASSERT( xTaskToNotify );
+        configASSERT( ulEventBits != 0UL );
+
+        taskENTER_CRITICAL();
+        {
+            if( pxQueueOrSemaphore->xEventMaskTask != NULL )
+            {
+                /* Cannot add a queue/semaphore to more than one event mask. */
+                xReturn = pdFAIL;
+            }
+
+            #if ( configUSE_QUEUE_SETS == 1 )
+                else if( pxQueueOrSemaphore->pxQueueSetContainer != NULL )
+                {
+                    /* Cannot add a queue/semaphore to both a queue set and an
+                     * event mask. */
+                    xReturn = pdFAIL;
+                }
+            #endif /* configUSE_QUEUE_SETS */
+
+            else
+            {
+                pxQueueOrSemaphore->xEventMaskTask = xTaskToNotify;
+                pxQueueOrSemaphore->ulEventMaskBits = ulEventBits;
+
+                /* Unlike queue sets, items already in the queue are not lost,
+                 * the task is notified so it will read them. */
+                if( pxQueueOrSemaphore->uxMessagesWaiting != ( UBaseType_t ) 0 )
+                {
+                    if( prvNotifyQueueEventMask( pxQueueOrSemaphore ) != pdFALSE )
+                    {
+                        queueYIELD_IF_USING_PREEMPTION();
+                    }
+                    else
+                    {
+                        mtCOVERAGE_TEST_MARKER();
+                    }
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                xReturn = pdPASS;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_EVENT_MASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+
+    BaseType_t xQueueRemoveFromEventMask( QueueSetMemberHandle_t xQueueOrSemaphore )
+    {
+        BaseType_t xReturn;
+        Queue_t * const pxQueueOrSemaphore = ( Queue_t * ) xQueueOrSemaphore;
+
+        configASSERT( pxQueueOrSemaphore );
+
+        taskENTER_CRITICAL();
+        {
+            if( pxQueueOrSemaphore->xEventMaskTask == NULL )
+            {
+                /* The queue was not a member of an event mask. */
+                xReturn = pdFAIL;
+            }
+            else
+            {
+                pxQueueOrSemaphore->xEventMaskTask = NULL;
+                pxQueueOrSemaphore->ulEventMaskBits = 0;
+                xReturn = pdPASS;
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_EVENT_MASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+
+    uint32_t ulQueueWaitEventMask( TickType_t xTicksToWait )
+    {
+        uint32_t ulEventBits = 0;
+
+        /* All bits are cleared on exit, a bit that is set again while the
+         * task reads the queues causes another return with that bit set. */
+        ( void ) xTaskNotifyWaitIndexed( configQUEUE_EVENT_MASK_NOTIFICATION_INDEX, 0UL, 0xFFFFFFFFUL, &ulEventBits, xTicksToWait );
+
+        return ulEventBits;
+    }
+
+#endif /* configUSE_QUEUE_EVENT_MASKS */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+
+    static BaseType_t prvNotifyQueueEventMask( const Queue_t * const pxQueue )
+    {
+        BaseType_t xReturn = pdFALSE;
+
+        /* This function must be called from a critical section. */
+
+        if( pxQueue->xEventMaskTask != NULL )
+        {
+            /* No trace event, the send to the queue is already traced. */
+            xReturn = xTaskNotifyQueueEventMask( pxQueue->xEventMaskTask, pxQueue->ulEventMaskBits );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_EVENT_MASKS */
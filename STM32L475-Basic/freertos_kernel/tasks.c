@@ -3370,6 +3370,73 @@ void vTaskMissedYield( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_QUEUE_EVENT_MASKS == 1 )
+
+    BaseType_t xTaskNotifyQueueEventMask( TaskHandle_t xTaskToNotify,
+                                          uint32_t ulEventBits )
+    {
+        TCB_t * const pxTCB = xTaskToNotify;
+        uint8_t ucOriginalNotifyState;
+        BaseType_t xReturn = pdFALSE;
+
+        /* This function must be called from a critical section. */
+
+        configASSERT( pxTCB );
+
+        ucOriginalNotifyState = pxTCB->ucNotifyState[ configQUEUE_EVENT_MASK_NOTIFICATION_INDEX ];
+        pxTCB->ucNotifyState[ configQUEUE_EVENT_MASK_NOTIFICATION_INDEX ] = taskNOTIFICATION_RECEIVED;
+        pxTCB->ulNotifiedValue[ configQUEUE_EVENT_MASK_NOTIFICATION_INDEX ] |= ulEventBits;
+
+        /* If the task is in the blocked state specifically to wait for a
+         * notification then unblock it now. */
+        if( ucOriginalNotifyState == taskWAITING_NOTIFICATION )
+        {
+            /* The task should not have been on an event list. */
+            configASSERT( listLIST_ITEM_CONTAINER( &( pxTCB->xEventListItem ) ) == NULL );
+
+            if( uxSchedulerSuspended == ( UBaseType_t ) pdFALSE )
+            {
+                ( void ) uxListRemove( &( pxTCB->xStateListItem ) );
+                prvAddTaskToReadyList( pxTCB );
+
+                #if ( configUSE_TICKLESS_IDLE != 0 )
+                    {
+                        /* See the comment in xTaskGenericNotify(), the task may
+                         * have been the one that set xNextTaskUnblockTime. */
+                        prvResetNextTaskUnblockTime();
+                    }
+                #endif
+            }
+            else
+            {
+                /* The delayed and ready lists cannot be accessed, so hold
+                 * this task pending until the scheduler is resumed. */
+                vListInsertEnd( &( xPendingReadyList ), &( pxTCB->xEventListItem ) );
+            }
+
+            if( pxTCB->uxPriority > pxCurrentTCB->uxPriority )
+            {
+                /* Mark that a yield is pending in case the caller cannot
+                 * yield, e.g. when called from an ISR. */
+                xYieldPending = pdTRUE;
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_QUEUE_EVENT_MASKS */
+/*-----------------------------------------------------------*/
+
 #if ( configUSE_TRACE_FACILITY == 1 )
 
     UBaseType_t uxTaskGetTaskNumber( TaskHandle_t xTask )
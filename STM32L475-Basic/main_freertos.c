@@ -3,6 +3,7 @@
 #include "main.h"
 #include "stdint.h"
 #include "stdarg.h"
+#include "string.h"
 
 #include "iot_uart.h"
 
@@ -22,9 +23,24 @@
 static void prvInitializeHeap( void );
 static void DemoAlertTask(void* argument);
 static void DemoTaskFreeRTOS(void* argument);
+static void prvOnStackLow(void* pvTask, TraceUnsignedBaseType_t uxLowWaterMark, void* pvStackBase);
+static void prvStackAlert(void);
 
 TaskHandle_t DemoAlertTaskHandle = NULL;
 
+/* Notification bits for DemoAlertTask */
+#define DEMO_NOTIFY_BUTTON       (1UL << 0)
+#define DEMO_NOTIFY_STACK_LOW    (1UL << 1)
+
+/* Bytes captured from the deepest used part of the stack */
+#define DEMO_STACK_DUMP_SIZE     128
+
+/* Captured by prvOnStackLow (may run in the tick ISR), reported by DemoAlertTask */
+static char cStackLowTaskName[configMAX_TASK_NAME_LEN];
+static uint32_t ulStackLowWaterMark;
+static uint8_t ucStackDump[DEMO_STACK_DUMP_SIZE];
+static char cStackAlertMessage[DFM_CFG_DESCRIPTION_MAX_LEN];
+
 // Called on every "tick"
 void DemoUpdate(int counter)
 {
@@ -50,6 +66,9 @@ void DemoInit(void)
 	{
 		configPRINT_STRING(("Failed creating ButtonTask."));
 	}
+
+	/* Alert when a task gets close to overflowing its stack */
+	xTraceStackMonitorSetCallback(prvOnStackLow);
 }
 
 
@@ -70,13 +89,82 @@ int main_freertos( void )
 
 void DemoAlertTask(void* argument)
 {
+	uint32_t ulNotifiedValue = 0;
+
 	for(;;)
     {
-    	ulTaskNotifyTake( pdTRUE, portMAX_DELAY );  /* Block indefinitely. */
-    	DemoAlert();
+    	xTaskNotifyWait( 0, 0xFFFFFFFFUL, &ulNotifiedValue, portMAX_DELAY );  /* Block indefinitely. */
+
+    	if ((ulNotifiedValue & DEMO_NOTIFY_STACK_LOW) != 0)
+    	{
+    		prvStackAlert();
+    	}
+
+    	if ((ulNotifiedValue & DEMO_NOTIFY_BUTTON) != 0)
+    	{
+    		DemoAlert();
+    	}
     }
 }
 
+/* Called by the TraceRecorder stack monitor when the unused stack of a task
+ * drops below TRC_CFG_STACK_MONITOR_ALERT_THRESHOLD. Only captures the data,
+ * the alert is created by DemoAlertTask. */
+static void prvOnStackLow(void* pvTask, TraceUnsignedBaseType_t uxLowWaterMark, void* pvStackBase)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	strncpy(cStackLowTaskName, pcTaskGetName((TaskHandle_t)pvTask), sizeof(cStackLowTaskName) - 1);
+	ulStackLowWaterMark = (uint32_t)uxLowWaterMark;
+
+	if (pvStackBase != NULL)
+	{
+		/* The deepest frames, starting right above the unused part of the stack */
+		memcpy(ucStackDump, (uint8_t*)pvStackBase + uxLowWaterMark * sizeof(StackType_t), sizeof(ucStackDump));
+	}
+
+	/* Called from xTraceStackMonitorScan() in the tick hook, or from xTraceStackMonitorReport() in TzCtrl */
+	if (xPortIsInsideInterrupt() == pdTRUE)
+	{
+		xTaskNotifyFromISR( DemoAlertTaskHandle, DEMO_NOTIFY_STACK_LOW, eSetBits, &xHigherPriorityTaskWoken );
+		portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+	}
+	else
+	{
+		xTaskNotify( DemoAlertTaskHandle, DEMO_NOTIFY_STACK_LOW, eSetBits );
+	}
+}
+
+static void prvStackAlert(void)
+{
+	DfmAlertHandle_t xAlertHandle;
+	void* pvBuffer = (void*)0;
+	uint32_t ulBufferSize = 0;
+
+	snprintf(cStackAlertMessage, sizeof(cStackAlertMessage), "Low stack in %s, %u words unused", cStackLowTaskName, (unsigned int)ulStackLowWaterMark);
+	configPRINTF(("%s\n", cStackAlertMessage));
+
+	if (xDfmAlertBegin(DFM_TYPE_STACK_OVERFLOW, cStackAlertMessage, &xAlertHandle) == DFM_SUCCESS)
+	{
+		xDfmAlertAddSymptom(xAlertHandle, DFM_SYMPTOM_HIGH_WATERMARK, ulStackLowWaterMark);
+
+		xDfmAlertAddPayload(xAlertHandle, ucStackDump, sizeof(ucStackDump), "stack_dump.bin");
+
+		/* xDfmAlertAddPayload only stores the pointer, so no new events may be written before xDfmAlertEnd */
+		xTracePause();
+
+		xTraceGetEventBuffer(&pvBuffer, &ulBufferSize);
+		xDfmAlertAddPayload(xAlertHandle, pvBuffer, ulBufferSize, "dfm_trace.psfs");
+
+		if (xDfmAlertEnd(xAlertHandle) != DFM_SUCCESS)
+		{
+			configPRINT_STRING("DFM: xDfmAlertEnd failed.\n");
+		}
+
+		xTraceResume();
+	}
+}
+
 void DemoTaskFreeRTOS(void* argument)
 {
     for(;;)
@@ -112,7 +200,7 @@ void vApplicationStackOverflowHook( TaskHandle_t xTask,
 	configPRINT_STRING( ( "ERROR: stack overflow\r\n" ) );
 
 	/* Create an Alert and restart here... */
-	// DFM_TRAP(DFM_TYPE_STACK_OVERFLOW, "Stack overflow");
+	DFM_TRAP(DFM_TYPE_STACK_OVERFLOW, "Stack overflow");
 
 	/* Unused Parameters */
 	( void ) xTask;
@@ -180,6 +268,12 @@ void vApplicationGetTimerTaskMemory( StaticTask_t ** ppxTimerTaskTCBBuffer,
 void DemoOnButtonPressedFreeRTOS(void)
 {
 	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
-    vTaskNotifyGiveFromISR( DemoAlertTaskHandle, &xHigherPriorityTaskWoken );
+    xTaskNotifyFromISR( DemoAlertTaskHandle, DEMO_NOTIFY_BUTTON, eSetBits, &xHigherPriorityTaskWoken );
+}
+
+/* Runs the incremental stack scan, a few words per tick */
+void vApplicationTickHook( void )
+{
+	xTraceStackMonitorScan();
 }
 